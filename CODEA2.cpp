@@ -1,17 +1,36 @@
 // C++ classes
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <sstream>
 #include <string>
 #include <vector>
+#include <cassert>
 #include <cstdlib>
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
 // Core classes
+#include "./core/asynchronousArchitecture.h"
 #include "./core/coDecentralizedArchitecture.h"
 #include "./core/agent.h"
+#include "./core/checkpoint.h"
 #include "./core/multiObjectiveSolution.h"
 #include "./core/multiObjectiveProblem.h"
 #include "./core/singleObjectiveProblem.h"
 #include "./core/systemGeneralStopCriterion.h"
+#include "./core/evaluationCache.h"
+#include "./core/islandMigration.h"
+#include "./core/paretoArchive.h"
+#include "./core/paretoIndicators.h"
+#include "./core/indicatorStopCriterion.h"
+#include "./core/threadPool.h"
+#include "./core/improvementStream.h"
+#include "./core/solverService.h"
 
 // Code parameters
 #include "./core/codeaParameters.h"
@@ -27,6 +46,8 @@
 #include "./problems/VRPTW/objectives/waitingTimeProblem.h"
 // Experimental
 #include "./problems/VRPTW/objectives/timeWindowsDistribution.h"
+// Objectives fixed at compile time (-DSTATIC_OBJECTIVES)
+#include "./problems/VRPTW/VRPTWStaticProblem.h"
 
 
 // Multi-objective Score Criterion
@@ -41,6 +62,8 @@
 #include "./problems/VRPTW/dataTypes.h"
 #include "./problems/VRPTW/VRPTWDataProblem.h"
 #include "./problems/VRPTW/VRPSolution.h"
+#include "./problems/VRPTW/VRPConstruction.h"
+#include "./problems/VRPTW/VRPDynamicArrivals.h"
 
 // Libs
 #include "./libs/conversions.h"
@@ -52,14 +75,14 @@
 // Phases
 #include "./agents/JFO/JFOphases/JFOCommunicationPhase.h"
 #include "./agents/JFO/JFOphases/JFOResolutorPhase.h"
+#include "./agents/JFO/JFOphases/JFORouteEliminationPhase.h"
+#include "./agents/JFO/JFOphases/JFOLNSPhase.h"
 
 
 using namespace std;
 
-void readCordeauDataFile(const char* fileName)
+void readCordeauData(std::istream& file)
 {
-   std::fstream file;
-   file.open(fileName);
    std::string line;
    unsigned numberOfLine = 1;
    std::vector<string> splittedLine;
@@ -74,6 +97,14 @@ void readCordeauDataFile(const char* fileName)
      splittedLine.clear();
      splitString(line, splittedLine);
 
+     // Blank lines and costumers with missing columns are skipped
+     if (splittedLine.size() < 2 || (numberOfLine >= 3 && splittedLine.size() < ((numberOfLine == 3) ? 9u : 10u)))
+     {
+        if (!splittedLine.empty())
+           numberOfLine++;
+        continue;
+     }
+
      if (numberOfLine == 1)
         sizeOfFleet = fromStringTo<unsigned>(splittedLine[1]);
 
@@ -121,6 +152,13 @@ void readCordeauDataFile(const char* fileName)
    // exit(0);
 }
 
+void readCordeauDataFile(const char* fileName)
+{
+   std::fstream file;
+   file.open(fileName);
+   readCordeauData(file);
+}
+
 void readSolomonDataFile(const char* fileName)
 {
    std::fstream file;
@@ -163,33 +201,178 @@ void readSolomonDataFile(const char* fileName)
    }
 }
 
-int main( int argc, char **argv )
+/**
+   Reads the optional arguments given after the positional ones. They have
+   the form name=value (e.g. construction=sweep).
+*/
+map<string, string> readOptions(const vector<string>& arguments, size_t first)
 {
-   //cout << "CODEA - MOJFO 4 VRPTW" << endl;
-   //cout << "---------------------" << endl;
+   map<string, string> options;
+   for (size_t i = first; i < arguments.size(); i++)
+   {
+      const string& argument = arguments[i];
+      size_t equal = argument.find('=');
+      if (equal == string::npos || equal == 0)
+      {
+         cout << "ERROR[!] Options must be given as name=value: " << argument << endl;
+         exit(1);
+      }
+      options[argument.substr(0, equal)] = argument.substr(equal + 1);
+   }
+   return options;
+}
 
-   if (argc < 5)
+map<string, string> readOptions(int argc, char **argv, int first)
+{
+   return readOptions(vector<string>(argv, argv + argc), first);
+}
+
+/**
+   Returns the value of an option or the default value if it was not given.
+*/
+string getOption(const map<string, string>& options, const string& name, const string& defaultValue)
+{
+   map<string, string>::const_iterator option = options.find(name);
+   return (option == options.end()) ? defaultValue : option->second;
+}
+
+/**
+   Writes the objectives and the routes of a route-plan in a line (see improvementStream).
+*/
+string describeRoutePlan(const multiObjectiveSolution* solution)
+{
+   const VRPSolution* VRPSol = static_cast<const VRPSolution*>(solution);
+   string line = VRPSol->toString() + "|";
+   for (size_t i = 0; i < VRPSol->getRoutes().size(); i++)
+      line += " " + somethingToString(VRPSol->getRoutes()[i]);
+   return line;
+}
+
+/**
+   Reads a square matrix with a row per costumer (the depot is 0), e.g. the distances
+   or travel times given by a road-network router. Files ending in .bin hold the
+   n x n doubles by rows as they are in memory; other files hold them as text,
+   optionally preceded by n.
+*/
+bool readMatrixFile(const string& fileName, const size_t n, vector<double>& values, string& error)
+{
+   ifstream file(fileName.c_str(), ios::in | ios::binary);
+   if (!file)
    {
-      cout << "ERROR[!]" << endl;
-      cout << "You must provide:" << endl;
-      cout << "  - a filename with the data of the problem." << endl;
-      cout << "  - the number of vehicles you want to work with." << endl;
-      cout << "  - the number of agents within the swarm." << endl;
-      cout << "  - the number of evolutions. " << endl;
-      cout << "  - the ranking type: 0 Pareto, 1 Lexicographic, 2 Dynamic lexicographic. " << endl;
-      cout << "  - seed." << endl;
-      cout << "Example ./CODEA2 data.txt 10 50 5000 0 200" << endl;
-      exit(1);
+      error = "cannot read the matrix " + fileName;
+      return false;
    }
-   //cout << "Starting up..." << endl;
 
-   // Variables
-   char* fileName = argv[1];
-   unsigned numberOfVehicles = atoi(argv[2]);
-   unsigned numberOfAgents = atoi(argv[3]);
-   unsigned numberOfEvolutions = atoi(argv[4]);
-   unsigned rankingType = atoi(argv[5]);
-   unsigned seed = atoi(argv[6]);
+   values.clear();
+   if (fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".bin") == 0)
+   {
+      values.resize(n * n);
+      if (n > 0)
+         file.read(reinterpret_cast<char*>(&values[0]), n * n * sizeof(double));
+      if (!file || file.peek() != EOF)
+      {
+         error = "the matrix " + fileName + " does not have " + somethingToString(n * n) + " doubles";
+         return false;
+      }
+      return true;
+   }
+
+   double value;
+   while (file >> value)
+      values.push_back(value);
+   if (!file.eof())
+   {
+      error = "the matrix " + fileName + " has a value that is not a number";
+      return false;
+   }
+   if (values.size() == n * n + 1 && values[0] == n)
+      values.erase(values.begin());
+   if (values.size() != n * n)
+   {
+      error = "the matrix " + fileName + " does not have " + somethingToString(n) + " rows of " + somethingToString(n) + " values";
+      return false;
+   }
+   return true;
+}
+
+/**
+   Makes the precomputations of the instance read into VRPTWDataProblem. The distances
+   and travel times may be given by files instead of calculated from the positions,
+   and the latter may be kept in a matrix or computed when they are needed.
+*/
+bool prepareInstance(const map<string, string>& options, string& error)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   const size_t n = VRPTWData->getClientCoords().size();
+   vector<double> values;
+
+   const string mode = getOption(options, "distancematrix", "auto");
+   if (mode == "auto")
+      VRPTWData->setDistanceMode(VRPTWDataProblem::automaticDistances);
+   else if (mode == "dense")
+      VRPTWData->setDistanceMode(VRPTWDataProblem::denseDistances);
+   else if (mode == "ondemand")
+      VRPTWData->setDistanceMode(VRPTWDataProblem::onDemandDistances);
+   else
+   {
+      error = "unknown distance matrix mode " + mode;
+      return false;
+   }
+   if (mode == "ondemand" && (!getOption(options, "distances", "").empty() || !getOption(options, "times", "").empty()))
+   {
+      error = "distances cannot be computed on demand when distances or travel times are given";
+      return false;
+   }
+
+   const string distances = getOption(options, "distances", "");
+   if (!distances.empty())
+   {
+      if (!readMatrixFile(distances, n, values, error))
+         return false;
+      distanceMatrixType distanceMatrix(n);
+      for (size_t i = 0; i < n; i++)
+         distanceMatrix[i].assign(values.begin() + i * n, values.begin() + (i + 1) * n);
+      VRPTWData->setDistanceMatrix(distanceMatrix);
+   }
+
+   const string times = getOption(options, "times", "");
+   if (!times.empty())
+   {
+      if (!readMatrixFile(times, n, values, error))
+         return false;
+      VRPTWData->setTimeMatrix(values);
+   }
+
+   VRPTWData->setCostScale(atoi(getOption(options, "scale", "0").c_str()));
+   VRPTWData->calculateDistanceMatrix();
+
+   // @Experimental: This is a new approach to add a new objective that takcles the tw violations in a different way
+   //VRPTWData->createZones(numberOfVehicles);
+   return true;
+}
+
+/**
+   Solves the instance in VRPTWDataProblem. If a stream is given, the best route-plan
+   is written into it every time it improves (see improvementStream): to the clients
+   of the daemon or to the file of the improvements option.
+*/
+int solve(unsigned numberOfVehicles, unsigned numberOfAgents, unsigned rankingType, unsigned seed,
+          const map<string, string>& options, ostream* improvements)
+{
+   // The time budget counts from here, so it includes the construction of the route-plans
+   const double startOfSolve = systemGeneralStopCriterion::wallTime();
+
+   // Initial route-plans. 'mixed' takes turns among the construction heuristics
+   string construction = getOption(options, "construction", "mixed");
+   const char* heuristics[] = { "i1", "savings", "sweep" };
+   unsigned LNSIterations = atoi(getOption(options, "lns", "25").c_str());
+   bool adaptiveSelection = (getOption(options, "selection", "adaptive") == "adaptive");
+   if (construction != "random" && construction != "mixed" && construction != "i1" &&
+       construction != "savings" && construction != "sweep")
+   {
+      cout << "ERROR[!] Unknown construction heuristic: " << construction << endl;
+      exit(1);
+   }
 
 
    
@@ -201,15 +384,7 @@ int main( int argc, char **argv )
    srand(seed);
    MTRand randomNumber(seed);
 
-   // Get data from files
-   // readSolomonDataFile(fileName);
-   readCordeauDataFile(fileName);
-
    VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
-   VRPTWData->calculateDistanceMatrix();
-
-   // @Experimental: This is a new approach to add a new objective that takcles the tw violations in a different way
-   //VRPTWData->createZones(numberOfVehicles);
 
 
    // Creation of the agents  
@@ -225,6 +400,17 @@ int main( int argc, char **argv )
    // Ranking scheme
    neuralItem->rankingScheme = rankingType; 
 
+   // All the agents share the evaluations of the solutions they visit
+   evaluationCache* cache = new evaluationCache(65536);
+
+   // Each agent has its own generator, so the route-plans are built in parallel
+   VRPConstructionTask initialRoutePlans;
+   if (construction != "random")
+   {
+      for (unsigned i = 0; i < numberOfAgents; i++)
+         initialRoutePlans.add((construction == "mixed") ? heuristics[i % 3] : construction, seed + i + 1);
+      initialRoutePlans.build();
+   }
 
    for (unsigned i = 0; i < numberOfAgents; i++)
    {
@@ -236,6 +422,10 @@ int main( int argc, char **argv )
       // Agetn's id
       superFrog->setId(i);
 
+#ifdef STATIC_OBJECTIVES
+      // Problem - Objectives, priorities and flags are set up in VRPTWStaticProblem.h
+      multiObjectiveProblem* MOVRPTW = new VRPTWStaticProblemAdapter(VRPTWStaticProblemAdapter::paretoComparison);
+#else
       // Problem - Objectives
       singleObjectiveProblem* vehiclesProblem = new numberOfVehiclesProblem;
       singleObjectiveProblem* elapsedProblem = new elapsedTimeProblem;
@@ -290,9 +480,16 @@ int main( int argc, char **argv )
       //MOVRPTW->addProblem(timeWindowsDistributionProblem);
       //MOVRPTW->setMOScoreCriterion(new dynamicLexMOScoreCriterion(MOVRPTW->getProblems().size()));
       MOVRPTW->setMOScoreCriterion(new basicParetoFrontMOScoreCriterion());
+#endif
+
+      MOVRPTW->setEvaluationCache(cache);
 
       // Agent's Core
-      JFOAgent* frog = new JFOVRPAgent();
+      JFOVRPAgent* VRPFrog = new JFOVRPAgent();
+      VRPFrog->setLocalSearch((getOption(options, "localsearch", "neighbourhood") == "swap") ? JFOVRPAgent::swapLocalSearch
+                                                                                              : JFOVRPAgent::neighbourhoodLocalSearch);
+      VRPFrog->setRepair(getOption(options, "repair", "1") != "0");
+      JFOAgent* frog = VRPFrog;
       frog->setProblem(MOVRPTW);
       frog->initializeParameters();
       superFrog->setCore(frog);
@@ -302,7 +499,10 @@ int main( int argc, char **argv )
 
       // Solution
       multiObjectiveSolution* MOVRPTWSol = new VRPSolution(VRPTWData->getClientCoords().size());
-      (static_cast<VRPSolution*>(MOVRPTWSol))->setRandomRoutes(numberOfVehicles);
+      if (construction == "random")
+         (static_cast<VRPSolution*>(MOVRPTWSol))->setRandomRoutes(numberOfVehicles);
+      else
+         (static_cast<VRPSolution*>(MOVRPTWSol))->setRoutes(initialRoutePlans.getRoutePlan(i));
       (superFrog->getCore())->setCurrentSolution(MOVRPTWSol);
       (superFrog->getCore())->setBestSolution(bestMOSolution);
       MOVRPTW->evaluate(MOVRPTWSol);
@@ -311,7 +511,11 @@ int main( int argc, char **argv )
       //       executed in the same order.
       vector<phase*> phases;
       phases.push_back(new JFOCommunicationPhase());
-      phases.push_back(new JFOResolutorPhase(frog->getPointerToC1(), frog->getPointerToC2(), frog->getPointerToC3(), frog->getPointerToC4()));
+      JFOResolutorPhase* resolutor = new JFOResolutorPhase(frog->getPointerToC1(), frog->getPointerToC2(), frog->getPointerToC3(), frog->getPointerToC4());
+      resolutor->setAdaptiveSelection(adaptiveSelection);
+      phases.push_back(resolutor);
+      phases.push_back(new JFORouteEliminationPhase(10));
+      phases.push_back(new JFOLNSPhase(5, LNSIterations));
       superFrog->setPhases(phases);
 
       // Addition of this agent to the system
@@ -325,21 +529,500 @@ int main( int argc, char **argv )
    // WARNING: If the agent zero does not contains the problem, this will crash
    neuralItem->setProblems(&(frogAgents[0]->getCore()->getProblem()->getProblems())); 
 
+   // Archive of the non-dominated route-plans found by the swarm
+   paretoArchive* archive = NULL;
+   unsigned archiveSize = atoi(getOption(options, "archive", "0").c_str());
+   unsigned indicatorsFrequency = atoi(getOption(options, "indicators", "0").c_str());
+   unsigned stagnation = atoi(getOption(options, "stagnation", "0").c_str());
+   bool useIndicators = (indicatorsFrequency > 0 || stagnation > 0 || !getOption(options, "reference", "").empty() ||
+                         !getOption(options, "hvpoint", "").empty());
+   if (useIndicators && archiveSize == 0)
+      archiveSize = 100;
+   if (archiveSize > 0)
+   {
+      archive = new paretoArchive(frogAgents[0]->getCore()->getProblem()->getProblems(), archiveSize);
+      for (size_t i = 0; i < frogAgents.size(); i++)
+      {
+         frogAgents[i]->getCore()->setArchive(archive);
+         frogAgents[i]->getCore()->archiveSolution(frogAgents[i]->getCore()->getCurrentSolution());
+      }
+   }
+
 
    // Iterations of the system
-   systemGeneralStopCriterion* haltCriterion = new systemGeneralStopCriterion();
+   // Indicators of the archive, written into the trace and used to stop when the hypervolume stagnates
+   paretoIndicators* indicators = NULL;
+   systemGeneralStopCriterion* haltCriterion = NULL;
+   if (useIndicators)
+   {
+      indicators = new paretoIndicators(archive);
+      string reference = getOption(options, "reference", "");
+      if (!reference.empty() && !indicators->loadReferenceFront(reference))
+      {
+         cout << "ERROR[!] Cannot read the reference front: " << reference << endl;
+         exit(1);
+      }
+      string point = getOption(options, "hvpoint", "");
+      if (!point.empty())
+      {
+         vector<T> referencePoint;
+         replace(point.begin(), point.end(), ',', ' ');
+         istringstream values(point);
+         T value;
+         while (values >> value)
+            referencePoint.push_back(value);
+         if (referencePoint.size() != archive->getSorting().getNumberOfObjectives())
+         {
+            cout << "ERROR[!] The reference point needs " << archive->getSorting().getNumberOfObjectives() << " values" << endl;
+            exit(1);
+         }
+         indicators->setReferencePoint(referencePoint);
+      }
+      haltCriterion = new indicatorStopCriterion(indicators, stagnation, 1e-6, indicatorsFrequency);
+   }
+   else
+      haltCriterion = new systemGeneralStopCriterion();
    haltCriterion->setMaxIteration(2000); 
+   haltCriterion->setStartTime(startOfSolve);
+   if (!getOption(options, "budget", "").empty())
+      haltCriterion->setMaxTime(atof(getOption(options, "budget", "").c_str()));
 
 
-   // Creation of the system
-   coDecentralizedArchitecture CODEA;
-   CODEA.setAgents(frogAgents);
-   CODEA.setNumberOfPhases(2);
-   CODEA.setStopCriterion(haltCriterion);
-   CODEA.start();  
+   // Creation of the system. In async mode agents run in parallel without waiting for each other
+   string execution = getOption(options, "execution", "sync");
+   if (execution != "sync" && execution != "async")
+   {
+      cout << "ERROR[!] Unknown execution mode: " << execution << endl;
+      exit(1);
+   }
+   if (execution == "async" && (atoi(getOption(options, "islands", "1").c_str()) > 1 ||
+       !getOption(options, "checkpoint", "").empty() || !getOption(options, "resume", "").empty()))
+   {
+      cout << "ERROR[!] Islands and checkpoints are not available in async mode" << endl;
+      exit(1);
+   }
+   string arrivalsSource = getOption(options, "arrivals", "");
+   if (!arrivalsSource.empty() && (execution == "async" || atoi(getOption(options, "islands", "1").c_str()) > 1 ||
+       !getOption(options, "checkpoint", "").empty() || !getOption(options, "resume", "").empty()))
+   {
+      cout << "ERROR[!] Arrivals are only available in sync mode, without islands and checkpoints" << endl;
+      exit(1);
+   }
+   if (!arrivalsSource.empty() && (!getOption(options, "distances", "").empty() || !getOption(options, "times", "").empty()))
+   {
+      cout << "ERROR[!] Arrivals are not available with given distances or travel times" << endl;
+      exit(1);
+   }
+
+   // The cores that do not run agents help them to scan large neighbourhoods
+   unsigned agentThreads = (execution == "async") ? atoi(getOption(options, "threads", "0").c_str()) : 1;
+   if (agentThreads == 0 || agentThreads > numberOfAgents)
+      agentThreads = min(threadPool::getNumberOfCores(), numberOfAgents);
+   unsigned spareCores = (threadPool::getNumberOfCores() > agentThreads) ? threadPool::getNumberOfCores() - agentThreads : 0;
+   threadPool::instance()->setNumberOfWorkers(atoi(getOption(options, "scanthreads", somethingToString(spareCores)).c_str()));
+
+   coDecentralizedArchitecture* CODEA = (execution == "async") ? new asynchronousArchitecture(atoi(getOption(options, "threads", "0").c_str()))
+                                                               : new coDecentralizedArchitecture();
+   CODEA->setAgents(frogAgents);
+   CODEA->setNumberOfPhases(4);
+   // The route-plans are written while they improve
+   improvementStream* stream = NULL;
+   if (improvements != NULL)
+      stream = new improvementStream(haltCriterion, *improvements, &describeRoutePlan);
+   CODEA->setStopCriterion((stream != NULL) ? (systemStopCriterion*)stream : haltCriterion);
+
+   // Island model: several processes exchange their best route-plans
+   islandMigration* migration = NULL;
+   unsigned numberOfIslands = atoi(getOption(options, "islands", "1").c_str());
+   if (numberOfIslands > 1)
+   {
+      string topology = getOption(options, "topology", "ring");
+      if (topology != "ring" && topology != "all")
+      {
+         cout << "ERROR[!] Unknown topology: " << topology << endl;
+         exit(1);
+      }
+      // A route-plan has every costumer and, at most, a depot visit between two costumers
+      unsigned slotSize = 2 * VRPTWData->getClientCoords().size() * sizeof(cityIDType);
+      migration = new islandMigration(getOption(options, "shm", "/codea"),
+                                      atoi(getOption(options, "island", "0").c_str()), numberOfIslands,
+                                      (topology == "all") ? islandMigration::all : islandMigration::ring,
+                                      atoi(getOption(options, "migration", "50").c_str()),
+                                      atoi(getOption(options, "elites", "2").c_str()), slotSize);
+      CODEA->setMigration(migration);
+   }
+
+   // Checkpoints: the state is saved every given number of iterations and a run
+   //   can be resumed from it
+   string resume = getOption(options, "resume", "");
+   if (!resume.empty())
+   {
+      stateStream state;
+      if (!checkpoint::read(resume, state) || !CODEA->loadState(state))
+      {
+         cout << "ERROR[!] Cannot resume from " << resume << endl;
+         exit(1);
+      }
+   }
+   checkpoint* checkpointer = NULL;
+   if (!getOption(options, "checkpoint", "").empty())
+   {
+      checkpointer = new checkpoint(getOption(options, "checkpoint", ""), atoi(getOption(options, "checkpoints", "100").c_str()));
+      CODEA->setCheckpoint(checkpointer);
+   }
+
+   // Dynamic problem: costumers arrive while the agents are optimising
+   VRPDynamicArrivals* arrivals = NULL;
+   if (!arrivalsSource.empty())
+   {
+      arrivals = new VRPDynamicArrivals(arrivalsSource);
+      CODEA->setProblemChanges(arrivals);
+   }
+
+   CODEA->start();  
+   delete arrivals;
+   delete checkpointer;
+   delete migration;
+   if (archive != NULL)
+      archive->print(cout);
+   cache->print(cerr);
    cerr << "End!" << endl;
+   if (stream != NULL)
+      stream->finish(CODEA);
+   delete CODEA;
+   if (stream != NULL)
+      delete haltCriterion;
+   delete indicators;
+   delete archive;
 
 
    return 0;
 
 }
+
+/**
+   Daemon that solves the requests of local clients (see solverService). A request
+   has the same arguments as the command line. Instances are kept in memory with
+   their precomputations (distance matrix, spatial index), so a request on an
+   instance solved recently starts at once. They are told apart by their file
+   (and the time it was modified) or their data, and by the scale and the way the
+   distances are provided; the instance used least recently is dropped when there is no room for another one.
+*/
+class VRPTWService : public solverService
+{
+   private:
+      struct cachedInstance
+      {
+         VRPTWDataProblem* data;
+         unsigned long lastUse;
+      };
+
+      /**
+         Instances in memory, the maximum number of them and the number of requests so far.
+      */
+      map<string, cachedInstance> instances;
+      unsigned maxInstances;
+      unsigned long uses;
+
+      /**
+         Instance of the request that is being dispatched.
+      */
+      VRPTWDataProblem* prepared;
+
+   protected:
+      bool prepare(const solverRequest&, ostream&, string&);
+      int serve(const solverRequest&, const int);
+
+   public:
+      VRPTWService(const string&, const unsigned, const unsigned);
+      ~VRPTWService();
+};
+
+VRPTWService::VRPTWService(const string& socketName, const unsigned maxJobs, const unsigned maxInstances)
+   : solverService(socketName, maxJobs)
+{
+   this->maxInstances = max(maxInstances, 1u);
+   this->uses = 0;
+   this->prepared = NULL;
+}
+
+VRPTWService::~VRPTWService()
+{
+   for (map<string, cachedInstance>::iterator i = this->instances.begin(); i != this->instances.end(); ++i)
+      VRPTWDataProblem::dispose(i->second.data);
+}
+
+bool VRPTWService::prepare(const solverRequest& request, ostream& answer, string& error)
+{
+   if (request.arguments.size() < 6)
+   {
+      error = "the request needs an instance, the number of vehicles, agents and evolutions, the ranking type and a seed";
+      return false;
+   }
+   for (size_t i = 6; i < request.arguments.size(); i++)
+      if (request.arguments[i].find('=') == string::npos || request.arguments[i][0] == '=')
+      {
+         error = "options must be given as name=value: " + request.arguments[i];
+         return false;
+      }
+   const map<string, string> options = readOptions(request.arguments, 6);
+
+   // The files are told apart by their modification times too, so that changed files are read again
+   const string& fileName = request.arguments[0];
+   const char* files[] = { "distances", "times" };
+   string key = "scale " + getOption(options, "scale", "0") + " distancematrix " + getOption(options, "distancematrix", "auto");
+   for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++)
+   {
+      const string matrix = getOption(options, files[i], "");
+      struct stat file;
+      if (!matrix.empty() && stat(matrix.c_str(), &file) != 0)
+      {
+         error = "cannot read the matrix " + matrix;
+         return false;
+      }
+      if (!matrix.empty())
+         key += string(" ") + files[i] + " " + matrix + " " + somethingToString(file.st_mtime) + " " + somethingToString(file.st_size);
+   }
+   if (fileName == "-")
+      key += " data\n" + request.data;
+   else
+   {
+      struct stat file;
+      if (stat(fileName.c_str(), &file) != 0)
+      {
+         error = "cannot read the instance " + fileName;
+         return false;
+      }
+      key += " file " + fileName + " " + somethingToString(file.st_mtime) + " " + somethingToString(file.st_size);
+   }
+
+   map<string, cachedInstance>::iterator cached = this->instances.find(key);
+   if (cached != this->instances.end())
+   {
+      cached->second.lastUse = ++this->uses;
+      this->prepared = cached->second.data;
+      answer << "info instance in memory" << endl;
+      return true;
+   }
+
+   timespec start, end;
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   VRPTWData->clear();
+   if (fileName == "-")
+   {
+      istringstream data(request.data);
+      readCordeauData(data);
+   }
+   else
+      readCordeauDataFile(fileName.c_str());
+   if (VRPTWData->getClientCoords().size() < 2 || VRPTWData->getFleet().empty())
+   {
+      error = "the instance has no costumers";
+      return false;
+   }
+   if (!prepareInstance(options, error))
+      return false;
+   clock_gettime(CLOCK_MONOTONIC, &end);
+
+   if (this->instances.size() >= this->maxInstances)
+   {
+      map<string, cachedInstance>::iterator oldest = this->instances.begin();
+      for (map<string, cachedInstance>::iterator i = this->instances.begin(); i != this->instances.end(); ++i)
+         if (i->second.lastUse < oldest->second.lastUse)
+            oldest = i;
+      VRPTWDataProblem::dispose(oldest->second.data);
+      this->instances.erase(oldest);
+   }
+   cachedInstance instance;
+   instance.data = VRPTWData->clone();
+   instance.lastUse = ++this->uses;
+   this->instances[key] = instance;
+   this->prepared = instance.data;
+
+   answer << "info instance loaded in " << 1000 * (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e6
+          << " ms (" << VRPTWData->getClientCoords().size() - 1 << " costumers)" << endl;
+   return true;
+}
+
+int VRPTWService::serve(const solverRequest& request, const int client)
+{
+   assert(this->prepared != NULL);
+   VRPTWDataProblem::instance()->restore(*this->prepared);
+
+   // The cores are shared by the requests solved at a time
+   map<string, string> options = readOptions(request.arguments, 6);
+   if (options.find("scanthreads") == options.end())
+      options["scanthreads"] = somethingToString(max(threadPool::getNumberOfCores() / getMaxJobs(), 1u) - 1);
+
+   // The trace goes to the client only if it asks for it
+   const int trace = (getOption(options, "trace", "0") != "0") ? client : open("/dev/null", O_WRONLY);
+   dup2(trace, 1);
+   dup2(trace, 2);
+
+   descriptorBuffer buffer(client);
+   ostream answer(&buffer);
+   const int status = solve(atoi(request.arguments[1].c_str()), atoi(request.arguments[2].c_str()),
+                            atoi(request.arguments[4].c_str()), atoi(request.arguments[5].c_str()), options, &answer);
+   answer.flush();
+   return status;
+}
+
+/**
+   Sends the problem of the command line to a daemon (option server) and writes its
+   answer. The daemon reads the file unless the instance is sent with the request.
+*/
+int requestSolution(int argc, char **argv, const map<string, string>& options)
+{
+   solverRequest request;
+   if (getOption(options, "inline", "0") != "0")
+   {
+      ifstream file(argv[1]);
+      ostringstream data;
+      if (!file || !(data << file.rdbuf()))
+      {
+         cout << "ERROR[!] Cannot read the instance " << argv[1] << endl;
+         exit(1);
+      }
+      request.arguments.push_back("-");
+      request.data = data.str();
+   }
+   else
+   {
+      // The daemon may run in another directory
+      char* path = realpath(argv[1], NULL);
+      if (path == NULL)
+      {
+         cout << "ERROR[!] Cannot read the instance " << argv[1] << endl;
+         exit(1);
+      }
+      request.arguments.push_back(path);
+      free(path);
+   }
+   for (int i = 2; i < argc; i++)
+   {
+      string argument(argv[i]);
+      if (argument.compare(0, 10, "distances=") == 0 || argument.compare(0, 6, "times=") == 0)
+      {
+         const size_t equal = argument.find('=');
+         char* path = realpath(argument.substr(equal + 1).c_str(), NULL);
+         if (path == NULL)
+         {
+            cout << "ERROR[!] Cannot read the matrix " << argument.substr(equal + 1) << endl;
+            exit(1);
+         }
+         argument = argument.substr(0, equal + 1) + path;
+         free(path);
+      }
+      if (argument.compare(0, 7, "server=") != 0 && argument.compare(0, 7, "inline=") != 0)
+         request.arguments.push_back(argument);
+   }
+   return solverService::request(getOption(options, "server", ""), request, cout);
+}
+
+int main( int argc, char **argv )
+{
+   //cout << "CODEA - MOJFO 4 VRPTW" << endl;
+   //cout << "---------------------" << endl;
+
+   // Daemon mode: problems arrive through a socket
+   if (argc >= 2 && string(argv[1]).compare(0, 7, "daemon=") == 0)
+   {
+      map<string, string> options = readOptions(argc, argv, 1);
+      VRPTWService service(getOption(options, "daemon", ""),
+                           atoi(getOption(options, "jobs", somethingToString(threadPool::getNumberOfCores())).c_str()),
+                           atoi(getOption(options, "instances", "8").c_str()));
+      service.run();
+      return 0;
+   }
+
+   if (argc < 5)
+   {
+      cout << "ERROR[!]" << endl;
+      cout << "You must provide:" << endl;
+      cout << "  - a filename with the data of the problem." << endl;
+      cout << "  - the number of vehicles you want to work with." << endl;
+      cout << "  - the number of agents within the swarm." << endl;
+      cout << "  - the number of evolutions. " << endl;
+      cout << "  - the ranking type: 0 Pareto, 1 Lexicographic, 2 Dynamic lexicographic, 3 Non-dominated sorting. " << endl;
+      cout << "  - seed." << endl;
+      cout << "Options (name=value) may follow:" << endl;
+      cout << "  - construction: random, i1, savings, sweep or mixed (default)." << endl;
+      cout << "  - repair: 1 (default) to repair the route-plans after copying routes, 0 otherwise." << endl;
+      cout << "  - lns: ruin and recreate iterations every 5 iterations (default 25, 0 disables it)." << endl;
+      cout << "  - selection: adaptive (default) to set c1-c4 from the payoff of the movements, fixed otherwise." << endl;
+      cout << "  - islands: number of processes that exchange solutions (default 1, see islands.sh)." << endl;
+      cout << "  - island: id of this process, 0 is the coordinator (default 0)." << endl;
+      cout << "  - migration: iterations between two migrations (default 50)." << endl;
+      cout << "  - topology: ring (default) or all." << endl;
+      cout << "  - elites: solutions sent in each migration (default 2)." << endl;
+      cout << "  - shm: name of the shared memory segment (default /codea)." << endl;
+      cout << "  - checkpoint: file where the state of the system is saved (default none)." << endl;
+      cout << "  - checkpoints: iterations between two checkpoints (default 100)." << endl;
+      cout << "  - resume: checkpoint to resume the run from. The rest of the arguments must be the same." << endl;
+      cout << "  - execution: sync (default) to run the agents one after the other or async to run them in parallel." << endl;
+      cout << "  - threads: threads that run the agents in async mode (default one per core)." << endl;
+      cout << "  - archive: size of the archive of non-dominated route-plans printed at the end (default 0, none)." << endl;
+      cout << "  - indicators: iterations between two lines with the hypervolume (and IGD) of the archive (default 0, none)." << endl;
+      cout << "  - reference: file with the reference front for IGD (default none)." << endl;
+      cout << "  - hvpoint: reference point of the hypervolume, comma separated (default the worst values plus 10%)." << endl;
+      cout << "  - stagnation: iterations without improvement of the hypervolume to stop (default 0, never)." << endl;
+      cout << "  - localsearch: neighbourhood (default) for the granular local search or swap for the swap local search." << endl;
+      cout << "  - scanthreads: threads that help the agents to scan the swaps of large route-plans (default the spare cores)." << endl;
+      cout << "  - scale: integer costs, distances and times are multiplied by it and truncated, e.g. 10 (default 0, floating-point)." << endl;
+      cout << "  - distances: file with the matrix of distances, which may be asymmetric, a row per costumer (default the Euclidean ones)." << endl;
+      cout << "  - times: file with the matrix of travel times, as the distances (default the distances). Files ending in .bin hold doubles." << endl;
+      cout << "  - distancematrix: dense to keep the Euclidean distances in a matrix, ondemand to compute them from the positions" << endl;
+      cout << "    when they are needed or auto (default) for the latter above " << VRPDENSEDISTANCESLIMIT << " costumers." << endl;
+      cout << "  - arrivals: file or named pipe with costumers that arrive during the run, a line per costumer:" << endl;
+      cout << "    <iteration> <x> <y> <demand> <service time> <ready time> <due time> (default none, sync mode only)." << endl;
+      cout << "  - budget: seconds the run may last, in wall time from the start of the solve (default none)." << endl;
+      cout << "  - improvements: file where the best route-plan is written every time it improves, with the time (default none)." << endl;
+      cout << "  - server: socket of a daemon that solves the problem instead of this process (see below)." << endl;
+      cout << "  - inline: 1 to send the instance to the daemon with the request, 0 (default) to let it read the file." << endl;
+      cout << "  - trace: 1 to get the trace from the daemon too, 0 (default) for the improving route-plans only." << endl;
+      cout << "Example ./CODEA2 data.txt 10 50 5000 0 200 construction=i1" << endl;
+      cout << "Daemon mode: ./CODEA2 daemon=<socket> [jobs=<requests solved at a time>] [instances=<instances kept in memory>]" << endl;
+      exit(1);
+   }
+   //cout << "Starting up..." << endl;
+
+   // Variables
+   char* fileName = argv[1];
+   unsigned numberOfVehicles = atoi(argv[2]);
+   unsigned numberOfAgents = atoi(argv[3]);
+   unsigned numberOfEvolutions = atoi(argv[4]);
+   unsigned rankingType = atoi(argv[5]);
+   unsigned seed = atoi(argv[6]);
+   map<string, string> options = readOptions(argc, argv, 7);
+
+   // Client mode: a daemon solves the problem
+   if (!getOption(options, "server", "").empty())
+      return requestSolution(argc, argv, options);
+
+   // Get data from files
+   // readSolomonDataFile(fileName);
+   readCordeauDataFile(fileName);
+   string error;
+   // Every core helps to build the distance matrix (solve leaves the spare ones to the scans)
+   threadPool::instance()->setNumberOfWorkers(threadPool::getNumberOfCores() - 1);
+   if (!prepareInstance(options, error))
+   {
+      cout << "ERROR[!] " << error << endl;
+      exit(1);
+   }
+
+   // The improving route-plans may be written into a file, with the time they were found
+   ofstream improvementsFile;
+   if (!getOption(options, "improvements", "").empty())
+   {
+      improvementsFile.open(getOption(options, "improvements", "").c_str());
+      if (!improvementsFile)
+      {
+         cout << "ERROR[!] Cannot write the improvements into " << getOption(options, "improvements", "") << endl;
+         exit(1);
+      }
+   }
+
+   return solve(numberOfVehicles, numberOfAgents, rankingType, seed, options, improvementsFile.is_open() ? &improvementsFile : NULL);
+}
@@ -31,10 +31,20 @@
 #include "./agents/JFO/JFOAgent.h"
 #include "./problems/VRPTW/VRPSolution.h"
 #include "./problems/VRPTW/VRPLib.h"
+#include "./problems/VRPTW/VRPTWLocalSearch.h"
+#include "./problems/VRPTW/VRPRouteElimination.h"
+#include "./problems/VRPTW/VRPRuinRecreate.h"
 
 
 class JFOVRPAgent : public JFOAgent
 {
+   public:
+      /**
+         Local searches available for localSearchMethod: the swap of
+         costumers of the VRPLib or the neighbourhoods of VRPTWLocalSearch.
+      */
+      enum localSearchType { swapLocalSearch, neighbourhoodLocalSearch };
+
    private:
       /**
          This route represent the output of the movement of a particle
@@ -42,12 +52,39 @@ class JFOVRPAgent : public JFOAgent
       */
       routesType newRoutes;
 
+      /**
+         Local search used by localSearchMethod.
+      */
+      localSearchType localSearchKind;
+
+      /**
+         Engine of the neighbourhood local search. Each agent has its own one.
+      */
+      VRPTWLocalSearch engine;
+
+      /**
+         Route elimination of routeEliminationMethod.
+      */
+      VRPRouteElimination eliminator;
+
+      /**
+         Adaptive ruin and recreate of largeNeighbourhoodMethod. Each agent
+         has its own weights.
+      */
+      VRPRuinRecreate ruinRecreate;
+
+      /**
+         If true, the movements with an attractor repair the route-plan after
+         copying a route (see twitterRepair).
+      */
+      bool repair;
+
    protected:
 
    public:
 
       /**
-         Default constructor. It does nothing.
+         Default constructor. It selects the swap local search and no repair.
       */
       JFOVRPAgent();
 
@@ -56,6 +93,14 @@ class JFOVRPAgent : public JFOAgent
       */
       ~JFOVRPAgent();
 
+      void setLocalSearch(const localSearchType kind) { this->localSearchKind = kind; }
+      localSearchType getLocalSearch() const { return this->localSearchKind; }
+      VRPTWLocalSearch& getLocalSearchEngine() { return this->engine; }
+      VRPRouteElimination& getRouteEliminator() { return this->eliminator; }
+      VRPRuinRecreate& getRuinRecreate() { return this->ruinRecreate; }
+      void setRepair(const bool repair) { this->repair = repair; }
+      bool getRepair() const { return this->repair; }
+
       /**
          Method that implements the inherited virtual method from 
          JFOAgent. It performs an inertial movement in which there
@@ -74,12 +119,12 @@ class JFOVRPAgent : public JFOAgent
          JFOAgent. It performs an cognitive movement in which the
          attractor is the best solution in the neighborhood.
          @param multiObjectiveSolution* is the current solution (follower)
-         @param multiObjectiveSolution* is the solution to follow (attractor)
+         @param const multiObjectiveSolution* is the solution to follow (attractor)
          @param multiObjectiveSolution* is the solution to be output.
          @param std::string options is a reserved with options.
       */
       void cognitiveMovement(multiObjectiveSolution* currentSolution, 
-                             multiObjectiveSolution* attractor,
+                             const multiObjectiveSolution* attractor,
                              multiObjectiveSolution* metaSolutionOut,
                              const string options = "");
 
@@ -88,12 +133,12 @@ class JFOVRPAgent : public JFOAgent
          JFOAgent. It performs an local movement in which the
          attractor is the best own solution achieved so far.
          @param multiObjectiveSolution* is the current solution (follower)
-         @param multiObjectiveSolution* is the solution to follow (attractor)
+         @param const multiObjectiveSolution* is the solution to follow (attractor)
          @param multiObjectiveSolution* is the solution to be output.
          @param std::string options is a reserved with options.
       */
      void localMovement(multiObjectiveSolution* currentSolution, 
-                             multiObjectiveSolution* attractor,
+                             const multiObjectiveSolution* attractor,
                              multiObjectiveSolution* metaSolutionOut,
                              const string options = "");
 
@@ -102,12 +147,12 @@ class JFOVRPAgent : public JFOAgent
          JFOAgent. It performs an social movement in which the
          attractor is the best solution found by the swarm so far.
          @param multiObjectiveSolution* is the current solution (follower)
-         @param multiObjectiveSolution* is the solution to follow (attractor)
+         @param const multiObjectiveSolution* is the solution to follow (attractor)
          @param multiObjectiveSolution* is the solution to be output.
          @param std::string options is a reserved with options.
       */
       void socialMovement(multiObjectiveSolution* currentSolution, 
-                          multiObjectiveSolution* attractor,
+                          const multiObjectiveSolution* attractor,
                           multiObjectiveSolution* metaSolutionOut,
                           const string options = "");
 
@@ -122,17 +167,58 @@ class JFOVRPAgent : public JFOAgent
       void localSearchMethod(multiObjectiveSolution* currentSolution, 
                              const string options = "");
 
+      /**
+         Method that implements the inherited virtual method from
+         JFOAgent. It tries to remove one route from the route-plan
+         (see VRPRouteElimination).
+         @param multiObjectiveSolution* is the current solution
+         @param const std::string options is a reserved string for
+         optiones.
+         @return true if a route was removed.
+      */
+      bool routeEliminationMethod(multiObjectiveSolution* currentSolution,
+                                  const string options = "");
+
+      /**
+         Method that implements the inherited virtual method from
+         JFOAgent. It carries out a number of ruin and recreate
+         iterations (see VRPRuinRecreate).
+         @param multiObjectiveSolution* is the current solution
+         @param const unsigned is the number of iterations.
+         @param const std::string options is a reserved string for
+         optiones.
+         @return true if a better route-plan was found.
+      */
+      bool largeNeighbourhoodMethod(multiObjectiveSolution* currentSolution,
+                                    const unsigned iterations,
+                                    const string options = "");
+
       /**
          Virtual method that is intended to accept or reject new solution or
          output of movements. This is useful if you want agents to move only
          on feasible areas.
       */
       virtual bool isAValidMovement();
+
+      /**
+         Method that writes the state of the agent into a checkpoint. Apart from the
+         state of JFOAgent, it writes the weights of the ruin and recreate.
+         @param stateStream& is the stream.
+      */
+      void saveState(stateStream&) const;
+
+      /**
+         Method that reads the state written by saveState.
+         @param stateStream& is the stream.
+         @return false if the stream failed.
+      */
+      bool loadState(stateStream&);
 };
 
 JFOVRPAgent::JFOVRPAgent()
 {
-
+   this->localSearchKind = swapLocalSearch;
+   this->repair = false;
 }
 
 JFOVRPAgent::~JFOVRPAgent()
@@ -155,43 +241,84 @@ inline void JFOVRPAgent::inertialMovement(multiObjectiveSolution* ci,
 }
 
 inline void JFOVRPAgent::cognitiveMovement(multiObjectiveSolution* ci, 
-                                           multiObjectiveSolution* ai, 
+                                           const multiObjectiveSolution* ai, 
                                            multiObjectiveSolution* ni,
                                            const string options)
 {
    const routesType& follower = (static_cast<VRPSolution*>(ci))->getRoutes();
-   const routesType& attractor = (static_cast<VRPSolution*>(ai))->getRoutes();
-   routesType offSpringRoutes = twitter(follower, attractor, options);
+   const routesType& attractor = (static_cast<const VRPSolution*>(ai))->getRoutes();
+   routesType offSpringRoutes = this->repair ? twitterRepair(follower, attractor, options) : twitter(follower, attractor, options);
    (static_cast<VRPSolution*>(ni))->setRoutes(offSpringRoutes);
 }
 
 inline void JFOVRPAgent::localMovement(multiObjectiveSolution* ci, 
-                                       multiObjectiveSolution* ai, 
+                                       const multiObjectiveSolution* ai, 
                                        multiObjectiveSolution* ni,
                                        const string options)
 {
-   routesType offSpringRoutes = twitter((static_cast<VRPSolution*>(ci))->getRoutes(),
-                                     (static_cast<VRPSolution*>(ai))->getRoutes());
+   const routesType& follower = (static_cast<VRPSolution*>(ci))->getRoutes();
+   const routesType& attractor = (static_cast<const VRPSolution*>(ai))->getRoutes();
+   routesType offSpringRoutes = this->repair ? twitterRepair(follower, attractor) : twitter(follower, attractor);
 
    (static_cast<VRPSolution*>(ni))->setRoutes(offSpringRoutes);
 }
 
 inline void JFOVRPAgent::socialMovement(multiObjectiveSolution* ci, 
-                                        multiObjectiveSolution* ai, 
+                                        const multiObjectiveSolution* ai, 
                                         multiObjectiveSolution* ni,
                                         const string options)
 { 
-   routesType offSpringRoutes = twitter((static_cast<VRPSolution*>(ci))->getRoutes(),
-                                     (static_cast<VRPSolution*>(ai))->getRoutes());
+   const routesType& follower = (static_cast<VRPSolution*>(ci))->getRoutes();
+   const routesType& attractor = (static_cast<const VRPSolution*>(ai))->getRoutes();
+   routesType offSpringRoutes = this->repair ? twitterRepair(follower, attractor) : twitter(follower, attractor);
 
    (static_cast<VRPSolution*>(ni))->setRoutes(offSpringRoutes);
 }
 
 inline void JFOVRPAgent::localSearchMethod(multiObjectiveSolution* ci, const string options)
 { 
-   routesType offSpringRoutes = localSearch((static_cast<VRPSolution*>(ci))->getRoutes(), options);
+   // The output of the neighbourhood engine is a local optimum, so it is remembered
+   //   and the search is not repeated when an agent reaches it again. The swap local
+   //   search always applies a swap, so its output is not
+   evaluationCache* cache = (this->localSearchKind == neighbourhoodLocalSearch) ? getProblem()->getEvaluationCache() : NULL;
+   if (cache != NULL && cache->isLocalOptimum(ci->getHash()))
+      return;
+
+   // The swap local search updates the signature with every swap it keeps
+   routesType offSpringRoutes;
+   hashType hash = 0;
+   if (this->localSearchKind == neighbourhoodLocalSearch)
+      offSpringRoutes = this->engine.run((static_cast<VRPSolution*>(ci))->getRoutes());
+   else
+   {
+      hash = ci->getHash();
+      offSpringRoutes = localSearch((static_cast<VRPSolution*>(ci))->getRoutes(), options, &hash);
+   }
+
+   (static_cast<VRPSolution*>(ci))->setRoutes(offSpringRoutes, hash);
+
+   if (cache != NULL)
+      cache->setLocalOptimum(ci->getHash());
+}
+
+inline bool JFOVRPAgent::routeEliminationMethod(multiObjectiveSolution* ci, const string options)
+{
+   routesType offSpringRoutes = (static_cast<VRPSolution*>(ci))->getRoutes();
+   if (!this->eliminator.run(offSpringRoutes))
+      return false;
 
    (static_cast<VRPSolution*>(ci))->setRoutes(offSpringRoutes);
+   return true;
+}
+
+inline bool JFOVRPAgent::largeNeighbourhoodMethod(multiObjectiveSolution* ci, const unsigned iterations, const string options)
+{
+   routesType offSpringRoutes = (static_cast<VRPSolution*>(ci))->getRoutes();
+   if (!this->ruinRecreate.run(offSpringRoutes, iterations))
+      return false;
+
+   (static_cast<VRPSolution*>(ci))->setRoutes(offSpringRoutes);
+   return true;
 }
 
 bool JFOVRPAgent::isAValidMovement()
@@ -204,4 +331,15 @@ bool JFOVRPAgent::isAValidMovement()
    return true;
 }
 
+inline void JFOVRPAgent::saveState(stateStream& state) const
+{
+   JFOAgent::saveState(state);
+   this->ruinRecreate.saveState(state);
+}
+
+inline bool JFOVRPAgent::loadState(stateStream& state)
+{
+   return JFOAgent::loadState(state) && this->ruinRecreate.loadState(state);
+}
+
 #endif
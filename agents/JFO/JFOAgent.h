@@ -30,9 +30,11 @@
 #ifndef JFOAGENT_H
 #define JFOAGENT_H
 
+#include <cassert>
 #include <string>
 #include <cmath>
 
+#include "../../core/checkpoint.h"
 #include "../../core/core.h"
 #include "../../core/header.h"
 #include "../../core/multiObjectiveSolution.h"
@@ -159,12 +161,12 @@ class JFOAgent : public core
          Virtual method that is intended to implement the JFO's cognitive move.
          The attractor in this case should be the best solution in the neighborhood.
          @param  multiObjectiveSolution* is a pointer to the solution that acts as the follower
-         @param  multiObjectiveSolution* is a pointer to the soluiton that asts as the attractor
+         @param  const multiObjectiveSolution* is a pointer to the soluiton that asts as the attractor
          @param  multiObjectiveSolution* is a pointer to the output solution
          @param  const std::string options is a reserved string for parameters
       */
       virtual void cognitiveMovement(multiObjectiveSolution* currentSolution, 
-                                     multiObjectiveSolution* attractor,
+                                     const multiObjectiveSolution* attractor,
                                      multiObjectiveSolution* metaSolutionOut,
                                      const std::string options = "") = 0;
 
@@ -172,24 +174,24 @@ class JFOAgent : public core
          Virtual method that is intended to implement the JFO's local move.
          The attractor in this case should be the best solution this agent has achieved.
          @param  multiObjectiveSolution* is a pointer to the solution that acts as the follower
-         @param  multiObjectiveSolution* is a pointer to the soluiton that asts as the attractor
+         @param  const multiObjectiveSolution* is a pointer to the soluiton that asts as the attractor
          @param  multiObjectiveSolution* is a pointer to the output solutionid 	socialMoveme
          @param  const std::string options is a reserved string for parameters
       */
       virtual void localMovement(multiObjectiveSolution* currentSolution, 
-                                     multiObjectiveSolution* attractor,
+                                     const multiObjectiveSolution* attractor,
                                      multiObjectiveSolution* metaSolutionOut,
                                      const std::string options = "") = 0;
       /**
          Virtual method that is intended to implement the JFO's social move.
          The attractor in this case should be the best solution achieve by the whole swarm.
          @param  multiObjectiveSolution* is a pointer to the solution that acts as the follower
-         @param  multiObjectiveSolution* is a pointer to the soluiton that asts as the attractor
+         @param  const multiObjectiveSolution* is a pointer to the soluiton that asts as the attractor
          @param  multiObjectiveSolution* is a pointer to the output solution
          @param  const std::string options is a reserved string for parameters
       */
       virtual void socialMovement(multiObjectiveSolution* currentSolution, 
-                                     multiObjectiveSolution* attractor,
+                                     const multiObjectiveSolution* attractor,
                                      multiObjectiveSolution* metaSolutionOut,
                                      const std::string options = "") = 0;
 
@@ -200,12 +202,51 @@ class JFOAgent : public core
       virtual void localSearchMethod(multiObjectiveSolution* currentSolution,
                                      const std::string options = "") = 0;
 
+      /**
+         Virtual method that is intended to reduce the size of a solution (e.g. the
+         number of routes of a route-plan). It is used by JFORouteEliminationPhase.
+         By default it does nothing.
+         @param  multiObjectiveSolution* is a pointer to the current solution
+         @param  const std::string options is a reserved string for parameters
+         @return true if the solution was changed.
+      */
+      virtual bool routeEliminationMethod(multiObjectiveSolution* currentSolution,
+                                          const std::string options = "") { return false; }
+
+      /**
+         Virtual method that is intended to carry out a number of iterations of a
+         large neighbourhood search (ruin and recreate). It is used by JFOLNSPhase.
+         By default it does nothing.
+         @param  multiObjectiveSolution* is a pointer to the current solution
+         @param  const unsigned is the number of iterations
+         @param  const std::string options is a reserved string for parameters
+         @return true if the solution was changed.
+      */
+      virtual bool largeNeighbourhoodMethod(multiObjectiveSolution* currentSolution,
+                                            const unsigned iterations,
+                                            const std::string options = "") { return false; }
+
       /**
          Virtual method that is intended to accept or reject new solution or
          output of movements. This is useful if you want agents to move only
          on feasible areas.
       */
-      virtual bool isAValidMovement() = 0;
+      virtual bool isAValidMovement() = 0;
+
+      /**
+         Method that writes the state of the agent into a checkpoint: the state of
+         the core and the likelihood indexes. Inherited classes add the state of
+         their methods (e.g. the weights of an adaptive search).
+         @param stateStream& is the stream.
+      */
+      void saveState(stateStream&) const;
+
+      /**
+         Method that reads the state written by saveState.
+         @param stateStream& is the stream.
+         @return false if the stream failed.
+      */
+      bool loadState(stateStream&);
 };
 
 JFOAgent::JFOAgent()
@@ -323,12 +364,40 @@ inline void JFOAgent::updateParameters(unsigned it)
 }
 
 
-inline void JFOAgent::initializeParameters()
-{
-   this->c1 = 0.25;
-   this->c2 = 0.25;
-   this->c3 = 0.25;
-   this->c4 = 0.25;
-}
+inline void JFOAgent::initializeParameters()
+{
+   this->c1 = 0.25;
+   this->c2 = 0.25;
+   this->c3 = 0.25;
+   this->c4 = 0.25;
+}
+
+inline void JFOAgent::saveState(stateStream& state) const
+{
+   core::saveState(state);
+   state.write(this->c1);
+   state.write(this->c2);
+   state.write(this->c3);
+   state.write(this->c4);
+
+   // The best own solution is the current solution once the agent has moved
+   //    (see JFOResolutorPhase), so only that is written
+   assert(this->bestOwnSolution == NULL || this->bestOwnSolution == getCurrentSolution());
+   state.write<bool>(this->bestOwnSolution != NULL);
+}
+
+inline bool JFOAgent::loadState(stateStream& state)
+{
+   bool hasBestOwnSolution = false;
+   if (!core::loadState(state))
+      return false;
+   state.read(this->c1);
+   state.read(this->c2);
+   state.read(this->c3);
+   state.read(this->c4);
+   state.read(hasBestOwnSolution);
+   this->bestOwnSolution = hasBestOwnSolution ? getCurrentSolution() : NULL;
+   return state.good();
+}
 
 #endif
@@ -0,0 +1,194 @@
+/**
+   @class JFOOperatorSelection
+
+   @brief Adaptive selection of the JFO movements.
+
+   The likelihood indexes c1, c2, c3 and c4 of a JFOAgent decide how often
+   each movement (inertial, cognitive, local and social) is carried out.
+   This class sets them from the payoff each movement has shown so far by
+   means of probability matching: every movement has a quality and its
+   probability is proportional to it, with a minimum probability so that
+   no movement is ever discarded.
+
+   Movements differ in cost by orders of magnitude, so the quality of a
+   movement is its reward per CPU-second: the ratio between the exponential
+   moving averages of the rewards it gets and of the thread CPU time it
+   takes (the movement, the local search and the evaluation). A movement
+   that cannot be carried out (its attractor is not available) falls back
+   to the inertial one, and the outcome is credited to the movement drawn,
+   so the optimistic quality of the movements not tried yet only lasts
+   until they are drawn for the first time.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef JFOOPERATORSELECTION_H
+#define JFOOPERATORSELECTION_H
+
+#include <time.h>
+
+#include <cassert>
+#include <vector>
+
+#include "JFOAgent.h"
+#include "../../core/checkpoint.h"
+
+class JFOOperatorSelection
+{
+   private:
+      /**
+         Exponential moving averages of the reward and of the CPU time of
+         each movement.
+      */
+      std::vector<double> reward, time;
+
+      /**
+         Number of times each movement has been recorded.
+      */
+      std::vector<unsigned> uses;
+
+      /**
+         Adaptation rate of the moving averages.
+      */
+      double adaptationRate;
+
+      /**
+         Minimum probability of a movement.
+      */
+      double minimumProbability;
+
+   protected:
+
+   public:
+      /**
+         Constructor.
+         @param const unsigned is the number of movements.
+         @param const double is the adaptation rate.
+         @param const double is the minimum probability of a movement.
+      */
+      JFOOperatorSelection(const unsigned = 4, const double = 0.1, const double = 0.05);
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~JFOOperatorSelection() { };
+
+      /**
+         Method that returns the CPU time consumed by the calling thread.
+         @return the time in seconds.
+      */
+      static double threadCPUTime();
+
+      /**
+         Method that records the outcome of a movement.
+         @param const unsigned is the movement.
+         @param const double is the reward it got.
+         @param const double is the CPU time it took.
+      */
+      void update(const unsigned, const double, const double);
+
+      /**
+         Method that returns the probability of each movement.
+         @return a vector with the probabilities (they add up to 1).
+      */
+      std::vector<double> getProbabilities() const;
+
+      /**
+         Method that sets the likelihood indexes of an agent from the probabilities.
+      */
+      void setParameters(JFOParameters*, JFOParameters*, JFOParameters*, JFOParameters*) const;
+
+      /**
+         Method that writes the moving averages into a checkpoint.
+      */
+      void saveState(stateStream&) const;
+
+      /**
+         Method that reads the moving averages written by saveState.
+         @return false if the stream failed or the number of movements is different.
+      */
+      bool loadState(stateStream&);
+};
+
+JFOOperatorSelection::JFOOperatorSelection(const unsigned numberOfMovements, const double adaptationRate, const double minimumProbability)
+{
+   this->reward.assign(numberOfMovements, 0);
+   this->time.assign(numberOfMovements, 0);
+   this->uses.assign(numberOfMovements, 0);
+   this->adaptationRate = adaptationRate;
+   this->minimumProbability = minimumProbability;
+}
+
+inline double JFOOperatorSelection::threadCPUTime()
+{
+   struct timespec now;
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+   return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+inline void JFOOperatorSelection::update(const unsigned movement, const double reward, const double time)
+{
+   assert(movement < this->reward.size());
+
+   // The first outcome initializes the averages
+   const double rate = (this->uses[movement] == 0) ? 1 : this->adaptationRate;
+   this->reward[movement] += rate * (reward - this->reward[movement]);
+   this->time[movement] += rate * (time - this->time[movement]);
+   this->uses[movement]++;
+}
+
+inline std::vector<double> JFOOperatorSelection::getProbabilities() const
+{
+   const size_t n = this->reward.size();
+   std::vector<double> probability(n, 1.0 / n);
+
+   // Movements not tried yet get the best quality seen so far
+   double total = 0, best = 0;
+   for (size_t i = 0; i < n; i++)
+   {
+      probability[i] = (this->time[i] > 0) ? this->reward[i] / this->time[i] : 0;
+      if (this->uses[i] > 0 && probability[i] > best)
+         best = probability[i];
+   }
+   for (size_t i = 0; i < n; i++)
+   {
+      if (this->uses[i] == 0)
+         probability[i] = best;
+      total += probability[i];
+   }
+
+   // If nothing pays off, all the movements are equally likely
+   for (size_t i = 0; i < n; i++)
+      probability[i] = (total > 0) ? this->minimumProbability + (1 - n * this->minimumProbability) * probability[i] / total : 1.0 / n;
+   return probability;
+}
+
+inline void JFOOperatorSelection::setParameters(JFOParameters* c1, JFOParameters* c2, JFOParameters* c3, JFOParameters* c4) const
+{
+   std::vector<double> probability = getProbabilities();
+   assert(probability.size() == 4);
+   *c1 = probability[0];
+   *c2 = probability[1];
+   *c3 = probability[2];
+   *c4 = probability[3];
+}
+
+inline void JFOOperatorSelection::saveState(stateStream& state) const
+{
+   state.writeVector(this->reward);
+   state.writeVector(this->time);
+   state.writeVector(this->uses);
+}
+
+inline bool JFOOperatorSelection::loadState(stateStream& state)
+{
+   const size_t n = this->reward.size();
+   state.readVector(this->reward);
+   state.readVector(this->time);
+   state.readVector(this->uses);
+   if (this->reward.size() != n || this->time.size() != n || this->uses.size() != n)
+      state.fail();
+   return state.good();
+}
+
+#endif
@@ -8,6 +8,10 @@
    recipients depending on the neighborhood of this agent. Next, it
    packs the message to be sent. And finally, it puts the message
    on neighbor's mailboxes.
+
+   The message holds a snapshot of the agent's current solution (see
+   solutionSnapshot), not the solution itself, so the receivers can keep
+   it while the sender goes on changing its current solution.
 
    @author Group of Intelligent Computing - Universidad de La Laguna - 2008
 */
@@ -19,6 +23,7 @@
 
 #include "../../../core/agent.h"
 #include "../../../core/phase.h"
+#include "../../../core/solutionSnapshot.h"
 
 #include "../JFOAgent.h"
 
@@ -70,7 +75,7 @@ void JFOCommunicationPhase::prePhase(agent* currentAgent, std::vector<agent*>* t
    {
       container data("Sender", currentAgent);
       info.push_back(data);
-      data.set("Solution", superFrog->getCurrentSolution());
+      data.set("Solution", superFrog->publishCurrentSolution());
       info.push_back(data);
    }
    currentAgent->setMessage(info);
@@ -83,7 +88,7 @@ void JFOCommunicationPhase::core(agent* currentAgent, std::vector<agent*>* team)
       vector<agent*> *group = currentAgent->getNeighborhood()->list();
       for (unsigned i = 0; i < (*group).size(); i++)
          if (currentAgent->getId() != (*group)[i]->getId())
-            (*group)[i]->getPointerToInBox()->push_back(currentAgent->getMessage());
+            (*group)[i]->receive(currentAgent->getMessage());
    }
 }
 
@@ -0,0 +1,58 @@
+/**
+   @class JFOLNSPhase
+
+   @brief Carries out the Large Neighbourhood Search Phase of a JFO Agent.
+
+   The movements of the resolutor phase are small perturbations of the
+   current solution. This phase asks the agent's core for a number of
+   iterations of a large neighbourhood search (see
+   JFOAgent::largeNeighbourhoodMethod) every given number of iterations,
+   so the agents can escape from deep local optima. The rest of the phase
+   is shared with the other periodic phases (see JFOPeriodicPhase).
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef JFOLNSPHASE_H
+#define JFOLNSPHASE_H
+
+#include "JFOPeriodicPhase.h"
+
+class JFOLNSPhase : public JFOPeriodicPhase
+{
+   private:
+      /**
+         Number of iterations of the large neighbourhood search per call.
+      */
+      unsigned iterations;
+
+   protected:
+      /**
+         Method that runs the large neighbourhood search on the current solution.
+      */
+      bool change(JFOAgent* superFrog, multiObjectiveSolution* xi)
+      {
+         return (this->iterations > 0 && superFrog->largeNeighbourhoodMethod(xi, this->iterations));
+      }
+
+   public:
+      /**
+         Constructor.
+         @param const unsigned is the number of iterations of the system between two searches.
+         @param const unsigned is the number of iterations of the search per call.
+      */
+      JFOLNSPhase(const unsigned frequency = 1, const unsigned iterations = 25) : JFOPeriodicPhase(frequency), iterations(iterations) { };
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~JFOLNSPhase() { };
+
+      /**
+         Method that returns the number of times the current solution
+         was improved (statistical purposes).
+      */
+      unsigned getNumberOfImprovements() const { return getNumberOfChanges(); }
+};
+
+#endif
@@ -0,0 +1,154 @@
+/**
+   @class JFOPeriodicPhase
+
+   @brief Skeleton of the phases of a JFO Agent that change the current
+   solution every given number of iterations.
+
+   Every given number of iterations, this class asks the derived class to
+   change the current solution (see the method change). If the solution
+   changes, it is evaluated and archived, and the best solution of the swarm
+   is updated as it is done in the resolutor phase. The derived classes
+   only say how the solution is changed, so, like the resolutor phase, this
+   class does not depend on the problem.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef JFOPERIODICPHASE_H
+#define JFOPERIODICPHASE_H
+
+#include <iostream>
+#include <vector>
+
+#include "../../../core/agent.h"
+#include "../../../core/checkpoint.h"
+#include "../../../core/phase.h"
+
+#include "../../../libs/conversions.h"
+
+#include "../JFOAgent.h"
+
+class JFOPeriodicPhase : public phase
+{
+   private:
+      /**
+         Number of iterations of the system between two changes.
+      */
+      unsigned frequency;
+
+      /**
+         This counter enumerates how many times this phase has
+         been triggered.
+      */
+      unsigned numberOfIterations;
+
+      /**
+         Variable for statistical purposes. Number of times the
+         current solution was changed.
+      */
+      unsigned numberOfChanges;
+
+   protected:
+      /**
+         Method that implements initialization steps.
+         In this case, it does nothing.
+      */
+      void prePhase(agent*, std::vector<agent*>*) { };
+
+      /**
+         Method that changes the current solution when it is time
+         to and updates the best solution found.
+      */
+      void core(agent*, std::vector<agent*>*);
+
+      /**
+         Method that perform update operations.
+      */
+      void postPhase(agent*, std::vector<agent*>*);
+
+      /**
+         Method that changes the current solution.
+         @param JFOAgent* is the core of the agent.
+         @param multiObjectiveSolution* is the current solution.
+         @return true if the solution was changed.
+      */
+      virtual bool change(JFOAgent*, multiObjectiveSolution*) = 0;
+
+      unsigned getNumberOfChanges() const { return this->numberOfChanges; }
+
+   public:
+      /**
+         Constructor.
+         @param const unsigned is the number of iterations of the system between two changes.
+      */
+      JFOPeriodicPhase(const unsigned = 1);
+
+      /**
+         Default destructor. It does nothing.
+      */
+      virtual ~JFOPeriodicPhase() { };
+
+      /**
+         Method that writes the counters of the phase into a checkpoint.
+      */
+      void saveState(stateStream&) const;
+
+      /**
+         Method that reads the counters written by saveState.
+      */
+      bool loadState(stateStream&);
+};
+
+JFOPeriodicPhase::JFOPeriodicPhase(const unsigned frequency)
+{
+   this->frequency = (frequency == 0) ? 1 : frequency;
+   this->numberOfIterations = 0;
+   this->numberOfChanges = 0;
+}
+
+void JFOPeriodicPhase::core(agent* currentAgent, std::vector<agent*>* team)
+{
+   if (this->numberOfIterations % this->frequency != 0)
+      return;
+
+   JFOAgent* superFrog = static_cast<JFOAgent*>(currentAgent->getCore());
+   const multiObjectiveProblem* const MOP = superFrog->getProblem();
+
+   multiObjectiveSolution* xi = superFrog->getCurrentSolution();
+   multiObjectiveSolution* g  = superFrog->getBestSolution();
+
+   if (!change(superFrog, xi))
+      return;
+
+   this->numberOfChanges++;
+   MOP->evaluate(xi);
+   superFrog->archiveSolution(xi);
+
+   superFrog->lockBestSolution();
+   if (MOP->firstSolutionIsBetter(xi, g, "reset").isTrue())
+   {
+      superFrog->updateBestSolution(xi);
+      std::cout << (somethingToString(this->numberOfIterations) + " " + g->toString() + "\n") << std::flush;
+   }
+   superFrog->unlockBestSolution();
+}
+
+void JFOPeriodicPhase::postPhase(agent* currentAgent, std::vector<agent*>* team)
+{
+   this->numberOfIterations++;
+}
+
+inline void JFOPeriodicPhase::saveState(stateStream& state) const
+{
+   state.write(this->numberOfIterations);
+   state.write(this->numberOfChanges);
+}
+
+inline bool JFOPeriodicPhase::loadState(stateStream& state)
+{
+   state.read(this->numberOfIterations);
+   state.read(this->numberOfChanges);
+   return state.good();
+}
+
+#endif
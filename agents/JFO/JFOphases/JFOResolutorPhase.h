@@ -17,14 +17,18 @@
 #ifndef JFORESOLUTORPHASE_H
 #define JFORESOLUTORPHASE_H
 
+#include <deque>
 #include <iostream>
 #include <vector>
 #include <string>
 
 #include "../../../core/agent.h"
+#include "../../../core/checkpoint.h"
 #include "../../../core/codeaParameters.h"
 #include "../../../core/header.h"
+#include "../../../core/nonDominatedSorting.h"
 #include "../../../core/phase.h"
+#include "../../../core/solutionSnapshot.h"
 
 #include "../../../core/MOScoreCriterionTypes/basicParetoFrontMOScoreCriterion.h"
 #include "../../../core/MOScoreCriterionTypes/lexicographicMOScoreCriterion.h"
@@ -32,10 +36,11 @@
 
 #include "../../../misc/MersenneTwister.h"
 
-#include "../../../libs/fileLock.h"
 #include "../../../libs/funcLibrary.h"
+#include "../../../libs/conversions.h"
 
 #include "../JFOAgent.h"
+#include "../JFOOperatorSelection.h"
 
 
 class JFOResolutorPhase : public phase
@@ -45,9 +50,10 @@ class JFOResolutorPhase : public phase
       /**
          Solution is going to act as the attractor. This is used to 
          be assigned with the best of the neighborhood depending on
-         the received messages.
+         the received messages. It is a snapshot (see solutionSnapshot), so it
+         stays valid even if the mailbox is cleared.
       */
-      multiObjectiveSolution* attractor;
+      solutionSnapshot attractor;
 
       /**
          JFOParameters. Pointers to the parameters described in the
@@ -83,6 +89,17 @@ class JFOResolutorPhase : public phase
 
       unsigned maxTimeWindowViolations;
 
+      /**
+         If true, c1-c4 are set after every movement by the adaptive
+         operator selection. Otherwise they are left as they are.
+      */
+      bool adaptiveSelection;
+
+      /**
+         Adaptive operator selection of the movements.
+      */
+      JFOOperatorSelection selection;
+
    protected:
       /**
          Method tha implements operations related to initialization.
@@ -110,7 +127,7 @@ class JFOResolutorPhase : public phase
          @returns the solution that is going to act as
          the attractor.
       */
-      multiObjectiveSolution* getAttractorFromInBox(agent*);
+      const multiObjectiveSolution* getAttractorFromInBox(agent*);
 
    public:
       /**
@@ -133,22 +150,35 @@ class JFOResolutorPhase : public phase
       */
       ~JFOResolutorPhase() { };
 
+      void setAdaptiveSelection(const bool adaptiveSelection) { this->adaptiveSelection = adaptiveSelection; }
+      const JFOOperatorSelection& getOperatorSelection() const { return this->selection; }
+
+      /**
+         Method that writes the counters and the adaptive operator selection into
+         a checkpoint. The attractor only lives within an iteration, so it is not
+         written.
+      */
+      void saveState(stateStream&) const;
+
+      /**
+         Method that reads the state written by saveState.
+      */
+      bool loadState(stateStream&);
 };
 
 JFOResolutorPhase::JFOResolutorPhase() 
 { 
-   attractor = NULL;
    movementScore.resize(4, 0);
    movementTry.resize(4, 0);
    this->numberOfIterations = 0;
    this->ownScore = 0;
    
    this->maxTimeWindowViolations = 100;
+   this->adaptiveSelection = false;
 }
 
 JFOResolutorPhase::JFOResolutorPhase(JFOParameters* c1, JFOParameters* c2, JFOParameters* c3, JFOParameters* c4)
 {
-   attractor = NULL;
    movementScore.resize(4, 0);
    movementTry.resize(4, 0);
    this->c1 = c1;
@@ -158,6 +188,7 @@ JFOResolutorPhase::JFOResolutorPhase(JFOParameters* c1, JFOParameters* c2, JFOPa
    this->numberOfIterations = 0;
    this->ownScore = 0;
    this->maxTimeWindowViolations = 100;
+   this->adaptiveSelection = false;
 }
 
 // Sub-Phases
@@ -168,21 +199,26 @@ void JFOResolutorPhase::prePhase(agent* currentAgent, std::vector<agent*>* team)
    assert(superFrog->getCurrentSolution() != NULL);
 
    // First iteration: This condition should not happen after this iteration
+   superFrog->lockBestSolution();
    if (superFrog->getBestSolution()->getNumberOfObjectives() == 0)
       superFrog->updateBestSolution(superFrog->getCurrentSolution());
+   superFrog->unlockBestSolution();
 
    if (superFrog->getBestOwnSolution() == NULL)
       superFrog->setBestOwnSolution(superFrog->getCurrentSolution());
 }
 
 
-multiObjectiveSolution* JFOResolutorPhase::getAttractorFromInBox(agent* currentAgent)
+const multiObjectiveSolution* JFOResolutorPhase::getAttractorFromInBox(agent* currentAgent)
 {
    codeaParameters* neuralItem = codeaParameters::instance();
    // We'll loop over the mailbox looking for a solution to mix our current one with.
 
-   // In case the mailBox is empty, we will rapidly exit
-   if (currentAgent->getInBox().size() == 0)
+   // Other agents may go on sending messages, so we work on a copy of the mailbox
+   const std::deque<message> inBox = currentAgent->getInBox();
+
+   // In case the mailBox is empty, we will rapidly exit
+   if (inBox.size() == 0)
       return NULL;
 
    const multiObjectiveProblem* const MOP = currentAgent->getCore()->getProblem();
@@ -191,8 +227,8 @@ multiObjectiveSolution* JFOResolutorPhase::getAttractorFromInBox(agent* currentA
    // Criterion to rank the solution from the inbox
 
    // Reseting parameters
-   multiObjectiveSolution* incomingSolution = NULL;
-   this->attractor = NULL;
+   solutionSnapshot incomingSolution;
+   this->attractor.reset();
 
 
    abstractMOScoreCriterion* scoreCriterion; 
@@ -202,11 +238,11 @@ multiObjectiveSolution* JFOResolutorPhase::getAttractorFromInBox(agent* currentA
       //std::cout << "Pareto" << std::endl;
       basicParetoFrontMOScoreCriterion scoreCriterion;
 
-      for (size_t i = 0; i < currentAgent->getInBox().size(); i++)
+      for (size_t i = 0; i < inBox.size(); i++)
       {
-         incomingSolution = boost::any_cast<multiObjectiveSolution*> ((currentAgent->getInBox())[i][1].getObject());
+         incomingSolution = boost::any_cast<solutionSnapshot> (inBox[i][1].getObject());
 
-         if (this->attractor == NULL || (scoreCriterion.firstSolutionIsBetter(incomingSolution, this->attractor, MOP->getProblems()).isTrue()), "kkj")
+         if (this->attractor.isEmpty() || (scoreCriterion.firstSolutionIsBetter(incomingSolution.get(), this->attractor.get(), MOP->getProblems()).isTrue()), "kkj")
             this->attractor = incomingSolution;
       }
 
@@ -216,11 +252,11 @@ multiObjectiveSolution* JFOResolutorPhase::getAttractorFromInBox(agent* currentA
       //std::cout << "Lex" << std::endl;
       lexicographicMOScoreCriterion scoreCriterion;   
 
-      for (size_t i = 0; i < currentAgent->getInBox().size(); i++)
+      for (size_t i = 0; i < inBox.size(); i++)
       {
-         incomingSolution = boost::any_cast<multiObjectiveSolution*> ((currentAgent->getInBox())[i][1].getObject());
+         incomingSolution = boost::any_cast<solutionSnapshot> (inBox[i][1].getObject());
 
-         if (this->attractor == NULL || (scoreCriterion.firstSolutionIsBetter(incomingSolution, this->attractor, MOP->getProblems()).isTrue()), "kkj")
+         if (this->attractor.isEmpty() || (scoreCriterion.firstSolutionIsBetter(incomingSolution.get(), this->attractor.get(), MOP->getProblems()).isTrue()), "kkj")
             this->attractor = incomingSolution;
       }
 
@@ -230,15 +266,29 @@ multiObjectiveSolution* JFOResolutorPhase::getAttractorFromInBox(agent* currentA
       //std::cout << "Dynlex " << std::endl;
       dynamicLexMOScoreCriterion scoreCriterion(superFrog->getCurrentSolution()->getNumberOfObjectives());
 
-      for (size_t i = 0; i < currentAgent->getInBox().size(); i++)
+      for (size_t i = 0; i < inBox.size(); i++)
       {
-         incomingSolution = boost::any_cast<multiObjectiveSolution*> ((currentAgent->getInBox())[i][1].getObject());
+         incomingSolution = boost::any_cast<solutionSnapshot> (inBox[i][1].getObject());
 
-         if (this->attractor == NULL || (scoreCriterion.firstSolutionIsBetter(incomingSolution, this->attractor, MOP->getProblems()).isTrue()), "kkj")
+         if (this->attractor.isEmpty() || (scoreCriterion.firstSolutionIsBetter(incomingSolution.get(), this->attractor.get(), MOP->getProblems()).isTrue()), "kkj")
             this->attractor = incomingSolution;
       }
 
    }
+   else if (neuralItem->rankingScheme == 3) // Non-dominated sorting
+   {
+      // The attractor is the least crowded solution of the first front of the inbox
+      nonDominatedSorting sorting(MOP->getProblems());
+      std::vector<solutionSnapshot> incomingSolutions;
+      std::vector<const multiObjectiveSolution*> candidates;
+
+      for (size_t i = 0; i < inBox.size(); i++)
+      {
+         incomingSolutions.push_back(boost::any_cast<solutionSnapshot> (inBox[i][1].getObject()));
+         candidates.push_back(incomingSolutions.back().get());
+      }
+      this->attractor = incomingSolutions[sorting.best(candidates)];
+   }
    else
    {
       std::cout << "Ranking scheme not known" << std::endl;
@@ -248,7 +298,7 @@ multiObjectiveSolution* JFOResolutorPhase::getAttractorFromInBox(agent* currentA
 
 
  
-   return this->attractor;
+   return this->attractor.get();
 }
 
 void JFOResolutorPhase::core(agent* currentAgent, std::vector<agent*>* team)
@@ -259,7 +309,14 @@ void JFOResolutorPhase::core(agent* currentAgent, std::vector<agent*>* team)
    codeaParameters* neuralItem = codeaParameters::instance();
    double randomNumber = neuralItem->getRandomNumber()->rand();
    unsigned movementType = -1;
+   // The movement drawn is credited with the outcome even if the inertial one is carried
+   //    out instead (its attractor is not available), so its payoff reflects that
+   unsigned drawnMovement = 0;
    std::string target = "";
+
+   // Payoff of the movement: the time it takes and the improvements it achieves
+   double startTime = JFOOperatorSelection::threadCPUTime();
+   double reward = 0;
 
    // Current Position
    multiObjectiveSolution* xi = superFrog->getCurrentSolution();
@@ -268,7 +325,7 @@ void JFOResolutorPhase::core(agent* currentAgent, std::vector<agent*>* team)
    // Best Position found by the swarm
    multiObjectiveSolution* g  = superFrog->getBestSolution();
    // Best Position found by its neighborhood in the current interation
-   multiObjectiveSolution* gi = NULL;
+   const multiObjectiveSolution* gi = NULL;
 
    //if (currentAgent->getId() == 0)
    //   std::cout << this->numberOfIterations << g->toString() << std::endl;
@@ -285,6 +342,7 @@ void JFOResolutorPhase::core(agent* currentAgent, std::vector<agent*>* team)
    }
    else if (isInside(randomNumber, *c1, *c1 + *c2)) // cognitive
    {
+      drawnMovement = 1;
       gi = JFOResolutorPhase::getAttractorFromInBox(currentAgent);
 
       if (gi != NULL && gi != bi)
@@ -302,6 +360,7 @@ void JFOResolutorPhase::core(agent* currentAgent, std::vector<agent*>* team)
    }
    else if (isInside(randomNumber, *c1 + *c2, *c1 + *c2 + *c3)) // local
    {
+      drawnMovement = 2;
       if (bi != xi)
       {
          superFrog->localMovement(xi, bi, ni);
@@ -317,9 +376,12 @@ void JFOResolutorPhase::core(agent* currentAgent, std::vector<agent*>* team)
    }
    else if (isInside(randomNumber, *c1 + *c2 + *c3, 1.0)) // social
    {
+      drawnMovement = 3;
       if (g != xi)
       {
-         superFrog->socialMovement(xi, g, ni);
+         // The best solution may be changed by other threads while it is followed
+         const solutionSnapshot best = superFrog->getBestSolutionSnapshot();
+         superFrog->socialMovement(xi, best.get(), ni);
          movementType = 3;
          movementTry[movementType] += 1;
       }
@@ -339,10 +401,13 @@ void JFOResolutorPhase::core(agent* currentAgent, std::vector<agent*>* team)
    //std::cout << "---------" << std::endl;
    superFrog->getProblem()->evaluate(ni);
    superFrog->setCurrentSolution(ni);
+   superFrog->archiveSolution(ni);
+   double elapsedTime = JFOOperatorSelection::threadCPUTime() - startTime;
    
    if (MOP->firstSolutionIsBetter(ni, bi, "reset").isTrue())
    {
       movementScore[movementType] += 1;
+      reward += 1;
 
       superFrog->setBestOwnSolution(ni);
       this->ownScore++;
@@ -351,18 +416,15 @@ void JFOResolutorPhase::core(agent* currentAgent, std::vector<agent*>* team)
 
       // lexicographicMOScoreCriterion lx;
 
+   superFrog->lockBestSolution();
    if ((MOP->firstSolutionIsBetter(ni, g, "reset").isTrue()))
    {
          this->ownScore++;		
          superFrog->updateBestSolution(ni);
          movementScore[movementType] += 1;
+         reward += 1;
          
 
-         // This is for showing results in real time
-         //std::string outPutFile = "./outputs/test.out";
-         //if (!tryWRString(ni->toString(), outPutFile))
-         //   std::cout << "Error Writing : " << outPutFile << std::endl;
-
          //std::cout << this->numberOfIterations << " " << g->toString() << std::endl;
 
          // Let's output something
@@ -370,20 +432,50 @@ void JFOResolutorPhase::core(agent* currentAgent, std::vector<agent*>* team)
          // std::cout << "Tries: " << movementTry << std::endl;
          // std::cout << g->toString() << std::endl;
                      
-         std::cout << this->numberOfIterations << " " << g->toString() << std::endl;
+         // Lines are written at once, so those of agents running in parallel are not mixed up
+         std::cout << (somethingToString(this->numberOfIterations) + " " + g->toString() + "\n") << std::flush;
+   }
+   superFrog->unlockBestSolution();
+
+   // Statistical purposes
+   std::cout << (somethingToString(this->numberOfIterations) + " " + ni->toString() + "\n") << std::flush;
+
+   if (this->adaptiveSelection)
+   {
+      this->selection.update(drawnMovement, reward, elapsedTime);
+      this->selection.setParameters(c1, c2, c3, c4);
    }
-   // Statistical purposes
-   std::cout << this->numberOfIterations << " " << ni->toString() << std::endl;
    
 }
 
 void JFOResolutorPhase::postPhase(agent* currentAgent, std::vector<agent*>* team)
 {
-   // If you clear the mailBox before, you may get a Segmentation Fault because 
-   //    the attractor would be pointing to nowhere.
-   currentAgent->getPointerToInBox()->clear();
+   // The messages hold snapshots, so the attractor is still valid after this
+   currentAgent->clearInBox();
    this->numberOfIterations++;
 }
 
 
+inline void JFOResolutorPhase::saveState(stateStream& state) const
+{
+   state.writeVector(this->movementScore);
+   state.writeVector(this->movementTry);
+   state.write(this->ownScore);
+   state.write(this->numberOfIterations);
+   state.write(this->maxTimeWindowViolations);
+   this->selection.saveState(state);
+}
+
+inline bool JFOResolutorPhase::loadState(stateStream& state)
+{
+   state.readVector(this->movementScore);
+   state.readVector(this->movementTry);
+   state.read(this->ownScore);
+   state.read(this->numberOfIterations);
+   state.read(this->maxTimeWindowViolations);
+   if (this->movementScore.size() != 4 || this->movementTry.size() != 4)
+      state.fail();
+   return this->selection.loadState(state) && state.good();
+}
+
 #endif
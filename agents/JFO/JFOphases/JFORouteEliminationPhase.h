@@ -0,0 +1,46 @@
+/**
+   @class JFORouteEliminationPhase
+
+   @brief Carries out the Route Elimination Phase of a JFO Agent.
+
+   This class asks the agent's core to reduce the current solution (see
+   JFOAgent::routeEliminationMethod) every given number of iterations. The
+   rest of the phase is shared with the other periodic phases (see
+   JFOPeriodicPhase).
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef JFOROUTEELIMINATIONPHASE_H
+#define JFOROUTEELIMINATIONPHASE_H
+
+#include "JFOPeriodicPhase.h"
+
+class JFORouteEliminationPhase : public JFOPeriodicPhase
+{
+   protected:
+      /**
+         Method that reduces the current solution.
+      */
+      bool change(JFOAgent* superFrog, multiObjectiveSolution* xi) { return superFrog->routeEliminationMethod(xi); }
+
+   public:
+      /**
+         Constructor.
+         @param const unsigned is the number of iterations between two eliminations.
+      */
+      JFORouteEliminationPhase(const unsigned frequency = 1) : JFOPeriodicPhase(frequency) { };
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~JFORouteEliminationPhase() { };
+
+      /**
+         Method that returns the number of times the current solution
+         was reduced (statistical purposes).
+      */
+      unsigned getNumberOfEliminations() const { return getNumberOfChanges(); }
+};
+
+#endif
@@ -1 +1 @@
-g++ -I./libs/ -ansi -pedantic -O2 -march=nocona CODEA2.cpp -o CODEA2
+g++ -I./libs/ -ansi -pedantic -O2 -march=nocona CODEA2.cpp -o CODEA2 -lpthread -lrt
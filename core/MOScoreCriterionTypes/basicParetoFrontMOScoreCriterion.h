@@ -61,8 +61,8 @@ class basicParetoFrontMOScoreCriterion : public abstractMOScoreCriterion
                                     const string options) const;
 
 
-      triBool firstSolutionIsBetter(const objectivesType&, 
-                                    const objectivesType&, 
+      triBool firstSolutionIsBetter(const objectivesViewType, 
+                                    const objectivesViewType, 
                                     const problemsType&,
                                     std::string options = " ") const;
 }; 
@@ -139,8 +139,8 @@ inline  triBool basicParetoFrontMOScoreCriterion::
 }
 
 inline  triBool basicParetoFrontMOScoreCriterion::
-        firstSolutionIsBetter(const objectivesType& objectives1, 
-                              const objectivesType& objectives2, 
+        firstSolutionIsBetter(const objectivesViewType objectives1, 
+                              const objectivesViewType objectives2, 
                               const problemsType& problems,
                               std::string options) const
 {
@@ -58,8 +58,8 @@ class dynamicLexMOScoreCriterion : public abstractMOScoreCriterion
                                     const problemsType&,
                                     std::string options = " ") const;
 
-      triBool firstSolutionIsBetter(const objectivesType&, 
-                                    const objectivesType&, 
+      triBool firstSolutionIsBetter(const objectivesViewType, 
+                                    const objectivesViewType, 
                                     const problemsType&,
                                     std::string options = " ") const;
 
@@ -170,8 +170,8 @@ inline  triBool dynamicLexMOScoreCriterion::
 }
 
 inline  triBool dynamicLexMOScoreCriterion::
-        firstSolutionIsBetter(const objectivesType& objectives1, 
-                              const objectivesType& objectives2, 
+        firstSolutionIsBetter(const objectivesViewType objectives1, 
+                              const objectivesViewType objectives2, 
                               const problemsType& problems,
                               std::string options) const
 {
@@ -20,6 +20,7 @@
 #include <deque>
 #include <vector>
 
+#include "checkpoint.h"
 #include "container.h"
 #include "core.h"
 #include "header.h" 
@@ -195,6 +196,33 @@ class agent
          @param agent's message.
       */
       void setMessage(const message);
+
+      /** 
+         Method that puts a message in the agent's mailbox. It may be called
+         while the agent is running in another thread.
+         @param a message.
+      */
+      void receive(const message);
+
+      /** 
+         Method that removes all the messages of the agent's mailbox.
+      */
+      void clearInBox();
+
+      /** 
+         Method that writes the state of the agent (its core and its phases) into a
+         checkpoint. Messages are not written: they point to solutions of other agents
+         and they only live within an iteration of the system.
+         @param stateStream& is the stream.
+      */
+      void saveState(stateStream&) const;
+
+      /** 
+         Method that reads the state written by saveState.
+         @param stateStream& is the stream.
+         @return false if the stream failed or it does not match this agent.
+      */
+      bool loadState(stateStream&);
 };
 
 agent::agent()
@@ -303,4 +331,50 @@ void agent::setMessage(const message msg)
    this->msg = msg;
 }
 
+void agent::receive(const message msg)
+{
+   this->inBox.push_back(msg);
+}
+
+void agent::clearInBox()
+{
+   this->inBox.clear();
+}
+
+void agent::saveState(stateStream& state) const
+{
+   state.write(this->id);
+   state.write(this->active);
+   this->agentCore->saveState(state);
+
+   state.write<unsigned>(this->phases.size());
+   for (size_t i = 0; i < this->phases.size(); i++)
+      if (this->phases[i] != NULL)
+         this->phases[i]->saveState(state);
+}
+
+bool agent::loadState(stateStream& state)
+{
+   idAgentType id = 0;
+   unsigned numberOfPhases = 0;
+   if (!state.read(id) || id != this->id)
+   {
+      state.fail();
+      return false;
+   }
+   state.read(this->active);
+   if (!this->agentCore->loadState(state))
+      return false;
+
+   if (!state.read(numberOfPhases) || numberOfPhases != this->phases.size())
+   {
+      state.fail();
+      return false;
+   }
+   for (size_t i = 0; i < this->phases.size(); i++)
+      if (this->phases[i] != NULL && !this->phases[i]->loadState(state))
+         return false;
+   return state.good();
+}
+
 #endif
@@ -0,0 +1,396 @@
+/**
+   @class asynchronousArchitecture
+
+   @brief Invokes agent's phases in parallel, without waiting for each other.
+
+   In coDecentralizedArchitecture every agent runs each phase in turn, so an
+   iteration of the system lasts as long as the slowest agent, and the
+   local search takes very different times depending on how far a solution
+   is from a local optimum. In this system each agent runs its phases over
+   and over at its own pace.
+
+   The agents are run by a pool of threads (one per core by default). Each
+   thread has a queue of agents: it runs one iteration (all the phases) of
+   the first agent and puts it back at the end. A thread whose queue is
+   empty steals the agent that has waited longest from the queue of
+   another thread, so no thread is idle while an agent is waiting, even if
+   there are many more agents than cores. An agent is never run by two
+   threads at the same time.
+
+   The agents share the best solution, which is guarded by a mutex (see
+   core::lockBestSolution), and send each other snapshots of their
+   solutions (see solutionSnapshot) through mailboxes guarded by mutexes.
+   Each agent has its own random number generator. The iteration of the
+   system is the number of iterations run by all the agents divided by the
+   number of agents, so the stop criterion is checked globally and the
+   system does as much work as coDecentralizedArchitecture. The order in
+   which agents interleave depends on the scheduling of the threads, so
+   runs are not reproducible.
+
+   Island migration, checkpoints and the changes of dynamic problems need
+   every agent to be between two iterations, so they are not available in
+   this system.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef ASYNCHRONOUSARCHITECTURE_H
+#define ASYNCHRONOUSARCHITECTURE_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <deque>
+#include <iostream>
+#include <vector>
+
+#include "agent.h"
+#include "coDecentralizedArchitecture.h"
+#include "codeaParameters.h"
+#include "evaluationCache.h"
+#include "phase.h"
+#include "threadPool.h"
+#include "../misc/MersenneTwister.h"
+
+
+class asynchronousArchitecture : public coDecentralizedArchitecture
+{
+   private:
+      /**
+         Queue of agents of a thread (positions in the vector of agents) and
+         the mutex that guards it.
+      */
+      struct workQueue
+      {
+         std::deque<unsigned> agents;
+         pthread_mutex_t lock;
+      };
+
+      /**
+         Argument of a thread of the pool.
+      */
+      struct worker
+      {
+         asynchronousArchitecture* system;
+         unsigned id;
+      };
+
+      /**
+         Number of threads of the pool (0 means one per core).
+      */
+      unsigned numberOfThreads;
+
+      /**
+         Queues of the threads.
+      */
+      std::vector<workQueue*> queues;
+
+      /**
+         Random number generator of each agent.
+      */
+      std::vector<MTRand*> randomNumbers;
+
+      /**
+         Mutex that guards the best solution shared by the agents.
+      */
+      pthread_mutex_t bestSolutionLock;
+
+      /**
+         Mutex that guards the counter of iterations and the stop criterion.
+      */
+      pthread_mutex_t iterationLock;
+
+      /**
+         Number of iterations run by all the agents.
+      */
+      unsigned long numberOfAgentIterations;
+
+      /**
+         True when the stop criterion is met.
+      */
+      volatile bool finished;
+
+      /**
+         Variables for statistical purposes: number of agents stolen, wall-clock
+         time and evaluations (look-ups in the cache) since the system started.
+      */
+      unsigned long numberOfSteals;
+      double startTime;
+      unsigned long startEvaluations;
+
+      /**
+         Method that runs in each thread of the pool.
+      */
+      static void* workerThread(void*);
+
+      /**
+         Method that takes an agent from the queue of a thread or, if it is
+         empty, from the queue of another thread.
+         @param const unsigned is the thread.
+         @param unsigned& is where the position of the agent is returned.
+         @return false if every agent is being run.
+      */
+      bool takeAgent(const unsigned, unsigned&);
+
+      /**
+         Method that puts an agent at the end of the queue of a thread.
+      */
+      void giveBackAgent(const unsigned, const unsigned);
+
+      /**
+         Method that runs an iteration (all the phases) of an agent.
+         @param const unsigned is the position of the agent.
+      */
+      void runAgent(const unsigned);
+
+      /**
+         Method that counts an iteration of an agent and checks the stop criterion.
+         @return true if the system has to stop.
+      */
+      bool countIteration();
+
+      /**
+         Method that returns the wall-clock time in seconds.
+      */
+      static double wallTime();
+
+      /**
+         Method that returns the number of evaluations looked up in the cache of
+         the agents (0 if there is no cache).
+      */
+      unsigned long getNumberOfEvaluations();
+
+   protected:
+      /**
+         Method that creates the queues of the threads and the random number
+         generators of the agents, and gives the agents the lock of the best solution.
+      */
+      void preOperationsSystem();
+
+      /**
+         Method that starts the pool of threads and waits until the stop
+         criterion is met.
+      */
+      void phase();
+
+      /**
+         Method that releases the resources of the pool and outputs the throughput.
+      */
+      void postOperationsSystem();
+
+   public:
+      /**
+         Constructor.
+         @param const unsigned is the number of threads (0 means one per core).
+      */
+      asynchronousArchitecture(const unsigned = 0);
+
+      /**
+          Default destructor. It does nothing.
+      */
+      ~asynchronousArchitecture() { };
+
+      unsigned long getNumberOfAgentIterations() const { return this->numberOfAgentIterations; }
+      unsigned long getNumberOfSteals() const { return this->numberOfSteals; }
+};
+
+asynchronousArchitecture::asynchronousArchitecture(const unsigned numberOfThreads)
+{
+   this->numberOfThreads = numberOfThreads;
+   this->numberOfAgentIterations = 0;
+   this->finished = false;
+   this->numberOfSteals = 0;
+   this->startTime = 0;
+   this->startEvaluations = 0;
+}
+
+inline double asynchronousArchitecture::wallTime()
+{
+   struct timespec now;
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+inline unsigned long asynchronousArchitecture::getNumberOfEvaluations()
+{
+   const vector<agent*>& agents = *(getPointerToAgents());
+   evaluationCache* cache = agents.empty() ? NULL : agents[0]->getCore()->getProblem()->getEvaluationCache();
+   return (cache == NULL) ? 0 : cache->getHits() + cache->getMisses();
+}
+
+void asynchronousArchitecture::preOperationsSystem()
+{
+   const vector<agent*>& agents = *(getPointerToAgents());
+   assert(!agents.empty());
+
+   // There is no point in having more threads than agents
+   unsigned threads = (this->numberOfThreads == 0) ? threadPool::getNumberOfCores() : this->numberOfThreads;
+   if (threads > agents.size())
+      threads = agents.size();
+
+   pthread_mutex_init(&(this->bestSolutionLock), NULL);
+   pthread_mutex_init(&(this->iterationLock), NULL);
+
+   // The generators of the agents are seeded from the shared one, so a run
+   //   depends on the seed (although the interleaving of the agents does not)
+   MTRand* randomNumber = codeaParameters::instance()->getRandomNumber();
+   for (size_t i = 0; i < agents.size(); i++)
+   {
+      agents[i]->getCore()->setBestSolutionLock(&(this->bestSolutionLock));
+      this->randomNumbers.push_back((randomNumber != NULL) ? new MTRand(randomNumber->randInt()) : new MTRand());
+   }
+
+   for (unsigned i = 0; i < threads; i++)
+   {
+      this->queues.push_back(new workQueue);
+      pthread_mutex_init(&(this->queues[i]->lock), NULL);
+   }
+   for (size_t i = 0; i < agents.size(); i++)
+      this->queues[i % threads]->agents.push_back(i);
+
+   this->numberOfAgentIterations = (unsigned long)getIteration() * agents.size();
+   this->numberOfSteals = 0;
+   this->startTime = wallTime();
+   this->startEvaluations = getNumberOfEvaluations();
+}
+
+void asynchronousArchitecture::phase()
+{
+   std::vector<pthread_t> threads(this->queues.size());
+   std::vector<worker> workers(this->queues.size());
+
+   this->finished = false;
+   for (size_t i = 0; i < threads.size(); i++)
+   {
+      workers[i].system = this;
+      workers[i].id = i;
+      if (pthread_create(&(threads[i]), NULL, workerThread, &(workers[i])) != 0)
+      {
+         std::cout << "ERROR[!] Cannot start the threads of the agents" << std::endl;
+         exit(1);
+      }
+   }
+   for (size_t i = 0; i < threads.size(); i++)
+      pthread_join(threads[i], NULL);
+}
+
+void asynchronousArchitecture::postOperationsSystem()
+{
+   const vector<agent*>& agents = *(getPointerToAgents());
+   const double elapsedTime = wallTime() - this->startTime;
+   const unsigned long evaluations = getNumberOfEvaluations() - this->startEvaluations;
+
+   for (size_t i = 0; i < agents.size(); i++)
+   {
+      agents[i]->getCore()->setBestSolutionLock(NULL);
+      delete(this->randomNumbers[i]);
+   }
+   this->randomNumbers.clear();
+
+   for (size_t i = 0; i < this->queues.size(); i++)
+   {
+      pthread_mutex_destroy(&(this->queues[i]->lock));
+      delete(this->queues[i]);
+   }
+   const size_t threads = this->queues.size();
+   this->queues.clear();
+
+   pthread_mutex_destroy(&(this->iterationLock));
+   pthread_mutex_destroy(&(this->bestSolutionLock));
+
+   std::cerr << "Asynchronous: " << this->numberOfAgentIterations << " agent iterations in " << elapsedTime
+             << " s with " << threads << " threads (" << this->numberOfSteals << " agents stolen)";
+   if (elapsedTime > 0)
+      std::cerr << ", " << evaluations / elapsedTime << " evaluations/s";
+   std::cerr << std::endl;
+}
+
+void* asynchronousArchitecture::workerThread(void* argument)
+{
+   worker* self = static_cast<worker*>(argument);
+   asynchronousArchitecture* system = self->system;
+   unsigned position;
+
+   while (!system->finished)
+   {
+      // Every agent is being run by another thread
+      if (!system->takeAgent(self->id, position))
+      {
+         sched_yield();
+         continue;
+      }
+      system->runAgent(position);
+      system->giveBackAgent(self->id, position);
+      if (system->countIteration())
+         break;
+   }
+   return NULL;
+}
+
+inline bool asynchronousArchitecture::takeAgent(const unsigned thread, unsigned& position)
+{
+   workQueue* queue = this->queues[thread];
+   pthread_mutex_lock(&(queue->lock));
+   if (!queue->agents.empty())
+   {
+      position = queue->agents.front();
+      queue->agents.pop_front();
+      pthread_mutex_unlock(&(queue->lock));
+      return true;
+   }
+   pthread_mutex_unlock(&(queue->lock));
+
+   // The queues of the other threads are looked up starting by the next one
+   for (size_t i = 1; i < this->queues.size(); i++)
+   {
+      workQueue* victim = this->queues[(thread + i) % this->queues.size()];
+      pthread_mutex_lock(&(victim->lock));
+      if (!victim->agents.empty())
+      {
+         position = victim->agents.front();
+         victim->agents.pop_front();
+         pthread_mutex_unlock(&(victim->lock));
+         __sync_fetch_and_add(&(this->numberOfSteals), 1);
+         return true;
+      }
+      pthread_mutex_unlock(&(victim->lock));
+   }
+   return false;
+}
+
+inline void asynchronousArchitecture::giveBackAgent(const unsigned thread, const unsigned position)
+{
+   workQueue* queue = this->queues[thread];
+   pthread_mutex_lock(&(queue->lock));
+   queue->agents.push_back(position);
+   pthread_mutex_unlock(&(queue->lock));
+}
+
+inline void asynchronousArchitecture::runAgent(const unsigned position)
+{
+   agent* currentAgent = (*getPointerToAgents())[position];
+   const vector<class phase*> phases = currentAgent->getPhases();
+
+   codeaParameters::setThreadRandomNumber(this->randomNumbers[position]);
+   for (size_t j = 0; j < getNumberOfPhases() && j < phases.size(); j++)
+   {
+      if (phases[j] != NULL)
+         phases[j]->start(currentAgent, getPointerToAgents());
+   }
+   codeaParameters::setThreadRandomNumber(NULL);
+}
+
+inline bool asynchronousArchitecture::countIteration()
+{
+   pthread_mutex_lock(&(this->iterationLock));
+   this->numberOfAgentIterations++;
+   setIteration(this->numberOfAgentIterations / getPointerToAgents()->size());
+   if (getStopCriterion()->stop(this))
+      this->finished = true;
+   const bool stop = this->finished;
+   pthread_mutex_unlock(&(this->iterationLock));
+   return stop;
+}
+
+#endif
@@ -0,0 +1,418 @@
+/**
+   @class stateStream
+
+   @brief Binary buffer where the state of the system is written to and read from.
+
+   Every class that has something to keep between two iterations writes it
+   with saveState and reads it back, in the same order, with loadState.
+   Values are stored as raw bytes, so a checkpoint can only be read by the
+   same build on the same kind of machine. A read beyond the end of the
+   buffer does not change the value and marks the stream as failed.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+/**
+   @class checkpoint
+
+   @brief Writes the state of the system to a file every given number of iterations.
+
+   The state is written into a stateStream by the thread that runs the
+   system (it takes a few milliseconds) and the stream is handed over to a
+   writer thread that saves it to disk, so the system does not wait for
+   the disk. If a new stream arrives before the previous one is saved, the
+   previous one is discarded.
+
+   The file is written to a temporary file that is renamed when it is
+   complete, so a crash never leaves a half-written checkpoint. The file has
+   a header (magic number, version, size and a FNV-1a checksum of the
+   content) that is checked when it is read.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "header.h"
+
+/**
+   Version of the format of the checkpoints.
+*/
+#define CHECKPOINTVERSION 3
+
+class stateStream
+{
+   private:
+      /**
+         Content of the stream.
+      */
+      std::vector<char> data;
+
+      /**
+         Position of the next read.
+      */
+      size_t position;
+
+      /**
+         True if a read went beyond the end of the stream.
+      */
+      bool failed;
+
+   protected:
+
+   public:
+      /**
+         Default constructor. It creates an empty stream.
+      */
+      stateStream() : position(0), failed(false) { };
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~stateStream() { };
+
+      /**
+         Method that writes a value of a plain type.
+      */
+      template <class Type>
+      void write(const Type&);
+
+      /**
+         Method that reads a value of a plain type.
+         @return false if the stream has failed.
+      */
+      template <class Type>
+      bool read(Type&);
+
+      /**
+         Method that writes a vector of a plain type with its size.
+      */
+      template <class Type>
+      void writeVector(const std::vector<Type>&);
+
+      /**
+         Method that reads a vector of a plain type written by writeVector.
+         @return false if the stream has failed.
+      */
+      template <class Type>
+      bool readVector(std::vector<Type>&);
+
+      /**
+         Method that returns whether every read so far was right.
+      */
+      bool good() const { return !this->failed; }
+
+      /**
+         Method that returns whether everything written into the stream has been read.
+      */
+      bool atEnd() const { return this->position >= this->data.size(); }
+
+      /**
+         Method that marks the stream as failed. It is used when a value
+         read does not match the system it is loaded into.
+      */
+      void fail() { this->failed = true; }
+
+      std::vector<char>& getData() { return this->data; }
+      const std::vector<char>& getData() const { return this->data; }
+};
+
+class checkpoint
+{
+   private:
+      /**
+         Name of the file.
+      */
+      std::string fileName;
+
+      /**
+         Number of iterations between two checkpoints.
+      */
+      unsigned interval;
+
+      /**
+         Stream waiting to be saved and whether there is one.
+      */
+      std::vector<char> pending;
+      bool isPending;
+
+      /**
+         True when the writer thread has to finish.
+      */
+      bool finished;
+
+      /**
+         Writer thread and its synchronization.
+      */
+      pthread_t writer;
+      pthread_mutex_t mutex;
+      pthread_cond_t condition;
+
+      /**
+         Variables for statistical purposes.
+      */
+      unsigned numberOfCheckpoints, numberOfDiscarded;
+
+      /**
+         Method that runs in the writer thread.
+      */
+      static void* writerThread(void*);
+
+      /**
+         Method that saves a stream to the file.
+         @return true if the file was written.
+      */
+      bool save(const std::vector<char>&) const;
+
+   protected:
+
+   public:
+      /**
+         Constructor. It starts the writer thread.
+         @param const std::string& is the name of the file.
+         @param const unsigned is the number of iterations between two checkpoints.
+      */
+      checkpoint(const std::string&, const unsigned);
+
+      /**
+         Destructor. It saves the stream that is waiting, if any, and stops the writer thread.
+      */
+      ~checkpoint();
+
+      /**
+         Method that returns whether a checkpoint has to be written in the given iteration.
+      */
+      bool isDue(const iterationType iteration) const { return (iteration % this->interval == 0); }
+
+      /**
+         Method that hands a stream over to the writer thread. The stream is left empty.
+         @param stateStream& is the stream.
+      */
+      void write(stateStream&);
+
+      /**
+         Method that reads a checkpoint.
+         @param const std::string& is the name of the file.
+         @param stateStream& is where the content is returned.
+         @return true if the file exists and it is a valid checkpoint.
+      */
+      static bool read(const std::string&, stateStream&);
+
+      /**
+         Method that returns the checksum of a buffer (FNV-1a).
+      */
+      static uint64_t checksum(const std::vector<char>&);
+
+      unsigned getNumberOfCheckpoints() const { return this->numberOfCheckpoints; }
+      unsigned getNumberOfDiscarded() const { return this->numberOfDiscarded; }
+};
+
+template <class Type>
+inline void stateStream::write(const Type& value)
+{
+   const char* const bytes = reinterpret_cast<const char*>(&value);
+   this->data.insert(this->data.end(), bytes, bytes + sizeof(Type));
+}
+
+template <class Type>
+inline bool stateStream::read(Type& value)
+{
+   if (this->failed || this->position + sizeof(Type) > this->data.size())
+   {
+      this->failed = true;
+      return false;
+   }
+   memcpy(reinterpret_cast<char*>(&value), &(this->data[this->position]), sizeof(Type));
+   this->position += sizeof(Type);
+   return true;
+}
+
+template <class Type>
+inline void stateStream::writeVector(const std::vector<Type>& values)
+{
+   write<uint64_t>(values.size());
+   if (!values.empty())
+   {
+      const char* const bytes = reinterpret_cast<const char*>(&values[0]);
+      this->data.insert(this->data.end(), bytes, bytes + values.size() * sizeof(Type));
+   }
+}
+
+template <class Type>
+inline bool stateStream::readVector(std::vector<Type>& values)
+{
+   uint64_t size = 0;
+   if (!read(size) || size > (this->data.size() - this->position) / sizeof(Type))
+   {
+      this->failed = true;
+      return false;
+   }
+   values.resize(size);
+   if (size > 0)
+      memcpy(reinterpret_cast<char*>(&values[0]), &(this->data[this->position]), size * sizeof(Type));
+   this->position += size * sizeof(Type);
+   return true;
+}
+
+checkpoint::checkpoint(const std::string& fileName, const unsigned interval)
+{
+   this->fileName = fileName;
+   this->interval = (interval == 0) ? 1 : interval;
+   this->isPending = false;
+   this->finished = false;
+   this->numberOfCheckpoints = 0;
+   this->numberOfDiscarded = 0;
+
+   pthread_mutex_init(&(this->mutex), NULL);
+   pthread_cond_init(&(this->condition), NULL);
+   if (pthread_create(&(this->writer), NULL, writerThread, this) != 0)
+   {
+      std::cout << "ERROR[!] Cannot start the checkpoint writer" << std::endl;
+      exit(1);
+   }
+}
+
+checkpoint::~checkpoint()
+{
+   pthread_mutex_lock(&(this->mutex));
+   this->finished = true;
+   pthread_cond_signal(&(this->condition));
+   pthread_mutex_unlock(&(this->mutex));
+
+   pthread_join(this->writer, NULL);
+   pthread_cond_destroy(&(this->condition));
+   pthread_mutex_destroy(&(this->mutex));
+}
+
+inline void checkpoint::write(stateStream& state)
+{
+   pthread_mutex_lock(&(this->mutex));
+   if (this->isPending)
+      this->numberOfDiscarded++;
+   this->pending.swap(state.getData());
+   this->isPending = true;
+   pthread_cond_signal(&(this->condition));
+   pthread_mutex_unlock(&(this->mutex));
+   state.getData().clear();
+}
+
+void* checkpoint::writerThread(void* argument)
+{
+   checkpoint* self = static_cast<checkpoint*>(argument);
+   std::vector<char> content;
+
+   pthread_mutex_lock(&(self->mutex));
+   while (true)
+   {
+      while (!self->isPending && !self->finished)
+         pthread_cond_wait(&(self->condition), &(self->mutex));
+      if (!self->isPending)
+         break;
+
+      content.swap(self->pending);
+      self->isPending = false;
+      pthread_mutex_unlock(&(self->mutex));
+
+      const bool saved = self->save(content);
+
+      pthread_mutex_lock(&(self->mutex));
+      if (saved)
+         self->numberOfCheckpoints++;
+   }
+   pthread_mutex_unlock(&(self->mutex));
+   return NULL;
+}
+
+bool checkpoint::save(const std::vector<char>& content) const
+{
+   const std::string temporary = this->fileName + ".tmp";
+   FILE* file = fopen(temporary.c_str(), "wb");
+   if (file == NULL)
+   {
+      std::cout << "Error writing checkpoint: " << temporary << std::endl;
+      return false;
+   }
+
+   const char magic[8] = { 'C', 'O', 'D', 'E', 'A', 'C', 'K', 'P' };
+   const uint32_t version = CHECKPOINTVERSION;
+   const uint64_t size = content.size();
+   const uint64_t sum = checksum(content);
+
+   bool written = (fwrite(magic, sizeof(magic), 1, file) == 1 &&
+                   fwrite(&version, sizeof(version), 1, file) == 1 &&
+                   fwrite(&size, sizeof(size), 1, file) == 1 &&
+                   fwrite(&sum, sizeof(sum), 1, file) == 1 &&
+                   (content.empty() || fwrite(&content[0], content.size(), 1, file) == 1));
+   written = (fflush(file) == 0) && written;
+   written = (fsync(fileno(file)) == 0) && written;
+   written = (fclose(file) == 0) && written;
+
+   if (!written || rename(temporary.c_str(), this->fileName.c_str()) != 0)
+   {
+      std::cout << "Error writing checkpoint: " << this->fileName << std::endl;
+      remove(temporary.c_str());
+      return false;
+   }
+   return true;
+}
+
+bool checkpoint::read(const std::string& fileName, stateStream& state)
+{
+   FILE* file = fopen(fileName.c_str(), "rb");
+   if (file == NULL)
+      return false;
+
+   char magic[8];
+   uint32_t version = 0;
+   uint64_t size = 0, sum = 0;
+   bool right = (fread(magic, sizeof(magic), 1, file) == 1 &&
+                 fread(&version, sizeof(version), 1, file) == 1 &&
+                 fread(&size, sizeof(size), 1, file) == 1 &&
+                 fread(&sum, sizeof(sum), 1, file) == 1 &&
+                 memcmp(magic, "CODEACKP", sizeof(magic)) == 0 && version == CHECKPOINTVERSION);
+
+   // The size is checked against the file before allocating anything
+   if (right)
+   {
+      const long start = ftell(file);
+      right = (fseek(file, 0, SEEK_END) == 0) && ((uint64_t)(ftell(file) - start) == size) && (fseek(file, start, SEEK_SET) == 0);
+   }
+
+   std::vector<char>& content = state.getData();
+   if (right)
+   {
+      content.resize(size);
+      right = (size == 0 || fread(&content[0], size, 1, file) == 1) && (checksum(content) == sum);
+   }
+   fclose(file);
+
+   if (!right)
+      content.clear();
+   return right;
+}
+
+inline uint64_t checkpoint::checksum(const std::vector<char>& content)
+{
+   // Offset basis and prime of the 64-bit version (C++98 has no 64-bit literals)
+   const uint64_t prime = (((uint64_t)0x100) << 32) | (uint64_t)0x1B3;
+   uint64_t hash = (((uint64_t)0xCBF29CE4) << 32) | (uint64_t)0x84222325;
+   for (size_t i = 0; i < content.size(); i++)
+   {
+      hash ^= (unsigned char)content[i];
+      hash *= prime;
+   }
+   return hash;
+}
+
+#endif
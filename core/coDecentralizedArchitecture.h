@@ -12,9 +12,15 @@
 #ifndef CODECENTRALIZEDARCHITECTURE_H
 #define CODECENTRALIZEDARCHITECTURE_H
 
-#include "decentralizedSystem.h"
-#include "header.h"
+#include "checkpoint.h"
+#include "codeaParameters.h"
+#include "decentralizedSystem.h"
+#include "evaluationCache.h"
+#include "header.h"
+#include "islandMigration.h"
 #include "multiObjectiveSolution.h"
+#include "paretoArchive.h"
+#include "problemChanges.h"
 #include "../libs/IOlibrary.h"
 
 
@@ -26,6 +32,24 @@ class coDecentralizedArchitecture : public decentralizedSystem
       */
       unsigned numberOfPhases;
 
+      /**
+         Exchange of solutions with other processes (island model). It is NULL
+         if the system runs alone.
+      */
+      islandMigration* migration;
+
+      /**
+         Periodic checkpoints of the state of the system. It is NULL if no
+         checkpoints are written.
+      */
+      checkpoint* checkpointer;
+
+      /**
+         Changes of the problem during the run (dynamic problems). It is NULL if
+         the problem does not change.
+      */
+      problemChanges* changes;
+
    protected:
       /**
          Space to perform operations before the agents start running their phases
@@ -81,6 +105,44 @@ class coDecentralizedArchitecture : public decentralizedSystem
       */
       void setNumberOfPhases(const unsigned);
 
+      /** 
+         Method that sets the exchange of solutions with other islands. After every
+         iteration the system gives the migration a chance to run and, when the system
+         stops, the final solution is handed over to the coordinator.
+         @param islandMigration* is a pointer to the migration (NULL to run alone).
+      */
+      void setMigration(islandMigration*);
+
+      /** 
+         Method that sets the periodic checkpoints of the state of the system.
+         @param checkpoint* is a pointer to the checkpoint writer (NULL to write none).
+      */
+      void setCheckpoint(checkpoint*);
+
+      /** 
+         Method that sets the changes of a dynamic problem. After every iteration,
+         once the migration has run, the system applies the changes that are due.
+         @param problemChanges* is a pointer to the changes (NULL if the problem does not change).
+      */
+      void setProblemChanges(problemChanges*);
+
+      /** 
+         Method that writes the state of the system into a checkpoint: the counters,
+         the random number generator, the best solution, the evaluation cache and
+         every agent. It must be called between two iterations.
+         @param stateStream& is the stream.
+      */
+      void saveState(stateStream&) const;
+
+      /** 
+         Method that reads the state written by saveState, so the system goes on
+         as if it had not stopped. The system must be set up as the one that
+         wrote the checkpoint (same instance, agents and phases).
+         @param stateStream& is the stream.
+         @return false if the stream failed or it does not match the system.
+      */
+      bool loadState(stateStream&);
+
 };
 
 coDecentralizedArchitecture::coDecentralizedArchitecture()
@@ -90,6 +152,9 @@ coDecentralizedArchitecture::coDecentralizedArchitecture()
    this->setIteration(0);
    this->setIterationOfBestSolution(0);
    this->setElapsedTimeOfBestSolution(0);
+   this->migration = NULL;
+   this->checkpointer = NULL;
+   this->changes = NULL;
 }
 
 
@@ -105,6 +170,9 @@ coDecentralizedArchitecture::coDecentralizedArchitecture(const vector<agent*> ag
    this->setElapsedTimeOfBestSolution(0);
    this->setStopCriterion(stopController);
    this->numberOfPhases = numberOfPhases;   
+   this->migration = NULL;
+   this->checkpointer = NULL;
+   this->changes = NULL;
 }
 
 coDecentralizedArchitecture::~coDecentralizedArchitecture()
@@ -131,11 +199,27 @@ inline void coDecentralizedArchitecture::phase()
       }
    }
    this->increaseIteration();
+
+   if (this->migration != NULL)
+      this->migration->migrate(this->getIteration(), getPointerToAgents());
+
+   if (this->changes != NULL)
+      this->changes->apply(this->getIteration(), getPointerToAgents());
+
+   if (this->checkpointer != NULL && this->checkpointer->isDue(this->getIteration()))
+   {
+      stateStream state;
+      saveState(state);
+      this->checkpointer->write(state);
+   }
 }
 
 inline void coDecentralizedArchitecture::postOperationsSystem()
 {
-
+   if (this->migration != NULL)
+      this->migration->finish(getPointerToAgents());
+   if (this->changes != NULL)
+      this->changes->finish(getPointerToAgents());
 }
 
 inline unsigned coDecentralizedArchitecture::getNumberOfPhases()
@@ -146,5 +230,152 @@ inline unsigned coDecentralizedArchitecture::getNumberOfPhases()
 inline void coDecentralizedArchitecture::setNumberOfPhases(const unsigned numberOfPhases)
 {
    this->numberOfPhases = numberOfPhases;
+}
+
+inline void coDecentralizedArchitecture::setMigration(islandMigration* migration)
+{
+   this->migration = migration;
+}
+
+inline void coDecentralizedArchitecture::setCheckpoint(checkpoint* checkpointer)
+{
+   this->checkpointer = checkpointer;
+}
+
+inline void coDecentralizedArchitecture::setProblemChanges(problemChanges* changes)
+{
+   this->changes = changes;
+}
+
+void coDecentralizedArchitecture::saveState(stateStream& state) const
+{
+   coDecentralizedArchitecture* system = const_cast<coDecentralizedArchitecture*>(this);
+   const vector<agent*>& agents = *(system->getPointerToAgents());
+
+   state.write<iterationType>(system->getIteration());
+   state.write<iterationType>(system->getIterationOfBestSolution());
+   state.write<double>(system->getElapsedTimeOfBestSolution());
+
+   MTRand* randomNumber = codeaParameters::instance()->getRandomNumber();
+   state.write<bool>(randomNumber != NULL);
+   if (randomNumber != NULL)
+   {
+      MTRand::uint32 randomState[MTRand::SAVE];
+      randomNumber->save(randomState);
+      for (unsigned i = 0; i < MTRand::SAVE; i++)
+         state.write(randomState[i]);
+   }
+
+   // Best solutions are usually shared, so each one is written only once
+   state.write<unsigned>(agents.size());
+   for (size_t i = 0; i < agents.size(); i++)
+   {
+      size_t owner = 0;
+      while (agents[owner]->getCore()->getBestSolution() != agents[i]->getCore()->getBestSolution())
+         owner++;
+      state.write<unsigned>(owner);
+      if (owner == i)
+         agents[i]->getCore()->getBestSolution()->saveState(state);
+   }
+
+   // The cache of the first agent (it is shared by the swarm)
+   evaluationCache* cache = agents.empty() ? NULL : agents[0]->getCore()->getProblem()->getEvaluationCache();
+   state.write<bool>(cache != NULL);
+   if (cache != NULL)
+      cache->saveState(state);
+
+   // The archive of non-dominated solutions (also shared by the swarm)
+   paretoArchive* archive = agents.empty() ? NULL : agents[0]->getCore()->getArchive();
+   state.write<bool>(archive != NULL);
+   if (archive != NULL)
+      archive->saveState(state);
+
+   // The stop criterion writes into a block of its own, so a different criterion
+   //   is detected when the block is read
+   stateStream criterionState;
+   if (system->getStopCriterion() != NULL)
+      system->getStopCriterion()->saveState(criterionState);
+   state.writeVector(criterionState.getData());
+
+   for (size_t i = 0; i < agents.size(); i++)
+      agents[i]->saveState(state);
+}
+
+bool coDecentralizedArchitecture::loadState(stateStream& state)
+{
+   const vector<agent*>& agents = *(getPointerToAgents());
+   iterationType iteration = 0, iterationOfBestSolution = 0;
+   double elapsedTimeOfBestSolution = 0;
+   bool hasRandomNumber = false, hasCache = false, hasArchive = false;
+   unsigned numberOfAgents = 0;
+
+   state.read(iteration);
+   state.read(iterationOfBestSolution);
+   state.read(elapsedTimeOfBestSolution);
+   this->setIteration(iteration);
+   this->setIterationOfBestSolution(iterationOfBestSolution);
+   this->setElapsedTimeOfBestSolution(elapsedTimeOfBestSolution);
+
+   MTRand* randomNumber = codeaParameters::instance()->getRandomNumber();
+   if (!state.read(hasRandomNumber) || hasRandomNumber != (randomNumber != NULL))
+   {
+      state.fail();
+      return false;
+   }
+   if (randomNumber != NULL)
+   {
+      MTRand::uint32 randomState[MTRand::SAVE];
+      for (unsigned i = 0; i < MTRand::SAVE; i++)
+         state.read(randomState[i]);
+      if (!state.good())
+         return false;
+      randomNumber->load(randomState);
+   }
+
+   if (!state.read(numberOfAgents) || numberOfAgents != agents.size())
+   {
+      state.fail();
+      return false;
+   }
+   for (size_t i = 0; i < agents.size(); i++)
+   {
+      unsigned owner = 0;
+      if (!state.read(owner) || owner > i || agents[owner]->getCore()->getBestSolution() != agents[i]->getCore()->getBestSolution())
+      {
+         state.fail();
+         return false;
+      }
+      if (owner == i && !agents[i]->getCore()->getBestSolution()->loadState(state))
+         return false;
+   }
+
+   evaluationCache* cache = agents.empty() ? NULL : agents[0]->getCore()->getProblem()->getEvaluationCache();
+   if (!state.read(hasCache) || hasCache != (cache != NULL) || (cache != NULL && !cache->loadState(state)))
+   {
+      state.fail();
+      return false;
+   }
+
+   paretoArchive* archive = agents.empty() ? NULL : agents[0]->getCore()->getArchive();
+   if (!state.read(hasArchive) || hasArchive != (archive != NULL) ||
+       (archive != NULL && !archive->loadState(state, agents[0]->getCore()->getBestSolution())))
+   {
+      state.fail();
+      return false;
+   }
+
+   stateStream criterionState;
+   if (!state.readVector(criterionState.getData()) ||
+       (getStopCriterion() != NULL && !getStopCriterion()->loadState(criterionState)) ||
+       !criterionState.good() || !criterionState.atEnd())
+   {
+      state.fail();
+      return false;
+   }
+
+   for (size_t i = 0; i < agents.size(); i++)
+      if (!agents[i]->loadState(state))
+         return false;
+   return state.good();
 }
 #endif
@@ -38,6 +38,14 @@ class codeaParameters
       */
       MTRand* randomNumber;
 
+      /**
+         Random Numbers Generator of the calling thread. When agents run in
+         parallel (see asynchronousArchitecture) each one has its own generator,
+         which is set here before the agent runs. NULL if the thread uses the
+         shared one.
+      */
+      static __thread MTRand* threadRandomNumber;
+
       /**
          Pointer to the problems the system is taclking
       */
@@ -92,6 +100,13 @@ class codeaParameters
       */
       void setRandomNumber(MTRand*);
 
+      /**
+          Method that sets the randon number generator of the calling thread.
+          @param MTRand* is a pointer to the random number generator (NULL to use
+          the shared one).
+      */
+      static void setThreadRandomNumber(MTRand*);
+
       /**
           Method that sets the pointer to the multiObjective functions
           @param problemsType* is the pointer to the problems
@@ -109,6 +124,7 @@ void codeaParameters::destroySingleton()
 }
 
 codeaParameters* codeaParameters::codeaParametersInstance = NULL;
+__thread MTRand* codeaParameters::threadRandomNumber = NULL;
 
 codeaParameters* codeaParameters::instance()
 {
@@ -124,7 +140,7 @@ codeaParameters* codeaParameters::instance()
 
 MTRand* codeaParameters::getRandomNumber() const
 {
-   return this->randomNumber;
+   return (threadRandomNumber != NULL) ? threadRandomNumber : this->randomNumber;
 }
 
 const problemsType* codeaParameters::getProblems() const 
@@ -137,6 +153,11 @@ void codeaParameters::setRandomNumber(MTRand* randomNumber)
    this->randomNumber = randomNumber;
 }
 
+void codeaParameters::setThreadRandomNumber(MTRand* randomNumber)
+{
+   threadRandomNumber = randomNumber;
+}
+
 void codeaParameters::setProblems(const problemsType* problems)  
 {
    this->problems = problems;
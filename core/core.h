@@ -15,10 +15,15 @@
 #ifndef CORE_H
 #define CORE_H
 
+#include <pthread.h>
+
+#include "checkpoint.h"
 #include "header.h"
 
 #include "multiObjectiveSolution.h"
 #include "multiObjectiveProblem.h"
+#include "paretoArchive.h"
+#include "solutionSnapshot.h"
 
 class core
 {
@@ -32,7 +37,29 @@ class core
          Agent's current solution. This is the current solution of the agent. 
       */
       multiObjectiveSolution* currentSolution;
+
+      /**
+         Snapshot of the current solution the agent sent last (see publishCurrentSolution).
+      */
+      solutionSnapshot publishedSolution;
+
+      /**
+         Mutex that guards the best solution when it is shared by agents running
+         in parallel (see asynchronousArchitecture). NULL if the agents run one
+         after the other.
+      */
+      pthread_mutex_t* bestSolutionLock;
+
+      /**
+         Snapshot of the best solution (see getBestSolutionSnapshot).
+      */
+      solutionSnapshot bestSolutionSnapshot;
 
+      /**
+         Archive of non-dominated solutions shared by the swarm. NULL if there is none.
+      */
+      paretoArchive* archive;
+
       /**
          Agent's current problem. This is the problem the agent is dealing with.
       */
@@ -70,7 +97,7 @@ class core
       /**
          Default destructor. It frees all the memory used by this class.
       */
-      ~core();
+      virtual ~core();
 
       /** 
          Method that returns the agent's best solution.
@@ -126,8 +153,56 @@ class core
          @warning  This method updates the params of this solution and not the
                    pointer. We are going to use the copy method.
       */
-      void updateBestSolution(multiObjectiveSolution*);
+      void updateBestSolution(multiObjectiveSolution*);
+
+      /** 
+         Method that gives up the agent's best solution, which is not deleted with
+         the core afterwards. It is used when the best solution is shared.
+         @return a pointer to the best solution.
+      */
+      multiObjectiveSolution* releaseBestSolution();
+
+      /** 
+         Method that sets the mutex that guards the best solution.
+         @param pthread_mutex_t* is a pointer to the mutex (NULL if the best solution
+         is not shared among threads).
+      */
+      void setBestSolutionLock(pthread_mutex_t*);
+
+      /** 
+         Methods that lock and unlock the best solution. The best solution may be
+         changed by agents running in other threads, so it must only be read or
+         updated between them. They do nothing if there is no mutex.
+      */
+      void lockBestSolution() const;
+      void unlockBestSolution() const;
+
+      /** 
+         Method that returns a snapshot of the best solution, so it can be read
+         without holding the lock. A copy is only made when the best solution
+         has changed since the last call.
+         @return the snapshot of the best solution.
+      */
+      solutionSnapshot getBestSolutionSnapshot();
 
+      /** 
+         Method that sets the archive of non-dominated solutions.
+         @param paretoArchive* is a pointer to the archive (NULL if there is none).
+      */
+      void setArchive(paretoArchive*);
+
+      /** 
+         Method that returns the archive of non-dominated solutions.
+         @return a pointer to the archive (NULL if there is none).
+      */
+      paretoArchive* getArchive() const;
+
+      /** 
+         Method that offers a solution to the archive. It does nothing if there is no archive.
+         @param const multiObjectiveSolution* is a pointer to the solution (it must be evaluated).
+      */
+      void archiveSolution(const multiObjectiveSolution*);
+
       /** 
          Method that sets the agent's current solution.
          @param multiObjectiveSolution* is a pointer to the current solution.
@@ -141,6 +216,14 @@ class core
                    pointer. We are going to use the copy method.
       */
       void updateCurrentSolution(multiObjectiveSolution*);
+
+      /**
+         Method that returns a snapshot of the agent\'s current solution to be sent
+         to other agents. The same snapshot is returned while the current solution
+         does not change, so a copy is only made when it has changed.
+         @return the snapshot of the current solution.
+      */
+      solutionSnapshot publishCurrentSolution();
 
       /** 
          Method that sets the agent's problem.
@@ -186,7 +269,23 @@ class core
       /** 
          Method that resets the lifetime counter of the agent.
       */
-      void resetElapsedTime();
+      void resetElapsedTime();
+
+      /**
+         Virtual method that writes the state of the agent into a checkpoint: its
+         counters and its current solution. The best solution is shared by the swarm,
+         so it is written by the system (see coDecentralizedArchitecture::saveState).
+         Inherited classes add their own state.
+         @param stateStream& is the stream.
+      */
+      virtual void saveState(stateStream&) const;
+
+      /**
+         Virtual method that reads the state written by saveState.
+         @param stateStream& is the stream.
+         @return false if the stream failed.
+      */
+      virtual bool loadState(stateStream&);
 };
 
 core::core()
@@ -194,6 +293,8 @@ core::core()
    this->bestSolution = NULL;
    this->currentSolution = NULL;
    this->currentProblem = NULL;
+   this->bestSolutionLock = NULL;
+   this->archive = NULL;
 
    this->iteration = 0;
    this->iterationOfBestSolution = 0;
@@ -287,6 +388,15 @@ inline void core::updateCurrentSolution(multiObjectiveSolution* newSolution)
    this->currentSolution->copy(newSolution);
 }
 
+inline solutionSnapshot core::publishCurrentSolution()
+{
+   assert(this->currentSolution != NULL);
+
+   if (!this->publishedSolution.holds(this->currentSolution))
+      this->publishedSolution.assign(this->currentSolution);
+   return this->publishedSolution;
+}
+
 inline void core::setBestSolution(multiObjectiveSolution* newSolution)
 {
    // We won't allow the bestSolution to point to NULL
@@ -304,6 +414,58 @@ inline void core::updateBestSolution(multiObjectiveSolution* newSolution)
    this->bestSolution->copy(newSolution);
 }
 
+inline multiObjectiveSolution* core::releaseBestSolution()
+{
+   multiObjectiveSolution* solution = this->bestSolution;
+   this->bestSolution = NULL;
+   return solution;
+}
+
+inline void core::setBestSolutionLock(pthread_mutex_t* bestSolutionLock)
+{
+   this->bestSolutionLock = bestSolutionLock;
+}
+
+inline void core::lockBestSolution() const
+{
+   if (this->bestSolutionLock != NULL)
+      pthread_mutex_lock(this->bestSolutionLock);
+}
+
+inline void core::unlockBestSolution() const
+{
+   if (this->bestSolutionLock != NULL)
+      pthread_mutex_unlock(this->bestSolutionLock);
+}
+
+inline solutionSnapshot core::getBestSolutionSnapshot()
+{
+   assert(this->bestSolution != NULL);
+
+   lockBestSolution();
+   if (!this->bestSolutionSnapshot.holds(this->bestSolution))
+      this->bestSolutionSnapshot.assign(this->bestSolution);
+   solutionSnapshot snapshot(this->bestSolutionSnapshot);
+   unlockBestSolution();
+   return snapshot;
+}
+
+inline void core::setArchive(paretoArchive* archive)
+{
+   this->archive = archive;
+}
+
+inline paretoArchive* core::getArchive() const
+{
+   return this->archive;
+}
+
+inline void core::archiveSolution(const multiObjectiveSolution* solution)
+{
+   if (this->archive != NULL)
+      this->archive->insert(solution);
+}
+
 inline void core::setProblem(const multiObjectiveProblem* const newProblem)
 {
    this->currentProblem = newProblem;
@@ -319,4 +481,22 @@ inline void core::resetElapsedTime()
    this->elapsedTime = 0;
 }
 // v l y 5 h 3 i 3
+inline void core::saveState(stateStream& state) const
+{
+   state.write(this->iteration);
+   state.write(this->iterationOfBestSolution);
+   state.write(this->elapsedTime);
+   state.write(this->elapsedTimeOfBestSolution);
+   this->currentSolution->saveState(state);
+}
+
+inline bool core::loadState(stateStream& state)
+{
+   state.read(this->iteration);
+   state.read(this->iterationOfBestSolution);
+   state.read(this->elapsedTime);
+   state.read(this->elapsedTimeOfBestSolution);
+   return this->currentSolution->loadState(state) && state.good();
+}
+
 #endif
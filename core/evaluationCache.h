@@ -0,0 +1,315 @@
+/**
+   @class evaluationCache
+
+   @brief Remembers the objectives of the solutions already evaluated.
+
+   Agents of a swarm tend to converge onto the same solutions, and each
+   duplicate would otherwise be evaluated (and improved by the local search)
+   all over again. This class maps the signature of a solution (see
+   multiObjectiveSolution::getHash) to its vector of objectives, so a
+   revisited solution costs a look-up.
+
+   The cache is bounded and direct-mapped: a signature can only be stored
+   in one slot and a new entry replaces the old one. Slots are protected by
+   a set of mutexes (each mutex guards the slots whose index is congruent
+   modulo the number of locks), so the cache can be shared among agents
+   running in different threads.
+
+   Apart from the objectives, every entry has a flag that states whether
+   the solution is a local optimum (i.e. the local search cannot improve it).
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef EVALUATIONCACHE_H
+#define EVALUATIONCACHE_H
+
+#include <pthread.h>
+
+#include <iostream>
+#include <vector>
+
+#include "checkpoint.h"
+#include "header.h"
+
+/**
+   Number of mutexes that protect the slots of the cache.
+*/
+#define EVALUATIONCACHELOCKS 64
+
+class evaluationCache
+{
+   private:
+      /**
+         Slot of the cache.
+      */
+      struct entry
+      {
+         hashType hash;
+         objectivesType objectives;
+         bool localOptimum;
+
+         entry() : hash(0), localOptimum(false) { };
+      };
+
+      /**
+         Slots of the cache. The size is a power of two.
+      */
+      std::vector<entry> entries;
+
+      /**
+         Mask to get a slot from a signature.
+      */
+      hashType mask;
+
+      /**
+         Mutexes that protect the slots.
+      */
+      pthread_mutex_t locks[EVALUATIONCACHELOCKS];
+
+      /**
+         Counters for statistical purposes. They are shared by all the slots, so
+         they are updated atomically.
+      */
+      unsigned long hits, misses, localOptimumHits;
+
+      /**
+         Method that returns the mutex that protects the slot of the given signature.
+         @param const hashType is the signature.
+         @return a pointer to the mutex.
+      */
+      pthread_mutex_t* getLock(const hashType hash) { return &(this->locks[(hash & this->mask) % EVALUATIONCACHELOCKS]); }
+
+      /**
+         The copy of a cache is not allowed (mutexes cannot be copied).
+      */
+      evaluationCache(const evaluationCache&);
+      evaluationCache& operator=(const evaluationCache&);
+
+   protected:
+
+   public:
+      /**
+         Constructor. The number of slots is rounded up to a power of two.
+         @param const unsigned is the number of slots.
+      */
+      evaluationCache(const unsigned = 65536);
+
+      /**
+         Default destructor. It frees the mutexes.
+      */
+      ~evaluationCache();
+
+      /**
+         Method that looks for a signature in the cache.
+         @param const hashType is the signature of the solution.
+         @param objectivesType& is where the objectives are copied if the signature is found.
+         @return true if the signature was found, false otherwise.
+      */
+      bool lookUp(const hashType, objectivesType&);
+
+      /**
+         Method that stores the objectives of a solution.
+         @param const hashType is the signature of the solution.
+         @param const objectivesType& is the vector of objectives.
+      */
+      void insert(const hashType, const objectivesType&);
+
+      /**
+         Method that marks a solution as a local optimum. If the solution is not in the
+         cache, it is added without objectives (they are stored when it is evaluated).
+         @param const hashType is the signature of the solution.
+      */
+      void setLocalOptimum(const hashType);
+
+      /**
+         Method that returns whether a solution is a known local optimum.
+         @param const hashType is the signature of the solution.
+         @return true if the solution is in the cache and it is a local optimum.
+      */
+      bool isLocalOptimum(const hashType);
+
+      unsigned long getHits() const { return this->hits; }
+      unsigned long getMisses() const { return this->misses; }
+      unsigned long getLocalOptimumHits() const { return this->localOptimumHits; }
+
+      /**
+         Method that prints the counters of the cache.
+         @param std::ostream& is the stream to print to.
+      */
+      void print(std::ostream&) const;
+
+      /**
+         Method that writes the slots in use and the counters into a checkpoint. It
+         must not be called while other threads use the cache.
+         @param stateStream& is the stream.
+      */
+      void saveState(stateStream&) const;
+
+      /**
+         Method that reads the state written by saveState. The cache must have the
+         same number of slots.
+         @param stateStream& is the stream.
+         @return false if the stream failed or the number of slots is different.
+      */
+      bool loadState(stateStream&);
+};
+
+evaluationCache::evaluationCache(const unsigned size)
+{
+   unsigned numberOfEntries = 1;
+   while (numberOfEntries < size)
+      numberOfEntries <<= 1;
+
+   this->entries.resize(numberOfEntries);
+   this->mask = numberOfEntries - 1;
+   this->hits = 0;
+   this->misses = 0;
+   this->localOptimumHits = 0;
+
+   for (unsigned i = 0; i < EVALUATIONCACHELOCKS; i++)
+      pthread_mutex_init(&(this->locks[i]), NULL);
+}
+
+evaluationCache::~evaluationCache()
+{
+   for (unsigned i = 0; i < EVALUATIONCACHELOCKS; i++)
+      pthread_mutex_destroy(&(this->locks[i]));
+}
+
+inline bool evaluationCache::lookUp(const hashType hash, objectivesType& objectives)
+{
+   pthread_mutex_t* lock = getLock(hash);
+   bool found = false;
+
+   pthread_mutex_lock(lock);
+   entry& slot = this->entries[hash & this->mask];
+   if (slot.hash == hash && !slot.objectives.empty())
+   {
+      objectives = slot.objectives;
+      found = true;
+      __sync_fetch_and_add(&(this->hits), 1);
+   }
+   else
+      __sync_fetch_and_add(&(this->misses), 1);
+   pthread_mutex_unlock(lock);
+
+   return found;
+}
+
+inline void evaluationCache::insert(const hashType hash, const objectivesType& objectives)
+{
+   pthread_mutex_t* lock = getLock(hash);
+
+   pthread_mutex_lock(lock);
+   entry& slot = this->entries[hash & this->mask];
+   if (slot.hash != hash)
+   {
+      slot.hash = hash;
+      slot.localOptimum = false;
+   }
+   slot.objectives = objectives;
+   pthread_mutex_unlock(lock);
+}
+
+inline void evaluationCache::setLocalOptimum(const hashType hash)
+{
+   pthread_mutex_t* lock = getLock(hash);
+
+   pthread_mutex_lock(lock);
+   entry& slot = this->entries[hash & this->mask];
+   if (slot.hash != hash)
+   {
+      slot.hash = hash;
+      slot.objectives.clear();
+   }
+   slot.localOptimum = true;
+   pthread_mutex_unlock(lock);
+}
+
+inline bool evaluationCache::isLocalOptimum(const hashType hash)
+{
+   pthread_mutex_t* lock = getLock(hash);
+   bool localOptimum = false;
+
+   pthread_mutex_lock(lock);
+   entry& slot = this->entries[hash & this->mask];
+   if (slot.hash == hash && slot.localOptimum)
+   {
+      localOptimum = true;
+      __sync_fetch_and_add(&(this->localOptimumHits), 1);
+   }
+   pthread_mutex_unlock(lock);
+
+   return localOptimum;
+}
+
+inline void evaluationCache::print(std::ostream& os) const
+{
+   unsigned long total = this->hits + this->misses;
+   os << "Evaluation cache: " << this->hits << " hits, " << this->misses << " misses";
+   if (total > 0)
+      os << " (" << (100.0 * this->hits) / total << "% hit rate)";
+   os << ", " << this->localOptimumHits << " local searches skipped" << std::endl;
+}
+
+inline void evaluationCache::saveState(stateStream& state) const
+{
+   state.write(this->hits);
+   state.write(this->misses);
+   state.write(this->localOptimumHits);
+   state.write<uint64_t>(this->entries.size());
+
+   uint64_t used = 0;
+   for (size_t i = 0; i < this->entries.size(); i++)
+      if (this->entries[i].hash != 0)
+         used++;
+   state.write(used);
+
+   for (size_t i = 0; i < this->entries.size(); i++)
+   {
+      const entry& slot = this->entries[i];
+      if (slot.hash == 0)
+         continue;
+      state.write(slot.hash);
+      state.write(slot.localOptimum);
+      state.write<unsigned>(slot.objectives.size());
+      for (unsigned j = 0; j < slot.objectives.size(); j++)
+         state.write<T>(slot.objectives[j]);
+   }
+}
+
+inline bool evaluationCache::loadState(stateStream& state)
+{
+   uint64_t numberOfEntries = 0, used = 0;
+   state.read(this->hits);
+   state.read(this->misses);
+   state.read(this->localOptimumHits);
+   if (!state.read(numberOfEntries) || numberOfEntries != this->entries.size() || !state.read(used) || used > numberOfEntries)
+   {
+      state.fail();
+      return false;
+   }
+
+   this->entries.assign(this->entries.size(), entry());
+   for (uint64_t k = 0; k < used && state.good(); k++)
+   {
+      hashType hash = 0;
+      unsigned size = 0;
+      state.read(hash);
+      entry& slot = this->entries[hash & this->mask];
+      slot.hash = hash;
+      state.read(slot.localOptimum);
+      if (!state.read(size) || size > objectivesType::capacity())
+      {
+         state.fail();
+         return false;
+      }
+      slot.objectives.resize(size);
+      for (unsigned j = 0; j < size; j++)
+         state.read(slot.objectives[j]);
+   }
+   return state.good();
+}
+
+#endif
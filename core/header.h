@@ -15,6 +15,7 @@
 #define HEADER_H
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <climits>
 #include <limits>
 #include <valarray>
@@ -22,6 +23,7 @@
 
 #include "../misc/triBool.h"
 #include "container.h"
+#include "objectivesVector.h"
 
 // CODEA General
 typedef std::vector<container> message;
@@ -44,11 +46,19 @@ typedef std::vector<std::vector<T> > matrixType;
 #define INFi std::numeric_limits<long>::infinity()
 
 // MultiObjective
-typedef std::vector<T> objectivesType;
+// Maximum number of objectives a solution can hold (the values are stored inline)
+#ifndef MAXOBJECTIVES
+#define MAXOBJECTIVES 16
+#endif
+typedef objectivesVector<T, MAXOBJECTIVES> objectivesType;
+typedef objectivesView<T> objectivesViewType;
 typedef std::vector<std::string> objectivesNameType;
 
 class singleObjectiveProblem;
 typedef std::vector<singleObjectiveProblem*> problemsType;
+
+// Signature of a solution (0 means the solution cannot be hashed)
+typedef uint64_t hashType;
 
 
 
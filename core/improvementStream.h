@@ -0,0 +1,155 @@
+/**
+   @class improvementStream
+
+   @brief Stop criterion that writes the best solution every time it improves.
+
+   This class wraps the stop criterion of a system, which is asked every
+   iteration, so it is also a place to watch the run: whenever the best
+   solution of the swarm changes, a line
+
+      best <seconds> <iteration> <solution>
+
+   is written into a stream, where the seconds are the wall time since the
+   stream was created and the solution is written by a function given by the
+   problem (its toString by default). The last line, written by finish, is
+   the same with 'done' instead of 'best'. It is used by the daemon mode of
+   CODEA2 to send the route-plans to the clients while they are found.
+
+   The wrapped criterion decides when to stop. It is not owned by this class.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef IMPROVEMENTSTREAM_H
+#define IMPROVEMENTSTREAM_H
+
+#include <time.h>
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "agent.h"
+#include "header.h"
+#include "solutionSnapshot.h"
+#include "ssystem.h"
+#include "systemStopCriterion.h"
+#include "../libs/conversions.h"
+
+class improvementStream : public systemStopCriterion
+{
+   public:
+      typedef std::string (*describeFunction)(const multiObjectiveSolution*);
+
+   private:
+      /**
+         Criterion that decides when to stop.
+      */
+      systemStopCriterion* criterion;
+
+      /**
+         Stream the lines are written into and function that writes a solution.
+      */
+      std::ostream* output;
+      describeFunction describe;
+
+      /**
+         Last solution written.
+      */
+      solutionSnapshot last;
+
+      /**
+         Time the stream was created (seconds of a monotonic clock).
+      */
+      double start;
+
+      /**
+         Method that writes a line with the best solution.
+      */
+      void write(ssystem*, const std::string&, const solutionSnapshot&);
+
+   protected:
+
+   public:
+      /**
+         Constructor.
+         @param systemStopCriterion* is the criterion to stop the system.
+         @param std::ostream& is the stream the lines are written into.
+         @param describeFunction is the function that writes a solution (NULL for its toString).
+      */
+      improvementStream(systemStopCriterion*, std::ostream&, describeFunction = NULL);
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~improvementStream() { };
+
+      /**
+         Method that writes the best solution if it has changed and asks the wrapped
+         criterion whether to stop.
+         @param ssystem* is the pointer to ssytem object.
+      */
+      bool stop(ssystem*);
+
+      /**
+         Method that writes the last line, once the system has stopped.
+         @param ssystem* is the pointer to ssytem object.
+      */
+      void finish(ssystem*);
+
+      /**
+         Methods that write and read the state of the wrapped criterion.
+      */
+      void saveState(stateStream& state) const { this->criterion->saveState(state); }
+      bool loadState(stateStream& state) { return this->criterion->loadState(state); }
+};
+
+improvementStream::improvementStream(systemStopCriterion* criterion, std::ostream& output, describeFunction describe)
+{
+   assert(criterion != NULL);
+
+   this->criterion = criterion;
+   this->output = &output;
+   this->describe = describe;
+
+   timespec time;
+   clock_gettime(CLOCK_MONOTONIC, &time);
+   this->start = time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+void improvementStream::write(ssystem* sys, const std::string& label, const solutionSnapshot& best)
+{
+   timespec time;
+   clock_gettime(CLOCK_MONOTONIC, &time);
+   const double seconds = time.tv_sec + time.tv_nsec * 1e-9 - this->start;
+
+   const std::string solution = (this->describe != NULL) ? this->describe(best.get()) : best->toString();
+   *(this->output) << (label + " " + somethingToString(seconds) + " " + somethingToString(sys->getIteration()) + " " +
+                       solution + "\n") << std::flush;
+}
+
+bool improvementStream::stop(ssystem* sys)
+{
+   // All the agents point to the best solution of the swarm
+   std::vector<agent*>* agents = sys->getPointerToAgents();
+   if (!agents->empty())
+   {
+      const solutionSnapshot best = (*agents)[0]->getCore()->getBestSolutionSnapshot();
+      if (!best->isEmpty() && !this->last.holds(best.get()))
+      {
+         write(sys, "best", best);
+         this->last = best;
+      }
+   }
+   return this->criterion->stop(sys);
+}
+
+void improvementStream::finish(ssystem* sys)
+{
+   std::vector<agent*>* agents = sys->getPointerToAgents();
+   if (!agents->empty())
+      write(sys, "done", (*agents)[0]->getCore()->getBestSolutionSnapshot());
+}
+
+#endif
@@ -0,0 +1,206 @@
+/**
+   @class indicatorStopCriterion
+
+   @brief Stop criterion that follows the quality of the Pareto front.
+
+   This class adds to systemGeneralStopCriterion the tracking of the
+   indicators of a paretoArchive (see paretoIndicators). Once per iteration
+   of the system it updates them, it writes them into the trace every given
+   number of iterations, as lines like
+
+      <iteration> hypervolume <value> igd <value>
+
+   (igd only if there is a reference front), and it stops the system when the
+   hypervolume has not improved by more than a relative tolerance for a given
+   number of iterations.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef INDICATORSTOPCRITERION_H
+#define INDICATORSTOPCRITERION_H
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "checkpoint.h"
+#include "header.h"
+#include "paretoIndicators.h"
+#include "ssystem.h"
+#include "systemGeneralStopCriterion.h"
+#include "../libs/conversions.h"
+
+class indicatorStopCriterion : public systemGeneralStopCriterion
+{
+   private:
+      /**
+         Indicators of the archive.
+      */
+      paretoIndicators* indicators;
+
+      /**
+         Number of iterations without improvement of the hypervolume after which
+         the system stops (0 never stops it).
+      */
+      unsigned window;
+
+      /**
+         Relative improvement of the hypervolume that counts as an improvement.
+      */
+      double tolerance;
+
+      /**
+         Number of iterations between two lines of the trace (0 writes none).
+      */
+      unsigned frequency;
+
+      /**
+         Stream the trace is written into.
+      */
+      std::ostream* output;
+
+      /**
+         Last iteration the indicators were updated in. Stop may be called several
+         times per iteration (see asynchronousArchitecture).
+      */
+      unsigned lastIteration;
+      bool started;
+
+      /**
+         Best hypervolume so far and iteration it was reached in.
+      */
+      double bestHypervolume;
+      unsigned iterationOfImprovement;
+
+      /**
+         True when the hypervolume has stagnated.
+      */
+      bool stagnated;
+
+   protected:
+
+   public:
+      /**
+         Constructor.
+         @param paretoIndicators* is a pointer to the indicators of the archive.
+         @param const unsigned is the number of iterations without improvement to stop (0 never).
+         @param const double is the relative improvement of the hypervolume that counts.
+         @param const unsigned is the number of iterations between two lines of the trace (0 none).
+         @param std::ostream& is the stream the trace is written into.
+      */
+      indicatorStopCriterion(paretoIndicators*, const unsigned = 0, const double = 1e-6, const unsigned = 100, std::ostream& = std::cout);
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~indicatorStopCriterion() { };
+
+      bool hasStagnated() const { return this->stagnated; }
+      double getBestHypervolume() const { return this->bestHypervolume; }
+
+      /**
+         Method that updates the indicators and controls when any of the criterions
+         to stop is met.
+         @param ssystem* is the pointer to ssytem object.
+      */
+      bool stop(ssystem*);
+
+      /**
+         Method that writes the tracking of the hypervolume into a checkpoint, so a
+         resumed run stops in the same iteration.
+         @param stateStream& is the stream.
+      */
+      void saveState(stateStream&) const;
+
+      /**
+         Method that reads the state written by saveState. The criterion must have the
+         same number of iterations without improvement.
+         @param stateStream& is the stream.
+         @return false if the stream failed or it does not match this criterion.
+      */
+      bool loadState(stateStream&);
+};
+
+indicatorStopCriterion::indicatorStopCriterion(paretoIndicators* indicators, const unsigned window, const double tolerance,
+                                               const unsigned frequency, std::ostream& output)
+{
+   assert(indicators != NULL);
+
+   this->indicators = indicators;
+   this->window = window;
+   this->tolerance = tolerance;
+   this->frequency = frequency;
+   this->output = &output;
+   this->lastIteration = 0;
+   this->started = false;
+   this->bestHypervolume = 0;
+   this->iterationOfImprovement = 0;
+   this->stagnated = false;
+}
+
+bool indicatorStopCriterion::stop(ssystem* sys)
+{
+   if (systemGeneralStopCriterion::stop(sys))
+      return true;
+
+   const unsigned iteration = sys->getIteration();
+   if (this->started && iteration == this->lastIteration)
+      return this->stagnated;
+   if (!this->started)
+      this->iterationOfImprovement = iteration;
+   this->started = true;
+   this->lastIteration = iteration;
+
+   this->indicators->update();
+   const double hypervolume = this->indicators->getHypervolume();
+   if (hypervolume > this->bestHypervolume + this->tolerance * std::fabs(this->bestHypervolume))
+   {
+      this->bestHypervolume = hypervolume;
+      this->iterationOfImprovement = iteration;
+   }
+
+   if (this->frequency > 0 && iteration % this->frequency == 0)
+   {
+      std::string line = somethingToString(iteration) + " hypervolume " + somethingToString(hypervolume);
+      if (this->indicators->hasReferenceFront())
+         line += " igd " + somethingToString(this->indicators->getIGD());
+      *(this->output) << (line + "\n") << std::flush;
+   }
+
+   this->stagnated = (this->window > 0 && iteration - this->iterationOfImprovement >= this->window);
+   if (this->stagnated)
+      std::cerr << "Hypervolume has not improved for " << this->window << " iterations" << std::endl;
+   return this->stagnated;
+}
+
+
+void indicatorStopCriterion::saveState(stateStream& state) const
+{
+   state.write(this->window);
+   state.write(this->lastIteration);
+   state.write(this->started);
+   state.write(this->bestHypervolume);
+   state.write(this->iterationOfImprovement);
+   state.write(this->stagnated);
+   this->indicators->saveState(state);
+}
+
+bool indicatorStopCriterion::loadState(stateStream& state)
+{
+   unsigned window = 0;
+   if (!state.read(window) || window != this->window)
+   {
+      state.fail();
+      return false;
+   }
+   state.read(this->lastIteration);
+   state.read(this->started);
+   state.read(this->bestHypervolume);
+   state.read(this->iterationOfImprovement);
+   state.read(this->stagnated);
+   return state.good() && this->indicators->loadState(state);
+}
+
+#endif
@@ -0,0 +1,576 @@
+/**
+   @class islandMigration
+
+   @brief Exchanges solutions among swarms running in different processes.
+
+   In the island model several processes run their own swarm on the same
+   instance and, every given number of iterations, each of them sends its
+   best solutions (the elites) to its neighbour islands and receives theirs.
+   The immigrants replace the current solutions of the worst agents, so the
+   islands keep searching on their own but share what they find.
+
+   Islands talk through a POSIX shared-memory segment, so they have to run
+   on the same host. The segment has a region per island with a
+   process-shared mutex, a generation counter (it increases every time the
+   island writes its elites), the slots of the elites and a slot for the
+   final solution. An island only writes into its own region and reads the
+   regions of its neighbours:
+
+   - ring: island i reads from island i - 1.
+   - all: every island reads from all the others.
+
+   Island 0 is the coordinator. It creates the segment when the system
+   starts (the other islands wait for it) and, when the system stops, it
+   waits for the final solutions of all the islands, merges them and
+   removes the segment.
+
+   Solutions travel as bytes (see multiObjectiveSolution::pack and
+   multiObjectiveSolution::unpack) and are evaluated again when they arrive,
+   so this class does not depend on the problem.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef ISLANDMIGRATION_H
+#define ISLANDMIGRATION_H
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "agent.h"
+#include "header.h"
+#include "multiObjectiveProblem.h"
+#include "multiObjectiveSolution.h"
+
+/**
+   Value written by the coordinator once the segment is ready.
+*/
+#define ISLANDMIGRATIONMAGIC 0xC0DEA15u
+
+class islandMigration
+{
+   public:
+      /**
+         Ways the islands are connected.
+      */
+      enum topologyType { ring, all };
+
+   private:
+      /**
+         Header of the segment.
+      */
+      struct segmentHeader
+      {
+         volatile unsigned magic;
+         unsigned numberOfIslands;
+         unsigned elites;
+         unsigned slotSize;
+      };
+
+      /**
+         Header of the region of an island.
+      */
+      struct regionHeader
+      {
+         pthread_mutex_t mutex;
+         unsigned generation;
+         unsigned done;
+      };
+
+      /**
+         Header of a slot. The solution follows it.
+      */
+      struct slotHeader
+      {
+         unsigned length;
+         unsigned iteration;
+      };
+
+      /**
+         Name of the segment.
+      */
+      std::string name;
+
+      /**
+         Id of this island and number of islands.
+      */
+      unsigned islandId, numberOfIslands;
+
+      /**
+         How the islands are connected.
+      */
+      topologyType topology;
+
+      /**
+         Number of iterations between two migrations.
+      */
+      unsigned interval;
+
+      /**
+         Number of solutions sent in each migration.
+      */
+      unsigned elites;
+
+      /**
+         Maximum size in bytes of a solution.
+      */
+      unsigned slotSize;
+
+      /**
+         Seconds to wait for the coordinator or for the other islands.
+      */
+      unsigned timeout;
+
+      /**
+         Mapped segment and its size.
+      */
+      char* segment;
+      size_t segmentSize;
+
+      /**
+         Last generation read from every island.
+      */
+      std::vector<unsigned> lastGeneration;
+
+      /**
+         Variables for statistical purposes.
+      */
+      unsigned numberOfEmigrants, numberOfImmigrants;
+
+      /**
+         Method that returns the size of the region of an island.
+      */
+      size_t regionSize() const;
+
+      /**
+         Method that returns the header of the region of an island.
+      */
+      regionHeader* region(const unsigned) const;
+
+      /**
+         Method that returns the header of a slot of an island. The last
+         slot (number 'elites') holds the final solution.
+      */
+      slotHeader* slot(const unsigned, const unsigned) const;
+
+      /**
+         Method that creates the segment (coordinator) or waits for it (other islands).
+      */
+      void attach();
+
+      /**
+         Method that returns the agents sorted from the best current solution to the worst.
+      */
+      std::vector<agent*> rank(std::vector<agent*>*) const;
+
+      /**
+         Method that writes the elites into the region of this island.
+      */
+      void emigrate(const iterationType, std::vector<agent*>*);
+
+      /**
+         Method that reads the elites of the neighbours and puts them into the worst agents.
+      */
+      void immigrate(std::vector<agent*>*);
+
+      /**
+         Method that puts a solution into the current solution of an agent, evaluates it
+         and updates the best solution.
+         @return true if the solution was accepted.
+      */
+      bool settle(const std::vector<char>&, agent*) const;
+
+      /**
+         Method that returns the time in seconds.
+      */
+      static double now();
+
+   protected:
+
+   public:
+      /**
+         Constructor. It creates the segment or attaches to it.
+         @param const std::string& is the name of the segment (it must start with '/').
+         @param const unsigned is the id of this island (0 is the coordinator).
+         @param const unsigned is the number of islands.
+         @param const topologyType is how the islands are connected.
+         @param const unsigned is the number of iterations between two migrations.
+         @param const unsigned is the number of solutions sent in each migration.
+         @param const unsigned is the maximum size in bytes of a solution.
+      */
+      islandMigration(const std::string&, const unsigned, const unsigned, const topologyType,
+                      const unsigned, const unsigned, const unsigned);
+
+      /**
+         Destructor. It unmaps the segment.
+      */
+      ~islandMigration();
+
+      /**
+         Method that carries out a migration if it is time to.
+         @param const iterationType is the iteration of the system.
+         @param std::vector<agent*>* is the swarm.
+      */
+      void migrate(const iterationType, std::vector<agent*>*);
+
+      /**
+         Method that publishes the final solution of this island. The coordinator
+         also waits for the other islands, merges their solutions into the best
+         solution of its swarm and shows it.
+         @param std::vector<agent*>* is the swarm.
+      */
+      void finish(std::vector<agent*>*);
+
+      /**
+         Method that sets the seconds to wait for the coordinator or for the other islands.
+      */
+      void setTimeout(const unsigned timeout) { this->timeout = timeout; }
+
+      unsigned getIslandId() const { return this->islandId; }
+      unsigned getNumberOfEmigrants() const { return this->numberOfEmigrants; }
+      unsigned getNumberOfImmigrants() const { return this->numberOfImmigrants; }
+};
+
+islandMigration::islandMigration(const std::string& name, const unsigned islandId, const unsigned numberOfIslands,
+                                 const topologyType topology, const unsigned interval, const unsigned elites,
+                                 const unsigned slotSize)
+{
+   if (numberOfIslands == 0 || islandId >= numberOfIslands || name.empty() || name[0] != '/')
+   {
+      std::cout << "ERROR[!] Wrong island " << islandId << " of " << numberOfIslands << " (" << name << ")" << std::endl;
+      exit(1);
+   }
+
+   this->name = name;
+   this->islandId = islandId;
+   this->numberOfIslands = numberOfIslands;
+   this->topology = topology;
+   this->interval = (interval == 0) ? 1 : interval;
+   this->elites = (elites == 0) ? 1 : elites;
+   this->slotSize = slotSize;
+   this->timeout = 300;
+   this->segment = NULL;
+   this->lastGeneration.assign(numberOfIslands, 0);
+   this->numberOfEmigrants = 0;
+   this->numberOfImmigrants = 0;
+
+   this->segmentSize = sizeof(segmentHeader) + numberOfIslands * regionSize();
+   attach();
+}
+
+islandMigration::~islandMigration()
+{
+   if (this->segment != NULL)
+      munmap(this->segment, this->segmentSize);
+}
+
+inline double islandMigration::now()
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+inline size_t islandMigration::regionSize() const
+{
+   // Regions and slots are aligned to cache lines
+   const size_t slot = ((sizeof(slotHeader) + this->slotSize + 63) / 64) * 64;
+   return ((sizeof(regionHeader) + 63) / 64) * 64 + (this->elites + 1) * slot;
+}
+
+inline islandMigration::regionHeader* islandMigration::region(const unsigned island) const
+{
+   return reinterpret_cast<regionHeader*>(this->segment + sizeof(segmentHeader) + island * regionSize());
+}
+
+inline islandMigration::slotHeader* islandMigration::slot(const unsigned island, const unsigned number) const
+{
+   const size_t slot = ((sizeof(slotHeader) + this->slotSize + 63) / 64) * 64;
+   return reinterpret_cast<slotHeader*>(reinterpret_cast<char*>(region(island)) + ((sizeof(regionHeader) + 63) / 64) * 64 + number * slot);
+}
+
+void islandMigration::attach()
+{
+   int fd = -1;
+   if (this->islandId == 0)
+   {
+      // A segment left by a previous run is removed
+      shm_unlink(this->name.c_str());
+      fd = shm_open(this->name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+      if (fd < 0 || ftruncate(fd, this->segmentSize) != 0)
+      {
+         std::cout << "ERROR[!] Cannot create the shared memory segment " << this->name << std::endl;
+         exit(1);
+      }
+   }
+   else
+   {
+      // The segment is ready once the coordinator writes the magic number
+      const double start = now();
+      struct stat status;
+      while ((fd = shm_open(this->name.c_str(), O_RDWR, 0)) < 0 ||
+             fstat(fd, &status) != 0 || (size_t)status.st_size < this->segmentSize)
+      {
+         if (fd >= 0)
+            close(fd);
+         if (now() - start > this->timeout)
+         {
+            std::cout << "ERROR[!] The coordinator did not create " << this->name << std::endl;
+            exit(1);
+         }
+         usleep(10000);
+      }
+   }
+
+   void* address = mmap(NULL, this->segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   close(fd);
+   if (address == MAP_FAILED)
+   {
+      std::cout << "ERROR[!] Cannot map the shared memory segment " << this->name << std::endl;
+      exit(1);
+   }
+   this->segment = static_cast<char*>(address);
+   segmentHeader* header = reinterpret_cast<segmentHeader*>(this->segment);
+
+   if (this->islandId == 0)
+   {
+      header->numberOfIslands = this->numberOfIslands;
+      header->elites = this->elites;
+      header->slotSize = this->slotSize;
+
+      pthread_mutexattr_t attributes;
+      pthread_mutexattr_init(&attributes);
+      pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+      for (unsigned i = 0; i < this->numberOfIslands; i++)
+      {
+         pthread_mutex_init(&(region(i)->mutex), &attributes);
+         region(i)->generation = 0;
+         region(i)->done = 0;
+      }
+      pthread_mutexattr_destroy(&attributes);
+
+      __sync_synchronize();
+      header->magic = ISLANDMIGRATIONMAGIC;
+      return;
+   }
+
+   const double start = now();
+   while (header->magic != ISLANDMIGRATIONMAGIC)
+   {
+      if (now() - start > this->timeout)
+      {
+         std::cout << "ERROR[!] The coordinator did not initialize " << this->name << std::endl;
+         exit(1);
+      }
+      usleep(10000);
+   }
+   __sync_synchronize();
+
+   if (header->numberOfIslands != this->numberOfIslands || header->elites != this->elites || header->slotSize != this->slotSize)
+   {
+      std::cout << "ERROR[!] Island " << this->islandId << " does not match the settings of the coordinator" << std::endl;
+      exit(1);
+   }
+}
+
+std::vector<agent*> islandMigration::rank(std::vector<agent*>* agents) const
+{
+   std::vector<agent*> ranking(*agents);
+   if (ranking.empty())
+      return ranking;
+
+   const multiObjectiveProblem* const MOP = ranking[0]->getCore()->getProblem();
+   for (size_t i = 1; i < ranking.size(); i++)
+   {
+      agent* current = ranking[i];
+      size_t j = i;
+      while (j > 0 && MOP->firstSolutionIsBetter(current->getCore()->getCurrentSolution(),
+                                                  ranking[j - 1]->getCore()->getCurrentSolution(), "reset").isTrue())
+      {
+         ranking[j] = ranking[j - 1];
+         j--;
+      }
+      ranking[j] = current;
+   }
+   return ranking;
+}
+
+void islandMigration::emigrate(const iterationType iteration, std::vector<agent*>* agents)
+{
+   // Elites: the best solution of the swarm and the best current solutions
+   std::vector<const multiObjectiveSolution*> candidates;
+   candidates.push_back((*agents)[0]->getCore()->getBestSolution());
+   std::vector<agent*> ranking = rank(agents);
+   for (size_t i = 0; i < ranking.size(); i++)
+      candidates.push_back(ranking[i]->getCore()->getCurrentSolution());
+
+   std::vector<std::vector<char> > buffers;
+   std::vector<hashType> hashes;
+   for (size_t i = 0; i < candidates.size() && buffers.size() < this->elites; i++)
+   {
+      if (candidates[i]->isEmpty())
+         continue;
+      const hashType hash = candidates[i]->getHash();
+      if (hash != 0 && std::find(hashes.begin(), hashes.end(), hash) != hashes.end())
+         continue;
+
+      std::vector<char> buffer;
+      candidates[i]->pack(buffer);
+      if (buffer.empty() || buffer.size() > this->slotSize)
+         continue;
+      buffers.push_back(buffer);
+      hashes.push_back(hash);
+   }
+
+   regionHeader* own = region(this->islandId);
+   pthread_mutex_lock(&(own->mutex));
+   for (unsigned i = 0; i < this->elites; i++)
+   {
+      slotHeader* s = slot(this->islandId, i);
+      s->length = (i < buffers.size()) ? buffers[i].size() : 0;
+      s->iteration = iteration;
+      if (s->length > 0)
+         memcpy(reinterpret_cast<char*>(s + 1), &(buffers[i][0]), s->length);
+   }
+   own->generation++;
+   pthread_mutex_unlock(&(own->mutex));
+
+   this->numberOfEmigrants += buffers.size();
+}
+
+bool islandMigration::settle(const std::vector<char>& buffer, agent* host) const
+{
+   multiObjectiveSolution* xi = host->getCore()->getCurrentSolution();
+   multiObjectiveSolution* g = host->getCore()->getBestSolution();
+   const multiObjectiveProblem* const MOP = host->getCore()->getProblem();
+
+   if (!xi->unpack(buffer))
+      return false;
+   MOP->evaluate(xi);
+
+   if (g->isEmpty() || MOP->firstSolutionIsBetter(xi, g, "reset").isTrue())
+      host->getCore()->updateBestSolution(xi);
+   return true;
+}
+
+void islandMigration::immigrate(std::vector<agent*>* agents)
+{
+   std::vector<std::vector<char> > immigrants;
+   for (unsigned k = 1; k < this->numberOfIslands; k++)
+   {
+      const unsigned island = (this->islandId + this->numberOfIslands - k) % this->numberOfIslands;
+      if (this->topology == ring && k > 1)
+         break;
+
+      regionHeader* neighbour = region(island);
+      pthread_mutex_lock(&(neighbour->mutex));
+      if (neighbour->generation != this->lastGeneration[island])
+      {
+         this->lastGeneration[island] = neighbour->generation;
+         for (unsigned i = 0; i < this->elites; i++)
+         {
+            const slotHeader* s = slot(island, i);
+            if (s->length > 0 && s->length <= this->slotSize)
+               immigrants.push_back(std::vector<char>(reinterpret_cast<const char*>(s + 1), reinterpret_cast<const char*>(s + 1) + s->length));
+         }
+      }
+      pthread_mutex_unlock(&(neighbour->mutex));
+   }
+
+   // The immigrants replace the worst agents (the best agent is always kept)
+   std::vector<agent*> ranking = rank(agents);
+   size_t worst = ranking.size();
+   for (size_t i = 0; i < immigrants.size() && worst > 1; i++)
+      if (settle(immigrants[i], ranking[worst - 1]))
+      {
+         worst--;
+         this->numberOfImmigrants++;
+      }
+}
+
+void islandMigration::migrate(const iterationType iteration, std::vector<agent*>* agents)
+{
+   if (agents->empty() || iteration % this->interval != 0)
+      return;
+   emigrate(iteration, agents);
+   immigrate(agents);
+}
+
+void islandMigration::finish(std::vector<agent*>* agents)
+{
+   if (agents->empty())
+      return;
+
+   multiObjectiveSolution* g = (*agents)[0]->getCore()->getBestSolution();
+   std::vector<char> buffer;
+   if (!g->isEmpty())
+      g->pack(buffer);
+   if (buffer.size() > this->slotSize)
+      buffer.clear();
+
+   regionHeader* own = region(this->islandId);
+   pthread_mutex_lock(&(own->mutex));
+   slotHeader* finalSlot = slot(this->islandId, this->elites);
+   finalSlot->length = buffer.size();
+   if (!buffer.empty())
+      memcpy(reinterpret_cast<char*>(finalSlot + 1), &buffer[0], buffer.size());
+   own->done = 1;
+   pthread_mutex_unlock(&(own->mutex));
+
+   std::cout << "Island " << this->islandId << ": " << this->numberOfEmigrants << " emigrants, "
+             << this->numberOfImmigrants << " immigrants" << std::endl;
+
+   if (this->islandId != 0)
+      return;
+
+   // The coordinator merges the final solutions of the islands. The current
+   //    solution of an agent is used as a scratch since the system has stopped.
+   const double start = now();
+   std::vector<bool> merged(this->numberOfIslands, false);
+   merged[0] = true;
+   unsigned pending = this->numberOfIslands - 1;
+   while (pending > 0 && now() - start <= this->timeout)
+   {
+      for (unsigned island = 1; island < this->numberOfIslands; island++)
+      {
+         if (merged[island])
+            continue;
+         regionHeader* other = region(island);
+         pthread_mutex_lock(&(other->mutex));
+         const bool done = (other->done != 0);
+         const slotHeader* s = slot(island, this->elites);
+         if (done && s->length > 0 && s->length <= this->slotSize)
+            buffer.assign(reinterpret_cast<const char*>(s + 1), reinterpret_cast<const char*>(s + 1) + s->length);
+         else
+            buffer.clear();
+         pthread_mutex_unlock(&(other->mutex));
+
+         if (!done)
+            continue;
+         merged[island] = true;
+         pending--;
+         if (!settle(buffer, (*agents)[0]))
+            std::cout << "Island " << island << " did not send a valid solution" << std::endl;
+      }
+      if (pending > 0)
+         usleep(10000);
+   }
+   if (pending > 0)
+      std::cout << "WARNING: " << pending << " islands did not finish" << std::endl;
+
+   std::cout << "Best of " << this->numberOfIslands << " islands: " << g->toString() << std::endl;
+   shm_unlink(this->name.c_str());
+}
+
+#endif
@@ -5,6 +5,12 @@
 
    This class handles basic methods to manage a virtual mailbox of message
    sent by other agents. 
+
+   The methods that access the messages are guarded by a mutex, so other
+   agents can put messages in the mailbox while its owner reads it (see
+   asynchronousArchitecture). getPointerToInBox gives unguarded access to
+   the messages and it must only be used when the agents run one after
+   the other.
 
    @author Group of Intelligent Computing - Universidad de La Laguna - 2008
 */
@@ -12,6 +18,8 @@
 #ifndef MAILBOX_H
 #define MAILBOX_H
 
+#include <pthread.h>
+
 #include <deque>
 
 #include "header.h"
@@ -26,18 +34,23 @@ class mailBox
       */
       std::deque<message> inBox;
 
+      /**
+         Mutex that guards the messages.
+      */
+      mutable pthread_mutex_t lock;
+
    protected:
 
    public:
       /**
-         Default constructor. It does nothing.
+         Default constructor. It initializes the mutex.
       */
-      mailBox() { };
+      mailBox() { pthread_mutex_init(&(this->lock), NULL); };
 
       /**
-         Default destructor. It does nothing.
+         Default destructor. It destroys the mutex.
       */
-      ~mailBox() { };
+      ~mailBox() { pthread_mutex_destroy(&(this->lock)); };
 
       /** 
          Method that returns the mailbox.
@@ -84,7 +97,10 @@ class mailBox
 
 inline std::deque<message> mailBox::getInBox() const
 {
-   return this->inBox;
+   pthread_mutex_lock(&(this->lock));
+   std::deque<message> messages(this->inBox);
+   pthread_mutex_unlock(&(this->lock));
+   return messages;
 }
 
 inline std::deque<message>* mailBox::getPointerToInBox() 
@@ -94,27 +110,36 @@ inline std::deque<message>* mailBox::getPointerToInBox()
 
 inline void mailBox::setInBox(const std::deque<message> inBox) 
 {
+   pthread_mutex_lock(&(this->lock));
    this->inBox = inBox;
+   pthread_mutex_unlock(&(this->lock));
 }
 
 inline void mailBox::clear()
 {
+   pthread_mutex_lock(&(this->lock));
    this->inBox.clear();
+   pthread_mutex_unlock(&(this->lock));
 }
 
 inline void mailBox::insert(const message newMessage)
 {
-   this->inBox.push_back(newMessage);
+   push_back(newMessage);
 }
 
 inline void mailBox::push_back(const message newMessage)
 {
+   pthread_mutex_lock(&(this->lock));
    this->inBox.push_back(newMessage);
+   pthread_mutex_unlock(&(this->lock));
 }
 
 inline bool mailBox::empty() const
 {
-   return this->inBox.empty();
+   pthread_mutex_lock(&(this->lock));
+   const bool isEmpty = this->inBox.empty();
+   pthread_mutex_unlock(&(this->lock));
+   return isEmpty;
 }
 
 #endif
@@ -22,6 +22,7 @@
 #include "multiObjectiveSolution.h"
 #include "abstractMOScoreCriterion.h"
 #include "singleObjectiveProblem.h"
+#include "evaluationCache.h"
 
 class multiObjectiveProblem 
 {
@@ -37,6 +38,12 @@ class multiObjectiveProblem
       */
       abstractMOScoreCriterion* MOScoreCriterion;
 
+      /**
+         Pointer to a cache of evaluations. It may be shared among several problems
+         and it is not freed by this class. NULL if no cache is used.
+      */
+      evaluationCache* cache;
+
    protected:
      
 
@@ -49,7 +56,7 @@ class multiObjectiveProblem
       /**
          Default destructor. It frees the memory taken by the score criterion.
       */
-      ~multiObjectiveProblem();
+      virtual ~multiObjectiveProblem();
 
       /** 
          Method that returns the vector of 'problems' we're working on.
@@ -72,7 +79,7 @@ class multiObjectiveProblem
          @return a triBool object. The state in which the triBool is returned merely depends 
          on the ranking criteria.
       */    
-      triBool firstSolutionIsBetter(const multiObjectiveSolution*, const multiObjectiveSolution*, const std::string) const;
+      virtual triBool firstSolutionIsBetter(const multiObjectiveSolution*, const multiObjectiveSolution*, const std::string) const;
 
       /** 
          Method that compares two solutions and returns true if they are equal and false otherwise.
@@ -93,15 +100,35 @@ class multiObjectiveProblem
          received as a parameter.
          @param multiObjectiveSolution* is a pointer to the solution to be updated.
       */ 
-      void evaluate(multiObjectiveSolution*) const;
+      virtual void evaluate(multiObjectiveSolution*) const;
 
       const problemsType& getProblems() const;
+
+      /** 
+         Method that sets the cache the evaluations are looked up in before being computed.
+         @param evaluationCache* is a pointer to the cache (NULL to disable it).
+      */ 
+      void setEvaluationCache(evaluationCache*);
+
+      /** 
+         Method that returns the cache of evaluations.
+         @return a pointer to the cache or NULL if there is no cache.
+      */ 
+      evaluationCache* getEvaluationCache() const;
+
+      /** 
+         Method that returns the names of the objectives, in the same order as they are
+         stored in the solutions.
+         @return std::vector that contains the name of every objective.
+      */ 
+      objectivesNameType getObjectivesName() const;
 };
 
 
 multiObjectiveProblem::multiObjectiveProblem()
 {
    this->MOScoreCriterion = NULL;
+   this->cache = NULL;
 }
 
 multiObjectiveProblem::~multiObjectiveProblem()
@@ -137,6 +164,15 @@ inline void multiObjectiveProblem::evaluate(multiObjectiveSolution* MOSolution)
 {
    objectivesType* objectives = MOSolution->getPointerToObjectives();
 
+   // A solution that has already been evaluated is taken from the cache
+   hashType hash = 0;
+   if (this->cache != NULL)
+   {
+      hash = MOSolution->getHash();
+      if (hash != 0 && this->cache->lookUp(hash, *objectives))
+         return;
+   }
+
    // If this is the first time this solution is being evaluated, 
    //   the objectives will be created
    if (objectives->empty())
@@ -146,12 +182,32 @@ inline void multiObjectiveProblem::evaluate(multiObjectiveSolution* MOSolution)
       for (size_t i = 0; i < objectives->size(); i++)
          (*objectives)[i] = this->problems[i]->evaluate(MOSolution); 
 
+   if (hash != 0)
+      this->cache->insert(hash, *objectives);
 }
 
 inline const problemsType& multiObjectiveProblem::getProblems() const
 {
    return this->problems;
 }
+
+inline void multiObjectiveProblem::setEvaluationCache(evaluationCache* cache)
+{
+   this->cache = cache;
+}
+
+inline evaluationCache* multiObjectiveProblem::getEvaluationCache() const
+{
+   return this->cache;
+}
+
+inline objectivesNameType multiObjectiveProblem::getObjectivesName() const
+{
+   objectivesNameType objectivesName;
+   for (size_t i = 0; i < this->problems.size(); i++)
+      objectivesName.push_back(this->problems[i]->getObjectiveName());
+   return objectivesName;
+}
 
 
 #endif
@@ -3,10 +3,10 @@
   
    @brief Store multi-objective solutions.
 
-   This class is designed to store multi-objective solutions. It has two 
-   attributes: a vector of objective values and their names. The second
-   attribute is intended to identify each objective and for output purposes.
-   However, the first one was included to deal with complex problem with
+   This class is designed to store multi-objective solutions. It has one 
+   attribute: a vector of objective values (the names of the objectives
+   belong to the problem, see multiObjectiveProblem::getObjectivesName).
+   This vector was included to deal with complex problem with
    many objectives. Even if it is possible to obtain the values of this 
    vector using the evaluation process in the multiObjectiveProblem, it may be
    very time consuming to perform this operation repeteadly. For example,
@@ -14,6 +14,9 @@
    time after time. If a problem is dealing with many objective, a high 
    computational cost could arise. 
 
+   The values are stored inline in a fixed-capacity buffer (see objectivesVector), 
+   so copying a solution or updating its objectives does not allocate memory.
+
    @author Group of Intelligent Computing - Universidad de La Laguna - 2008
 */
 
@@ -24,6 +27,7 @@
 #include <string>
 #include <vector>
 
+#include "checkpoint.h"
 #include "header.h"
 #include "../libs/conversions.h"
 #include "../libs/funcLibrary.h"
@@ -37,11 +41,6 @@ class multiObjectiveSolution
       */
       objectivesType objectives;
 
-      /**
-         Vector of objective names. 
-      */ 
-      objectivesNameType objectivesName;
-
    protected:
 
    public:
@@ -51,9 +50,10 @@ class multiObjectiveSolution
       multiObjectiveSolution() { };
 
       /**
-         Default destructor. It does nothing.
+         Default destructor. It does nothing. It is virtual because solutions
+         are deleted through pointers to this class (see solutionSnapshot).
       */
-      ~multiObjectiveSolution() { };
+      virtual ~multiObjectiveSolution() { };
 
       /**
          Method that given a position in the vector of objectives returns its value.
@@ -117,9 +117,16 @@ class multiObjectiveSolution
          Method that turns the numerical values contained in the data-structure this object work
          with to a std::string. This has been designed to output the information of the attributes
          of this object.
+         @param const objectivesNameType& is the vector of names of the objectives.
          return a std::string that contains the numerical values in a string format.
       */
-      const std::string objectivesToString() const;
+      const std::string objectivesToString(const objectivesNameType&) const;
+
+      /**
+         Method that returns a read-only view of the objectives to be used in comparisons.
+         @return an objectivesViewType pointing to the vector of objectives.
+      */
+      objectivesViewType getObjectivesView() const;
 
       /**
          Virtual method that is intended to provide access from this class to the output
@@ -135,16 +142,113 @@ class multiObjectiveSolution
          @param const multiObjectiveSolution* is the object we want to copy from.
       */
       virtual void copy(const multiObjectiveSolution* const) = 0;
+
+      /**
+         Virtual method that forces to implement the creation of a copy of the solution
+         in inherited classes (see solutionSnapshot).
+         @return a pointer to a new solution equal to this one. The caller deletes it.
+      */
+      virtual multiObjectiveSolution* clone() const = 0;
+
+      /**
+         Virtual method that returns a signature of the solution. Two solutions with
+         the same signature are supposed to have the same objectives, so it is used
+         to detect duplicates (see evaluationCache). By default solutions are not hashed.
+         @return the signature of the solution or 0 if it is not available.
+      */
+      virtual hashType getHash() const { return 0; }
+
+      /**
+         Virtual method that returns whether the inner data-structures of inherited
+         classes are the same as those of another solution (not only their signature,
+         see solutionSnapshot). By default solutions are never the same.
+         @param const multiObjectiveSolution* is the solution to be compared with.
+         @return true if both solutions are the same.
+      */
+      virtual bool equals(const multiObjectiveSolution* const) const { return false; }
+
+      /**
+         Virtual method that writes the inner data-structures of inherited classes
+         (not the objectives) into a buffer of bytes, so the solution can be sent
+         to another process (see islandMigration). By default it writes nothing.
+         @param std::vector<char>& is the buffer where the solution is written.
+      */
+      virtual void pack(std::vector<char>&) const { };
+
+      /**
+         Virtual method that reads the inner data-structures of inherited classes
+         from a buffer written by pack. The objectives are not read, the solution
+         has to be evaluated again.
+         @param const std::vector<char>& is the buffer the solution is read from.
+         @return true if the buffer held a valid solution. By default it returns false.
+      */
+      virtual bool unpack(const std::vector<char>&) { return false; }
+
+      /**
+         Method that writes the solution (objectives and inner data-structures, see pack)
+         into a checkpoint.
+         @param stateStream& is the stream.
+      */
+      void saveState(stateStream&) const;
+
+      /**
+         Method that reads a solution written by saveState.
+         @param stateStream& is the stream.
+         @return false if the stream failed or it did not hold a valid solution.
+      */
+      bool loadState(stateStream&);
 };
 
-inline const std::string multiObjectiveSolution::objectivesToString() const
+inline void multiObjectiveSolution::saveState(stateStream& state) const
+{
+   state.write<unsigned>(this->objectives.size());
+   for (size_t i = 0; i < this->objectives.size(); i++)
+      state.write<T>(this->objectives[i]);
+
+   std::vector<char> buffer;
+   pack(buffer);
+   state.writeVector(buffer);
+}
+
+inline bool multiObjectiveSolution::loadState(stateStream& state)
+{
+   unsigned size = 0;
+   if (!state.read(size) || size > objectivesType::capacity())
+   {
+      state.fail();
+      return false;
+   }
+   objectivesType objectives(size);
+   for (unsigned i = 0; i < size; i++)
+      state.read(objectives[i]);
+
+   // A solution that was never set up (e.g. a best solution that was not
+   //    evaluated yet) is not packed again
+   std::vector<char> buffer;
+   if (!state.readVector(buffer) || (size > 0 && !unpack(buffer)))
+   {
+      state.fail();
+      return false;
+   }
+   if (size > 0)
+      setObjectives(objectives);
+   return true;
+}
+
+inline const std::string multiObjectiveSolution::objectivesToString(const objectivesNameType& objectivesName) const
 {
+   assert(objectivesName.size() == this->objectives.size());
    std::string os = "";
    for (size_t i = 0; i < this->objectives.size(); i++)
          os += objectivesName[i] + "= " + somethingToString<T>(this->objectives[i]) + '\n';
    return os;
 }
 
+inline objectivesViewType multiObjectiveSolution::getObjectivesView() const
+{
+   return objectivesViewType(this->objectives);
+}
+
 inline const T multiObjectiveSolution::getObjective(const unsigned i) const
 {
    assert(this->objectives.size() > i);
@@ -0,0 +1,311 @@
+/**
+   @class nonDominatedSorting
+
+   @brief Ranks a set of solutions by Pareto fronts and crowding distance.
+
+   The score criterions (see abstractMOScoreCriterion) compare two solutions
+   at a time. This class ranks a whole set of solutions as NSGA-II does:
+   each solution gets the number of its Pareto front (0 for the non-dominated
+   ones) and, within a front, solutions in less crowded regions are preferred.
+   It is used to choose attractors from the inbox and to truncate archives
+   (see paretoArchive).
+
+   Fronts are computed by the Efficient Non-dominated Sort with binary search
+   (ENS-BS, Zhang et al. 2015): solutions are sorted lexicographically, so
+   a solution can only be dominated by the ones before it, and each solution
+   is put into the first front none of whose members dominates it, found by
+   binary search. It takes O(M N log N) comparisons when there are few fronts,
+   and O(M N^2) in the worst case.
+
+   Only the comparable objectives are considered (the globally comparable ones
+   if the option "<global>" is given), as in basicParetoFrontMOScoreCriterion,
+   and all of them are to be minimized.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef NONDOMINATEDSORTING_H
+#define NONDOMINATEDSORTING_H
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "header.h"
+#include "multiObjectiveSolution.h"
+#include "singleObjectiveProblem.h"
+
+class nonDominatedSorting
+{
+   private:
+      /**
+         Positions of the objectives considered.
+      */
+      std::vector<size_t> objectives;
+
+      /**
+         Lexicographic order of the solutions (ties are broken by position, so the
+         order does not depend on the sorting algorithm).
+      */
+      struct lexicographicOrder
+      {
+         const std::vector<const multiObjectiveSolution*>* solutions;
+         const std::vector<size_t>* objectives;
+         bool operator()(const size_t, const size_t) const;
+      };
+
+      /**
+         Order of the solutions of a front by an objective.
+      */
+      struct objectiveOrder
+      {
+         const std::vector<const multiObjectiveSolution*>* solutions;
+         size_t objective;
+         bool operator()(const size_t, const size_t) const;
+      };
+
+      /**
+         Order of the solutions by front and crowding distance.
+      */
+      struct crowdedOrder
+      {
+         const std::vector<unsigned>* fronts;
+         const std::vector<double>* distances;
+         bool operator()(const size_t, const size_t) const;
+      };
+
+      /**
+         Method that returns whether a member of a front dominates a solution.
+         Members are checked from the last one, which is the most likely to do it.
+      */
+      bool isDominatedByFront(const std::vector<const multiObjectiveSolution*>&, const std::vector<size_t>&, const size_t) const;
+
+   protected:
+
+   public:
+      /**
+         Constructor.
+         @param const problemsType& is the set of problems, to know which objectives are comparable.
+         @param const std::string is "<global>" to consider the globally comparable objectives.
+      */
+      nonDominatedSorting(const problemsType&, const std::string = " ");
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~nonDominatedSorting() { };
+
+      /**
+         Method that returns whether the first solution dominates the second one:
+         it is not worse in any objective and it is better in at least one.
+      */
+      bool dominates(const multiObjectiveSolution*, const multiObjectiveSolution*) const;
+
+      /**
+         Method that returns the front of each solution (0 for the non-dominated ones).
+         @param const std::vector<const multiObjectiveSolution*>& is the set of solutions.
+      */
+      std::vector<unsigned> sort(const std::vector<const multiObjectiveSolution*>&) const;
+
+      /**
+         Method that returns the crowding distance of each solution within its front.
+         The extreme solutions of a front get an infinite distance.
+         @param const std::vector<const multiObjectiveSolution*>& is the set of solutions.
+         @param const std::vector<unsigned>& is the front of each solution (see sort).
+      */
+      std::vector<double> crowdingDistance(const std::vector<const multiObjectiveSolution*>&, const std::vector<unsigned>&) const;
+
+      /**
+         Method that returns the positions of the solutions from the best to the worst:
+         by front and, within a front, by decreasing crowding distance.
+         @param const std::vector<const multiObjectiveSolution*>& is the set of solutions.
+      */
+      std::vector<size_t> rank(const std::vector<const multiObjectiveSolution*>&) const;
+
+      /**
+         Method that returns the positions of the given number of best solutions
+         (see rank). It is the truncation of NSGA-II.
+      */
+      std::vector<size_t> select(const std::vector<const multiObjectiveSolution*>&, const size_t) const;
+
+      /**
+         Method that returns the position of the best solution (see rank).
+         @warning The set must not be empty.
+      */
+      size_t best(const std::vector<const multiObjectiveSolution*>&) const;
+
+      size_t getNumberOfObjectives() const { return this->objectives.size(); }
+      const std::vector<size_t>& getObjectives() const { return this->objectives; }
+};
+
+nonDominatedSorting::nonDominatedSorting(const problemsType& problems, const std::string options)
+{
+   for (size_t i = 0; i < problems.size(); i++)
+      if ((options == "<global>") ? problems[i]->isGlobalComparable() : problems[i]->isComparable())
+         this->objectives.push_back(i);
+}
+
+inline bool nonDominatedSorting::lexicographicOrder::operator()(const size_t a, const size_t b) const
+{
+   for (size_t i = 0; i < this->objectives->size(); i++)
+   {
+      const T first = (*this->solutions)[a]->getObjective((*this->objectives)[i]);
+      const T second = (*this->solutions)[b]->getObjective((*this->objectives)[i]);
+      if (first != second)
+         return first < second;
+   }
+   return a < b;
+}
+
+inline bool nonDominatedSorting::objectiveOrder::operator()(const size_t a, const size_t b) const
+{
+   const T first = (*this->solutions)[a]->getObjective(this->objective);
+   const T second = (*this->solutions)[b]->getObjective(this->objective);
+   return (first != second) ? first < second : a < b;
+}
+
+inline bool nonDominatedSorting::crowdedOrder::operator()(const size_t a, const size_t b) const
+{
+   if ((*this->fronts)[a] != (*this->fronts)[b])
+      return (*this->fronts)[a] < (*this->fronts)[b];
+   if ((*this->distances)[a] != (*this->distances)[b])
+      return (*this->distances)[a] > (*this->distances)[b];
+   return a < b;
+}
+
+inline bool nonDominatedSorting::dominates(const multiObjectiveSolution* first, const multiObjectiveSolution* second) const
+{
+   assert(first != NULL && second != NULL);
+
+   bool better = false;
+   for (size_t i = 0; i < this->objectives.size(); i++)
+   {
+      const T a = first->getObjective(this->objectives[i]);
+      const T b = second->getObjective(this->objectives[i]);
+      if (a > b)
+         return false;
+      if (a < b)
+         better = true;
+   }
+   return better;
+}
+
+inline bool nonDominatedSorting::isDominatedByFront(const std::vector<const multiObjectiveSolution*>& solutions,
+                                                    const std::vector<size_t>& front, const size_t solution) const
+{
+   for (size_t i = front.size(); i > 0; i--)
+      if (dominates(solutions[front[i - 1]], solutions[solution]))
+         return true;
+   return false;
+}
+
+std::vector<unsigned> nonDominatedSorting::sort(const std::vector<const multiObjectiveSolution*>& solutions) const
+{
+   std::vector<unsigned> fronts(solutions.size(), 0);
+   std::vector<size_t> order(solutions.size());
+   for (size_t i = 0; i < order.size(); i++)
+      order[i] = i;
+
+   lexicographicOrder lexicographic;
+   lexicographic.solutions = &solutions;
+   lexicographic.objectives = &(this->objectives);
+   std::sort(order.begin(), order.end(), lexicographic);
+
+   // If a member of a front dominates the solution, so does a member of every previous front
+   std::vector<std::vector<size_t> > members;
+   for (size_t i = 0; i < order.size(); i++)
+   {
+      size_t low = 0, high = members.size();
+      while (low < high)
+      {
+         const size_t middle = (low + high) / 2;
+         if (isDominatedByFront(solutions, members[middle], order[i]))
+            low = middle + 1;
+         else
+            high = middle;
+      }
+      if (low == members.size())
+         members.push_back(std::vector<size_t>());
+      members[low].push_back(order[i]);
+      fronts[order[i]] = low;
+   }
+   return fronts;
+}
+
+std::vector<double> nonDominatedSorting::crowdingDistance(const std::vector<const multiObjectiveSolution*>& solutions,
+                                                          const std::vector<unsigned>& fronts) const
+{
+   assert(solutions.size() == fronts.size());
+
+   std::vector<double> distances(solutions.size(), 0);
+   std::vector<std::vector<size_t> > members;
+   for (size_t i = 0; i < fronts.size(); i++)
+   {
+      if (fronts[i] >= members.size())
+         members.resize(fronts[i] + 1);
+      members[fronts[i]].push_back(i);
+   }
+
+   objectiveOrder byObjective;
+   byObjective.solutions = &solutions;
+   for (size_t f = 0; f < members.size(); f++)
+   {
+      std::vector<size_t>& front = members[f];
+      if (front.size() <= 2)
+      {
+         for (size_t i = 0; i < front.size(); i++)
+            distances[front[i]] = INFd;
+         continue;
+      }
+
+      for (size_t j = 0; j < this->objectives.size(); j++)
+      {
+         byObjective.objective = this->objectives[j];
+         std::sort(front.begin(), front.end(), byObjective);
+
+         const T minimum = solutions[front.front()]->getObjective(byObjective.objective);
+         const T maximum = solutions[front.back()]->getObjective(byObjective.objective);
+         distances[front.front()] = INFd;
+         distances[front.back()] = INFd;
+         if (maximum == minimum)
+            continue;
+         for (size_t i = 1; i + 1 < front.size(); i++)
+            distances[front[i]] += (solutions[front[i + 1]]->getObjective(byObjective.objective) -
+                                    solutions[front[i - 1]]->getObjective(byObjective.objective)) / (maximum - minimum);
+      }
+   }
+   return distances;
+}
+
+std::vector<size_t> nonDominatedSorting::rank(const std::vector<const multiObjectiveSolution*>& solutions) const
+{
+   const std::vector<unsigned> fronts = sort(solutions);
+   const std::vector<double> distances = crowdingDistance(solutions, fronts);
+
+   std::vector<size_t> order(solutions.size());
+   for (size_t i = 0; i < order.size(); i++)
+      order[i] = i;
+
+   crowdedOrder crowded;
+   crowded.fronts = &fronts;
+   crowded.distances = &distances;
+   std::sort(order.begin(), order.end(), crowded);
+   return order;
+}
+
+inline std::vector<size_t> nonDominatedSorting::select(const std::vector<const multiObjectiveSolution*>& solutions, const size_t number) const
+{
+   std::vector<size_t> order = rank(solutions);
+   if (order.size() > number)
+      order.resize(number);
+   return order;
+}
+
+inline size_t nonDominatedSorting::best(const std::vector<const multiObjectiveSolution*>& solutions) const
+{
+   assert(!solutions.empty());
+   return rank(solutions)[0];
+}
+
+#endif
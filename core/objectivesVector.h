@@ -0,0 +1,209 @@
+/**
+   @class objectivesVector
+
+   @brief Fixed-capacity vector to store the values of the objectives.
+
+   Solutions are copied, compared and evaluated very often, so the values
+   of their objectives are kept inline in a small buffer instead of a
+   std::vector. The capacity is a template parameter (see MAXOBJECTIVES in
+   header.h) and the number of objectives in use is set when the problem is
+   set up (the first time a solution is evaluated). Copying or updating an
+   objectivesVector never allocates memory.
+
+   The class mimics the part of the std::vector interface the framework uses.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef OBJECTIVESVECTOR_H
+#define OBJECTIVESVECTOR_H
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+template <class Type, unsigned Capacity>
+class objectivesVector
+{
+   private:
+      /**
+         Values of the objectives.
+      */
+      Type values[Capacity];
+
+      /**
+         Number of objectives in use.
+      */
+      unsigned length;
+
+   protected:
+
+   public:
+      typedef Type value_type;
+      typedef Type* iterator;
+      typedef const Type* const_iterator;
+
+      /**
+         Default constructor. It creates an empty vector.
+      */
+      objectivesVector() : length(0) { };
+
+      /**
+         Constructor. It creates a vector of the given size.
+         @param const unsigned is the number of objectives.
+         @param const Type is the initial value of every objective.
+      */
+      explicit objectivesVector(const unsigned, const Type = Type());
+
+      /**
+         Copy constructor. Only the objectives in use are copied.
+         @param const objectivesVector& is the vector to copy from.
+      */
+      objectivesVector(const objectivesVector&);
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~objectivesVector() { };
+
+      /**
+         Assignment operator. Only the objectives in use are copied.
+         @param const objectivesVector& is the vector to copy from.
+         @return a reference to this object.
+      */
+      objectivesVector& operator=(const objectivesVector&);
+
+      unsigned size() const { return this->length; }
+      static unsigned capacity() { return Capacity; }
+      bool empty() const { return (this->length == 0); }
+      void clear() { this->length = 0; }
+
+      /**
+         Method that changes the number of objectives. New objectives are set to the given value.
+         @param const unsigned is the new number of objectives.
+         @param const Type is the value of the new objectives.
+      */
+      void resize(const unsigned, const Type = Type());
+
+      /**
+         Method that adds an objective at the end of the vector.
+         @param const Type is the value to be added.
+      */
+      void push_back(const Type);
+
+      Type& operator[](const unsigned i)
+      {     assert(i < this->length);
+            return this->values[i];              }
+
+      const Type& operator[](const unsigned i) const
+      {     assert(i < this->length);
+            return this->values[i];              }
+
+      iterator begin() { return this->values; }
+      iterator end() { return this->values + this->length; }
+      const_iterator begin() const { return this->values; }
+      const_iterator end() const { return this->values + this->length; }
+
+      Type* data() { return this->values; }
+      const Type* data() const { return this->values; }
+
+      bool operator==(const objectivesVector&) const;
+      bool operator!=(const objectivesVector& object) const { return !(*this == object); }
+};
+
+template <class Type, unsigned Capacity>
+objectivesVector<Type, Capacity>::objectivesVector(const unsigned n, const Type value)
+{
+   this->length = 0;
+   resize(n, value);
+}
+
+template <class Type, unsigned Capacity>
+objectivesVector<Type, Capacity>::objectivesVector(const objectivesVector& object)
+{
+   this->length = object.length;
+   for (unsigned i = 0; i < this->length; i++)
+      this->values[i] = object.values[i];
+}
+
+template <class Type, unsigned Capacity>
+inline objectivesVector<Type, Capacity>& objectivesVector<Type, Capacity>::operator=(const objectivesVector& object)
+{
+   this->length = object.length;
+   for (unsigned i = 0; i < this->length; i++)
+      this->values[i] = object.values[i];
+   return *this;
+}
+
+template <class Type, unsigned Capacity>
+inline void objectivesVector<Type, Capacity>::resize(const unsigned n, const Type value)
+{
+   if (n > Capacity)
+   {
+      std::cout << "Critical Error: the number of objectives (" << n << ") exceeds MAXOBJECTIVES ("
+                << Capacity << ") in objectivesVector.h" << std::endl;
+      exit(1);
+   }
+   for (unsigned i = this->length; i < n; i++)
+      this->values[i] = value;
+   this->length = n;
+}
+
+template <class Type, unsigned Capacity>
+inline void objectivesVector<Type, Capacity>::push_back(const Type value)
+{
+   resize(this->length + 1, value);
+}
+
+template <class Type, unsigned Capacity>
+inline bool objectivesVector<Type, Capacity>::operator==(const objectivesVector& object) const
+{
+   if (this->length != object.length)
+      return false;
+   for (unsigned i = 0; i < this->length; i++)
+      if (this->values[i] != object.values[i])
+         return false;
+   return true;
+}
+
+
+/**
+   @class objectivesView
+
+   @brief Read-only view of a sequence of objectives.
+
+   Score criteria compare objectives no matter where they are stored (the
+   buffer of a solution, a local objectivesVector or a boost::array of a
+   staticMultiObjectiveProblem). A view is just a pointer and a length, so
+   it is passed by value and never copies the values.
+*/
+template <class Type>
+class objectivesView
+{
+   private:
+      const Type* values;
+      unsigned length;
+
+   public:
+      /**
+         Constructor. It points the view to the given values.
+         @param const Type* is a pointer to the first value.
+         @param const unsigned is the number of values.
+      */
+      objectivesView(const Type* values, const unsigned length) : values(values), length(length) { };
+
+      /**
+         Constructor. It points the view to the values of an objectivesVector.
+         @param const objectivesVector& is the vector to be viewed.
+      */
+      template <unsigned Capacity>
+      objectivesView(const objectivesVector<Type, Capacity>& object) : values(object.data()), length(object.size()) { }
+
+      unsigned size() const { return this->length; }
+
+      const Type& operator[](const unsigned i) const
+      {     assert(i < this->length);
+            return this->values[i];              }
+};
+
+#endif
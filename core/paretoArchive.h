@@ -0,0 +1,298 @@
+/**
+   @class paretoArchive
+
+   @brief Bounded archive of the non-dominated solutions found by the agents.
+
+   The swarm keeps a single best solution, chosen by the score criterion of
+   the problem. This archive keeps a copy (see solutionSnapshot) of every
+   solution offered to it that no other archived solution dominates, so at
+   the end of a run it holds an approximation of the Pareto front over the
+   comparable objectives (see nonDominatedSorting). When a new solution
+   dominates archived ones they are removed, and when the archive is full
+   the solution in the most crowded region is dropped, as NSGA-II does.
+
+   The archive is guarded by a mutex, so agents running in parallel (see
+   asynchronousArchitecture) can share it. It is written into checkpoints with
+   the rest of the state of the swarm (see coDecentralizedArchitecture).
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef PARETOARCHIVE_H
+#define PARETOARCHIVE_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include <cassert>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "checkpoint.h"
+#include "header.h"
+#include "multiObjectiveSolution.h"
+#include "nonDominatedSorting.h"
+#include "solutionSnapshot.h"
+
+class paretoArchive
+{
+   private:
+      /**
+         Archived solutions.
+      */
+      std::vector<solutionSnapshot> solutions;
+
+      /**
+         Maximum number of solutions.
+      */
+      size_t capacity;
+
+      /**
+         Ranking used to compare and truncate the solutions.
+      */
+      nonDominatedSorting sorting;
+
+      /**
+         Mutex that guards the solutions.
+      */
+      pthread_mutex_t lock;
+
+      /**
+         Variables for statistical purposes: number of solutions offered and accepted.
+      */
+      unsigned long offered, accepted;
+
+      /**
+         Number of changes of the solutions: solutions archived and clearings.
+      */
+      unsigned long version;
+
+      /**
+         Method that drops the solution in the most crowded region.
+      */
+      void truncate();
+
+   protected:
+
+   public:
+      /**
+         Constructor.
+         @param const problemsType& is the set of problems, to know which objectives are comparable.
+         @param const size_t is the maximum number of solutions.
+         @param const std::string is "<global>" to consider the globally comparable objectives.
+      */
+      paretoArchive(const problemsType&, const size_t = 100, const std::string = " ");
+
+      /**
+         Default destructor. It releases the solutions.
+      */
+      ~paretoArchive();
+
+      /**
+         Method that offers a solution to the archive. A copy is kept unless an
+         archived solution dominates it or has the same objectives.
+         @param const multiObjectiveSolution* is the solution (it must be evaluated).
+         @return true if the solution was archived.
+      */
+      bool insert(const multiObjectiveSolution*);
+
+      /**
+         Method that returns the archived solutions.
+      */
+      std::vector<solutionSnapshot> getSolutions();
+
+      size_t size();
+
+      /**
+         Method that removes every solution, e.g. when the problem changes and the
+         archived solutions are no longer valid.
+      */
+      void clear();
+
+      /**
+         Method that returns the version of the archive, which changes every time
+         a solution is archived or the archive is cleared, so indicators are only
+         computed again when needed.
+      */
+      unsigned long getVersion();
+
+      size_t getCapacity() const { return this->capacity; }
+      const nonDominatedSorting& getSorting() const { return this->sorting; }
+
+      /**
+         Method that outputs the archived solutions, one per line.
+         @param std::ostream& is the stream.
+      */
+      void print(std::ostream&);
+
+      /**
+         Method that writes the archive into a checkpoint.
+         @param stateStream& is the stream.
+      */
+      void saveState(stateStream&);
+
+      /**
+         Method that reads the archive written by saveState. The archive must have
+         the same capacity.
+         @param stateStream& is the stream.
+         @param const multiObjectiveSolution* is a solution of the problem, which is
+         cloned to read the archived ones.
+         @return false if the stream failed or the capacity is different.
+      */
+      bool loadState(stateStream&, const multiObjectiveSolution*);
+};
+
+paretoArchive::paretoArchive(const problemsType& problems, const size_t capacity, const std::string options)
+   : sorting(problems, options)
+{
+   this->capacity = (capacity == 0) ? 1 : capacity;
+   this->offered = 0;
+   this->accepted = 0;
+   this->version = 0;
+   pthread_mutex_init(&(this->lock), NULL);
+}
+
+paretoArchive::~paretoArchive()
+{
+   pthread_mutex_destroy(&(this->lock));
+}
+
+bool paretoArchive::insert(const multiObjectiveSolution* solution)
+{
+   assert(solution != NULL);
+
+   pthread_mutex_lock(&(this->lock));
+   this->offered++;
+   for (size_t i = 0; i < this->solutions.size(); i++)
+      if (this->sorting.dominates(this->solutions[i].get(), solution) ||
+          this->solutions[i]->getObjectives() == solution->getObjectives())
+      {
+         pthread_mutex_unlock(&(this->lock));
+         return false;
+      }
+
+   // The solutions the new one dominates are removed keeping the order of the rest
+   size_t kept = 0;
+   for (size_t i = 0; i < this->solutions.size(); i++)
+      if (!this->sorting.dominates(solution, this->solutions[i].get()))
+         this->solutions[kept++] = this->solutions[i];
+   this->solutions.resize(kept);
+
+   this->solutions.push_back(solutionSnapshot(solution));
+   if (this->solutions.size() > this->capacity)
+      truncate();
+   this->accepted++;
+   this->version++;
+   pthread_mutex_unlock(&(this->lock));
+   return true;
+}
+
+inline void paretoArchive::truncate()
+{
+   std::vector<const multiObjectiveSolution*> candidates(this->solutions.size());
+   for (size_t i = 0; i < this->solutions.size(); i++)
+      candidates[i] = this->solutions[i].get();
+
+   // The last solution of the ranking is in the most crowded region
+   const std::vector<size_t> order = this->sorting.rank(candidates);
+   this->solutions.erase(this->solutions.begin() + order.back());
+}
+
+inline std::vector<solutionSnapshot> paretoArchive::getSolutions()
+{
+   pthread_mutex_lock(&(this->lock));
+   const std::vector<solutionSnapshot> solutions(this->solutions);
+   pthread_mutex_unlock(&(this->lock));
+   return solutions;
+}
+
+inline unsigned long paretoArchive::getVersion()
+{
+   pthread_mutex_lock(&(this->lock));
+   const unsigned long version = this->version;
+   pthread_mutex_unlock(&(this->lock));
+   return version;
+}
+
+inline void paretoArchive::clear()
+{
+   pthread_mutex_lock(&(this->lock));
+   this->solutions.clear();
+   this->version++;
+   pthread_mutex_unlock(&(this->lock));
+}
+
+inline size_t paretoArchive::size()
+{
+   pthread_mutex_lock(&(this->lock));
+   const size_t size = this->solutions.size();
+   pthread_mutex_unlock(&(this->lock));
+   return size;
+}
+
+void paretoArchive::print(std::ostream& output)
+{
+   pthread_mutex_lock(&(this->lock));
+   const std::vector<solutionSnapshot> solutions(this->solutions);
+   const unsigned long offered = this->offered, accepted = this->accepted;
+   pthread_mutex_unlock(&(this->lock));
+
+   output << "Pareto archive: " << solutions.size() << " solutions (" << accepted << " of "
+          << offered << " offered were archived)" << std::endl;
+   for (size_t i = 0; i < solutions.size(); i++)
+      output << solutions[i]->toString() << std::endl;
+}
+
+void paretoArchive::saveState(stateStream& state)
+{
+   pthread_mutex_lock(&(this->lock));
+   state.write<uint64_t>(this->capacity);
+   state.write(this->offered);
+   state.write(this->accepted);
+   state.write(this->version);
+   state.write<uint64_t>(this->solutions.size());
+   for (size_t i = 0; i < this->solutions.size(); i++)
+      this->solutions[i]->saveState(state);
+   pthread_mutex_unlock(&(this->lock));
+}
+
+bool paretoArchive::loadState(stateStream& state, const multiObjectiveSolution* prototype)
+{
+   assert(prototype != NULL);
+
+   uint64_t capacity = 0, size = 0;
+   unsigned long offered = 0, accepted = 0, version = 0;
+   state.read(capacity);
+   state.read(offered);
+   state.read(accepted);
+   state.read(version);
+   if (!state.read(size) || capacity != this->capacity || size > capacity)
+   {
+      state.fail();
+      return false;
+   }
+
+   std::vector<solutionSnapshot> solutions;
+   multiObjectiveSolution* solution = prototype->clone();
+   for (uint64_t i = 0; i < size; i++)
+   {
+      if (!solution->loadState(state))
+      {
+         delete(solution);
+         return false;
+      }
+      solutions.push_back(solutionSnapshot(solution));
+   }
+   delete(solution);
+
+   pthread_mutex_lock(&(this->lock));
+   this->solutions.swap(solutions);
+   this->offered = offered;
+   this->accepted = accepted;
+   this->version = version;
+   pthread_mutex_unlock(&(this->lock));
+   return true;
+}
+
+#endif
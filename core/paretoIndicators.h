@@ -0,0 +1,406 @@
+/**
+   @class paretoIndicators
+
+   @brief Quality indicators of the front held by a paretoArchive.
+
+   In Pareto mode there is no single best solution to follow the progress of
+   a run. This class measures the front held by an archive over the comparable
+   objectives:
+
+   - Hypervolume: the volume dominated by the front and bounded by a reference
+     point. It is computed exactly by slicing objectives (HSO, While et al.
+     2006), which takes O(N^(M-1) log N) for N solutions and M objectives, up
+     to HYPERVOLUMEEXACTDIMENSIONS objectives, and it is approximated by
+     Monte Carlo sampling (HYPERVOLUMESAMPLES points, with a fixed seed so the
+     value does not change while the front does not) for more objectives.
+     Unless it is given, the reference point is set the first time the
+     hypervolume is computed: the worst value of each objective in the
+     archive plus a 10% margin, so values are comparable along a run.
+
+   - IGD (inverted generational distance): the mean Euclidean distance from
+     each point of a reference front to the closest solution of the archive.
+     It is only available when a reference front is loaded.
+
+   The archive has a version that changes every time it changes, so update
+   only computes the indicators again when the archive has changed since the
+   last call. The archive changes rarely once the search has converged, so
+   the indicators can be updated every iteration.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef PARETOINDICATORS_H
+#define PARETOINDICATORS_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "checkpoint.h"
+#include "header.h"
+#include "paretoArchive.h"
+#include "solutionSnapshot.h"
+#include "../misc/MersenneTwister.h"
+
+/**
+   Maximum number of objectives for the hypervolume to be computed exactly.
+*/
+#ifndef HYPERVOLUMEEXACTDIMENSIONS
+#define HYPERVOLUMEEXACTDIMENSIONS 4
+#endif
+
+/**
+   Number of samples of the Monte Carlo approximation of the hypervolume.
+*/
+#ifndef HYPERVOLUMESAMPLES
+#define HYPERVOLUMESAMPLES 100000
+#endif
+
+class paretoIndicators
+{
+   private:
+      typedef std::vector<std::vector<T> > pointsType;
+
+      /**
+         Order of the points by a coordinate.
+      */
+      struct coordinateOrder
+      {
+         size_t coordinate;
+         bool operator()(const std::vector<T>& a, const std::vector<T>& b) const { return a[this->coordinate] < b[this->coordinate]; }
+      };
+
+      /**
+         Archive whose front is measured.
+      */
+      paretoArchive* archive;
+
+      /**
+         Reference point of the hypervolume (empty until it is set) and reference
+         front of IGD (empty if there is none), over the comparable objectives.
+      */
+      std::vector<T> referencePoint;
+      pointsType referenceFront;
+
+      /**
+         Version of the archive the indicators were computed for.
+      */
+      unsigned long version;
+      bool computed;
+
+      /**
+         Last values computed.
+      */
+      double hypervolume, IGD;
+
+      /**
+         Method that returns the points of the archive over the comparable objectives.
+      */
+      pointsType getPoints() const;
+
+      /**
+         Method that computes the exact hypervolume of the given points, over their
+         first coordinates, by slicing them along the last one.
+         @param pointsType& are the points. All of them must be better than the reference point.
+         @param const size_t is the number of coordinates.
+      */
+      double exactHypervolume(pointsType&, const size_t) const;
+
+      /**
+         Method that approximates the hypervolume of the given points by Monte Carlo.
+      */
+      double monteCarloHypervolume(const pointsType&) const;
+
+   protected:
+
+   public:
+      /**
+         Constructor.
+         @param paretoArchive* is the archive to be measured.
+      */
+      paretoIndicators(paretoArchive*);
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~paretoIndicators() { };
+
+      /**
+         Method that sets the reference point of the hypervolume.
+         @param const std::vector<T>& is the point, one value per comparable objective.
+      */
+      void setReferencePoint(const std::vector<T>&);
+
+      /**
+         Method that reads the reference front of IGD from a file with a point per line.
+         Each line has either a value per comparable objective or all the objectives of
+         a solution (as they are printed by paretoArchive::print).
+         @param const std::string& is the name of the file.
+         @return false if the file could not be read.
+      */
+      bool loadReferenceFront(const std::string&);
+
+      /**
+         Method that computes the indicators if the archive has changed.
+         @return true if they were computed.
+      */
+      bool update();
+
+      double getHypervolume() const { return this->hypervolume; }
+      double getIGD() const { return this->IGD; }
+      bool hasReferenceFront() const { return !this->referenceFront.empty(); }
+      const std::vector<T>& getReferencePoint() const { return this->referencePoint; }
+
+      /**
+         Methods that write the reference point of the hypervolume into a checkpoint
+         and read it back. The point is taken from the first front if it is not given,
+         so it is part of the state of a run.
+         @param stateStream& is the stream.
+         @return false if the stream failed.
+      */
+      void saveState(stateStream&) const;
+      bool loadState(stateStream&);
+};
+
+paretoIndicators::paretoIndicators(paretoArchive* archive)
+{
+   assert(archive != NULL);
+
+   this->archive = archive;
+   this->version = 0;
+   this->computed = false;
+   this->hypervolume = 0;
+   this->IGD = INFd;
+}
+
+inline void paretoIndicators::setReferencePoint(const std::vector<T>& point)
+{
+   assert(point.size() == this->archive->getSorting().getNumberOfObjectives());
+   this->referencePoint = point;
+   this->computed = false;
+}
+
+bool paretoIndicators::loadReferenceFront(const std::string& fileName)
+{
+   const std::vector<size_t>& objectives = this->archive->getSorting().getObjectives();
+   std::ifstream file(fileName.c_str());
+   if (!file)
+      return false;
+
+   pointsType front;
+   std::string line;
+   while (std::getline(file, line))
+   {
+      std::istringstream values(line);
+      std::vector<T> numbers;
+      T value;
+      while (values >> value)
+         numbers.push_back(value);
+      if (numbers.empty())
+         continue;
+
+      if (numbers.size() == objectives.size())
+         front.push_back(numbers);
+      else if (!objectives.empty() && numbers.size() > objectives.back())
+      {
+         std::vector<T> point(objectives.size());
+         for (size_t j = 0; j < objectives.size(); j++)
+            point[j] = numbers[objectives[j]];
+         front.push_back(point);
+      }
+      else
+         return false;
+   }
+   if (front.empty())
+      return false;
+
+   this->referenceFront = front;
+   this->computed = false;
+   return true;
+}
+
+inline paretoIndicators::pointsType paretoIndicators::getPoints() const
+{
+   const std::vector<size_t>& objectives = this->archive->getSorting().getObjectives();
+   const std::vector<solutionSnapshot> solutions = this->archive->getSolutions();
+
+   pointsType points(solutions.size(), std::vector<T>(objectives.size()));
+   for (size_t i = 0; i < solutions.size(); i++)
+      for (size_t j = 0; j < objectives.size(); j++)
+         points[i][j] = solutions[i]->getObjective(objectives[j]);
+   return points;
+}
+
+bool paretoIndicators::update()
+{
+   const unsigned long version = this->archive->getVersion();
+   if (this->computed && version == this->version)
+      return false;
+
+   pointsType points = getPoints();
+   this->version = version;
+   this->computed = true;
+   if (points.empty() || points[0].empty())
+   {
+      this->hypervolume = 0;
+      this->IGD = INFd;
+      return true;
+   }
+   const size_t dimensions = points[0].size();
+
+   if (this->referencePoint.empty())
+   {
+      this->referencePoint = points[0];
+      for (size_t i = 1; i < points.size(); i++)
+         for (size_t j = 0; j < dimensions; j++)
+            this->referencePoint[j] = std::max(this->referencePoint[j], points[i][j]);
+      for (size_t j = 0; j < dimensions; j++)
+         this->referencePoint[j] += std::max(0.1 * std::fabs(this->referencePoint[j]), 1.0);
+   }
+
+   // IGD
+   if (!this->referenceFront.empty())
+   {
+      double total = 0;
+      for (size_t r = 0; r < this->referenceFront.size(); r++)
+      {
+         double closest = INFd;
+         for (size_t i = 0; i < points.size(); i++)
+         {
+            double distance = 0;
+            for (size_t j = 0; j < dimensions; j++)
+               distance += (points[i][j] - this->referenceFront[r][j]) * (points[i][j] - this->referenceFront[r][j]);
+            closest = std::min(closest, distance);
+         }
+         total += std::sqrt(closest);
+      }
+      this->IGD = total / this->referenceFront.size();
+   }
+
+   // Hypervolume. Points that are not better than the reference point in every objective do not count
+   size_t kept = 0;
+   for (size_t i = 0; i < points.size(); i++)
+   {
+      bool inside = true;
+      for (size_t j = 0; j < dimensions && inside; j++)
+         inside = (points[i][j] < this->referencePoint[j]);
+      if (inside)
+         points[kept++] = points[i];
+   }
+   points.resize(kept);
+
+   this->hypervolume = (dimensions <= HYPERVOLUMEEXACTDIMENSIONS) ? exactHypervolume(points, dimensions) : monteCarloHypervolume(points);
+   return true;
+}
+
+double paretoIndicators::exactHypervolume(pointsType& points, const size_t dimensions) const
+{
+   if (points.empty())
+      return 0;
+
+   coordinateOrder order;
+   if (dimensions == 1)
+   {
+      T best = points[0][0];
+      for (size_t i = 1; i < points.size(); i++)
+         best = std::min(best, points[i][0]);
+      return this->referencePoint[0] - best;
+   }
+
+   if (dimensions == 2)
+   {
+      order.coordinate = 0;
+      std::sort(points.begin(), points.end(), order);
+      double volume = 0;
+      T bound = this->referencePoint[1];
+      for (size_t i = 0; i < points.size(); i++)
+         if (points[i][1] < bound)
+         {
+            volume += (this->referencePoint[0] - points[i][0]) * (bound - points[i][1]);
+            bound = points[i][1];
+         }
+      return volume;
+   }
+
+   // Each slice between two consecutive values of the last coordinate is dominated
+   //   by the points below it
+   const size_t last = dimensions - 1;
+   order.coordinate = last;
+   std::sort(points.begin(), points.end(), order);
+
+   double volume = 0;
+   pointsType slice;
+   for (size_t i = 0; i < points.size(); i++)
+   {
+      slice.push_back(points[i]);
+      const T upper = (i + 1 < points.size()) ? points[i + 1][last] : this->referencePoint[last];
+      if (upper > points[i][last])
+      {
+         pointsType projection(slice);
+         volume += (upper - points[i][last]) * exactHypervolume(projection, last);
+      }
+   }
+   return volume;
+}
+
+double paretoIndicators::monteCarloHypervolume(const pointsType& points) const
+{
+   if (points.empty())
+      return 0;
+
+   const size_t dimensions = points[0].size();
+   std::vector<T> lower(points[0]);
+   for (size_t i = 1; i < points.size(); i++)
+      for (size_t j = 0; j < dimensions; j++)
+         lower[j] = std::min(lower[j], points[i][j]);
+
+   double box = 1;
+   for (size_t j = 0; j < dimensions; j++)
+      box *= this->referencePoint[j] - lower[j];
+
+   // The generator is not the one of the agents, so measuring does not change the run
+   MTRand randomNumber(HYPERVOLUMESAMPLES);
+   std::vector<T> sample(dimensions);
+   unsigned long dominated = 0;
+   for (unsigned long s = 0; s < HYPERVOLUMESAMPLES; s++)
+   {
+      for (size_t j = 0; j < dimensions; j++)
+         sample[j] = lower[j] + randomNumber.rand() * (this->referencePoint[j] - lower[j]);
+      for (size_t i = 0; i < points.size(); i++)
+      {
+         size_t j = 0;
+         while (j < dimensions && points[i][j] <= sample[j])
+            j++;
+         if (j == dimensions)
+         {
+            dominated++;
+            break;
+         }
+      }
+   }
+   return box * dominated / HYPERVOLUMESAMPLES;
+}
+
+inline void paretoIndicators::saveState(stateStream& state) const
+{
+   state.writeVector(this->referencePoint);
+}
+
+inline bool paretoIndicators::loadState(stateStream& state)
+{
+   std::vector<T> point;
+   if (!state.readVector(point) || (!point.empty() && point.size() != this->archive->getSorting().getNumberOfObjectives()))
+   {
+      state.fail();
+      return false;
+   }
+   this->referencePoint = point;
+   this->computed = false;
+   return true;
+}
+
+#endif
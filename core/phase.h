@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "agent.h"
+#include "checkpoint.h"
 
 class agent;
 
@@ -89,6 +90,20 @@ class phase
          phase. This simply calls the inherited methods explained above.
       */
       void start(agent*, std::vector<agent*>*);     
+
+      /**
+         Virtual method that writes the state of the phase (counters, statistics...)
+         into a checkpoint. By default a phase has no state.
+         @param stateStream& is the stream.
+      */
+      virtual void saveState(stateStream&) const { };
+
+      /**
+         Virtual method that reads the state written by saveState.
+         @param stateStream& is the stream.
+         @return false if the stream failed.
+      */
+      virtual bool loadState(stateStream& state) { return state.good(); }
 };
 
 void phase::start(agent *currentAgent, std::vector<agent*>* team)
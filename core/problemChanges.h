@@ -0,0 +1,56 @@
+/**
+   @class problemChanges
+
+   @brief Interface of the changes a dynamic problem goes through during a run.
+
+   In a dynamic problem the instance changes while the system is running,
+   e.g. new orders arrive during the day. The system calls apply between two
+   iterations, when no agent is running its phases, so the changes can modify
+   the data of the problem and adapt the solutions of the agents to it (see
+   coDecentralizedArchitecture::setProblemChanges). The agents then keep
+   optimising the new instance from there.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef PROBLEMCHANGES_H
+#define PROBLEMCHANGES_H
+
+#include <vector>
+
+#include "agent.h"
+#include "header.h"
+
+class problemChanges
+{
+   private:
+
+   protected:
+
+   public:
+      /**
+         Default constructor. It does nothing.
+      */
+      problemChanges() { };
+
+      /**
+         Default destructor. It does nothing.
+      */
+      virtual ~problemChanges() { };
+
+      /**
+         Method that applies the changes that are due.
+         @param const iterationType is the current iteration of the system.
+         @param std::vector<agent*>* is the set of agents, whose solutions must be adapted.
+         @return true if the problem has changed.
+      */
+      virtual bool apply(const iterationType, std::vector<agent*>*) = 0;
+
+      /**
+         Method that is called once the system stops.
+         @param std::vector<agent*>* is the set of agents.
+      */
+      virtual void finish(std::vector<agent*>*) { };
+};
+
+#endif
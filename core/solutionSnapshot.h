@@ -0,0 +1,176 @@
+/**
+   @class solutionSnapshot
+
+   @brief Immutable, reference-counted copy of a solution to be sent to other agents.
+
+   Agents used to send the pointer to their current solution, so the
+   receivers read a solution the sender could be changing and the
+   messages were only valid until the end of the iteration. A snapshot
+   is a read-only copy of the solution shared by every holder: copying
+   a snapshot (putting it in a message, in a mailbox or keeping it for
+   later) only increases a counter, and the copy of the solution is
+   deleted when the last holder releases it. The counter is atomic, so
+   agents in different threads can hold and read the same snapshot
+   without locks.
+
+   The copy is only made on write: the owner of a snapshot calls assign
+   with its solution when it wants to publish it. If nobody else holds
+   the snapshot, the same copy is overwritten and nothing is allocated;
+   otherwise the snapshot is detached and a new copy is made, so the
+   holders of the previous one are not affected.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef SOLUTIONSNAPSHOT_H
+#define SOLUTIONSNAPSHOT_H
+
+#include <cassert>
+#include <cstddef>
+
+#include "multiObjectiveSolution.h"
+
+class solutionSnapshot
+{
+   private:
+      /**
+         Copy of the solution and number of snapshots that share it.
+      */
+      struct sharedSolution
+      {
+         multiObjectiveSolution* solution;
+         volatile unsigned references;
+      };
+
+      /**
+         Shared copy. NULL if the snapshot is empty.
+      */
+      sharedSolution* shared;
+
+      /**
+         Method that releases the shared copy and deletes it if this
+         was the last snapshot holding it.
+      */
+      void release();
+
+   protected:
+
+   public:
+      /**
+         Default constructor. It creates an empty snapshot.
+      */
+      solutionSnapshot() : shared(NULL) { };
+
+      /**
+         Constructor. It makes a copy of the given solution.
+         @param const multiObjectiveSolution* is the solution to be copied.
+      */
+      explicit solutionSnapshot(const multiObjectiveSolution*);
+
+      /**
+         Copy constructor. It shares the copy of the given snapshot.
+      */
+      solutionSnapshot(const solutionSnapshot&);
+
+      /**
+         Destructor. It releases the shared copy.
+      */
+      ~solutionSnapshot() { release(); }
+
+      /**
+         Assignment operator. It releases the current copy and shares the one
+         of the given snapshot.
+      */
+      solutionSnapshot& operator=(const solutionSnapshot&);
+
+      /**
+         Method that sets the snapshot to the given solution. The copy is reused
+         if this is the only snapshot holding it.
+         @param const multiObjectiveSolution* is the solution to be copied.
+      */
+      void assign(const multiObjectiveSolution*);
+
+      /**
+         Method that empties the snapshot.
+      */
+      void reset() { release(); }
+
+      /**
+         Method that returns whether the snapshot holds the same solution as the
+         given one, comparing the solutions (see multiObjectiveSolution::equals)
+         and their objectives. A signature tells solutions apart, but two
+         different solutions may share it (e.g. route-plans that only differ in
+         the order of their routes).
+         @param const multiObjectiveSolution* is the solution to be compared with.
+      */
+      bool holds(const multiObjectiveSolution*) const;
+
+      const multiObjectiveSolution* get() const { return (this->shared == NULL) ? NULL : this->shared->solution; }
+      const multiObjectiveSolution* operator->() const { assert(this->shared != NULL); return this->shared->solution; }
+      bool isEmpty() const { return (this->shared == NULL); }
+      unsigned getReferences() const { return (this->shared == NULL) ? 0 : this->shared->references; }
+};
+
+solutionSnapshot::solutionSnapshot(const multiObjectiveSolution* solution)
+{
+   this->shared = NULL;
+   assign(solution);
+}
+
+solutionSnapshot::solutionSnapshot(const solutionSnapshot& snapshot)
+{
+   this->shared = snapshot.shared;
+   if (this->shared != NULL)
+      __sync_fetch_and_add(&(this->shared->references), 1);
+}
+
+inline solutionSnapshot& solutionSnapshot::operator=(const solutionSnapshot& snapshot)
+{
+   // The new copy is taken before releasing the current one (they may be the same,
+   //   and the given snapshot may be this one)
+   sharedSolution* shared = snapshot.shared;
+   if (shared != NULL)
+      __sync_fetch_and_add(&(shared->references), 1);
+   release();
+   this->shared = shared;
+   return *this;
+}
+
+inline void solutionSnapshot::release()
+{
+   if (this->shared != NULL && __sync_sub_and_fetch(&(this->shared->references), 1) == 0)
+   {
+      delete(this->shared->solution);
+      delete(this->shared);
+   }
+   this->shared = NULL;
+}
+
+inline void solutionSnapshot::assign(const multiObjectiveSolution* solution)
+{
+   assert(solution != NULL);
+
+   // Nobody else can read the copy, so it is overwritten
+   if (this->shared != NULL && __sync_add_and_fetch(&(this->shared->references), 0) == 1)
+      this->shared->solution->copy(solution);
+   else
+   {
+      release();
+      this->shared = new sharedSolution;
+      this->shared->solution = solution->clone();
+      this->shared->references = 1;
+   }
+
+   // The signature is computed now, so the readers never write the copy
+   this->shared->solution->getHash();
+}
+
+inline bool solutionSnapshot::holds(const multiObjectiveSolution* solution) const
+{
+   if (this->shared == NULL || solution == NULL)
+      return false;
+   return (this->shared->solution->equals(solution) &&
+           this->shared->solution->getObjectives() == solution->getObjectives());
+}
+
+#endif
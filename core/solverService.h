@@ -0,0 +1,518 @@
+/**
+   @class solverService
+
+   @brief Daemon that solves the requests of local clients.
+
+   Running the program once per problem pays the start of the process, the
+   reading of the instance and the precomputations (e.g. a distance matrix)
+   every time. This class listens on a Unix-domain socket, so it is only
+   reachable from the same host, and solves the requests that arrive there.
+   A request is a line with the same words as a command line,
+
+      solve <instance> <positional arguments> [name=value ...]
+
+   where the instance is a file name or '-' if the data comes in the request,
+   in the following lines and up to a line with a single '.'. The answer is a
+   stream of lines: 'info ...' lines, 'best ...' lines every time the best
+   solution improves (see improvementStream), and a last line that is either
+   'done ...' or 'error <message>'.
+
+   The agents, their parameters and the data of the problem live in
+   singletons, so a process can only run a system at a time. Each request is
+   run by a child process (fork), at most a given number at a time, and the
+   rest wait in the queue of the socket. The daemon itself never runs
+   threads, so forking is safe, and it keeps the data the children need in
+   memory: subclasses prepare it in the daemon before forking (e.g. a cache
+   of instances), so the children find it ready, copy-on-write. The daemon
+   keeps its end of each connection until the child finishes, so it can
+   tell the client when a child dies without an answer.
+
+   Subclasses implement prepare (in the daemon) and serve (in the child).
+   The client side is request, which sends a request and copies the answer
+   into a stream as it arrives.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef SOLVERSERVICE_H
+#define SOLVERSERVICE_H
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "header.h"
+#include "../libs/conversions.h"
+
+/**
+   Milliseconds the daemon waits for each part of a request before dropping it.
+*/
+#ifndef SOLVERSERVICETIMEOUT
+#define SOLVERSERVICETIMEOUT 5000
+#endif
+
+/**
+   Maximum size of a request, with its data (bytes).
+*/
+#ifndef SOLVERSERVICEMAXREQUEST
+#define SOLVERSERVICEMAXREQUEST (64 << 20)
+#endif
+
+/**
+   Request of a client.
+*/
+struct solverRequest
+{
+   /**
+      Words of the request line after 'solve'. The first one is the instance.
+   */
+   std::vector<std::string> arguments;
+
+   /**
+      Data of the instance, if it came with the request.
+   */
+   std::string data;
+};
+
+/**
+   Buffer of a stream that writes into a file descriptor (e.g. a socket).
+*/
+class descriptorBuffer : public std::streambuf
+{
+   private:
+      int descriptor;
+      char buffer[4096];
+
+   protected:
+      int overflow(int);
+      int sync();
+
+   public:
+      descriptorBuffer(const int descriptor) : descriptor(descriptor) { setp(this->buffer, this->buffer + sizeof(this->buffer)); }
+      ~descriptorBuffer() { sync(); }
+};
+
+class solverService
+{
+   private:
+      /**
+         Name of the socket and descriptor it listens on.
+      */
+      std::string socketName;
+      int listener;
+
+      /**
+         Maximum number of requests solved at a time, and running children with the
+         connections of their clients.
+      */
+      unsigned maxJobs;
+      std::map<pid_t, int> jobs;
+
+      /**
+         Method that collects the children that have finished. It tells their
+         clients if they did not finish well.
+         @param const bool is true to wait for one of them.
+      */
+      void reap(const bool);
+
+      /**
+         Method that reads a request.
+         @return false if it could not be read. The reason is in the string.
+      */
+      static bool readRequest(const int, solverRequest&, std::string&);
+
+      /**
+         Method that starts the child that serves a request.
+      */
+      void dispatch(const int, const solverRequest&);
+
+   protected:
+      /**
+         Method that runs in the daemon before a request is served, to check it and to
+         prepare the data it needs.
+         @param const solverRequest& is the request.
+         @param std::ostream& is the stream of the client ('info' lines).
+         @param std::string& is where the reason is returned if the request is refused.
+         @return false to refuse the request.
+      */
+      virtual bool prepare(const solverRequest&, std::ostream&, std::string&) = 0;
+
+      /**
+         Method that runs in the child to serve a request. It must write the 'done' line.
+         @param const solverRequest& is the request.
+         @param const int is the connection of the client.
+         @return the exit status of the child.
+      */
+      virtual int serve(const solverRequest&, const int) = 0;
+
+   public:
+      /**
+         Constructor. It does not listen until run is called.
+         @param const std::string& is the name of the socket.
+         @param const unsigned is the number of requests solved at a time.
+      */
+      solverService(const std::string&, const unsigned);
+
+      /**
+         Destructor. It removes the socket.
+      */
+      virtual ~solverService();
+
+      unsigned getMaxJobs() const { return this->maxJobs; }
+
+      /**
+         Method that serves requests until the daemon gets SIGINT or SIGTERM. Running
+         children are stopped then.
+      */
+      void run();
+
+      /**
+         Method that sends a request to a daemon and copies its answer into a stream.
+         @param const std::string& is the name of the socket.
+         @param const solverRequest& is the request.
+         @param std::ostream& is the stream.
+         @return 0 if the last line of the answer is a 'done' line, 1 otherwise.
+      */
+      static int request(const std::string&, const solverRequest&, std::ostream&);
+};
+
+/**
+   Flag set by the signals that stop the daemon.
+*/
+volatile sig_atomic_t solverServiceStop = 0;
+
+extern "C" void solverServiceSignal(int)
+{
+   solverServiceStop = 1;
+}
+
+/**
+   Method that writes a whole buffer into a descriptor.
+*/
+inline bool writeToDescriptor(const int descriptor, const char* data, size_t length)
+{
+   while (length > 0)
+   {
+      const ssize_t written = write(descriptor, data, length);
+      if (written < 0 && errno == EINTR)
+         continue;
+      if (written <= 0)
+         return false;
+      data += written;
+      length -= written;
+   }
+   return true;
+}
+
+int descriptorBuffer::overflow(int character)
+{
+   if (sync() != 0)
+      return traits_type::eof();
+   if (character != traits_type::eof())
+   {
+      *pptr() = character;
+      pbump(1);
+   }
+   return traits_type::not_eof(character);
+}
+
+int descriptorBuffer::sync()
+{
+   const bool written = writeToDescriptor(this->descriptor, pbase(), pptr() - pbase());
+   setp(this->buffer, this->buffer + sizeof(this->buffer));
+   return written ? 0 : -1;
+}
+
+solverService::solverService(const std::string& socketName, const unsigned maxJobs)
+{
+   this->socketName = socketName;
+   this->maxJobs = (maxJobs == 0) ? 1 : maxJobs;
+   this->listener = -1;
+}
+
+solverService::~solverService()
+{
+   if (this->listener >= 0)
+   {
+      close(this->listener);
+      unlink(this->socketName.c_str());
+   }
+}
+
+bool solverService::readRequest(const int client, solverRequest& request, std::string& error)
+{
+   std::string received;
+   size_t endOfLine = std::string::npos;
+   bool inlineData = false;
+   char buffer[4096];
+
+   while (true)
+   {
+      if (endOfLine == std::string::npos && (endOfLine = received.find('\n')) != std::string::npos)
+      {
+         std::istringstream words(received.substr(0, endOfLine));
+         std::string word;
+         words >> word;
+         if (word != "solve")
+         {
+            error = "unknown request: " + word;
+            return false;
+         }
+         while (words >> word)
+            request.arguments.push_back(word);
+         if (request.arguments.empty())
+         {
+            error = "the request has no instance";
+            return false;
+         }
+         inlineData = (request.arguments[0] == "-");
+      }
+
+      if (endOfLine != std::string::npos)
+      {
+         if (!inlineData)
+            return true;
+         // The data ends with a line with a single dot
+         const size_t end = received.find("\n.\n", endOfLine);
+         if (end != std::string::npos)
+         {
+            request.data = received.substr(endOfLine + 1, end + 1 - (endOfLine + 1));
+            return true;
+         }
+      }
+
+      if (received.size() > SOLVERSERVICEMAXREQUEST)
+      {
+         error = "the request is too large";
+         return false;
+      }
+      pollfd waiting;
+      waiting.fd = client;
+      waiting.events = POLLIN;
+      if (poll(&waiting, 1, SOLVERSERVICETIMEOUT) <= 0)
+      {
+         error = "the request is incomplete";
+         return false;
+      }
+      const ssize_t length = read(client, buffer, sizeof(buffer));
+      if (length <= 0)
+      {
+         error = "the request is incomplete";
+         return false;
+      }
+      received.append(buffer, length);
+   }
+}
+
+void solverService::reap(const bool wait)
+{
+   int status;
+   pid_t child;
+   while (!this->jobs.empty() && (child = waitpid(-1, &status, wait ? 0 : WNOHANG)) != 0)
+   {
+      if (child < 0)
+      {
+         if (errno == EINTR && !solverServiceStop)
+            continue;
+         return;
+      }
+      std::map<pid_t, int>::iterator job = this->jobs.find(child);
+      if (job == this->jobs.end())
+         continue;
+
+      // The child writes the last line itself when it finishes well
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      {
+         const std::string line = "error the solver stopped (" + std::string(WIFEXITED(status) ? "status " : "signal ") +
+                                  somethingToString(WIFEXITED(status) ? WEXITSTATUS(status) : WTERMSIG(status)) + ")\n";
+         writeToDescriptor(job->second, line.c_str(), line.size());
+      }
+      close(job->second);
+      this->jobs.erase(job);
+      if (wait)
+         return;
+   }
+}
+
+void solverService::dispatch(const int client, const solverRequest& request)
+{
+   std::cout.flush();
+   std::cerr.flush();
+   const pid_t child = fork();
+   if (child < 0)
+   {
+      const std::string line = "error cannot start the solver\n";
+      writeToDescriptor(client, line.c_str(), line.size());
+      close(client);
+      return;
+   }
+
+   if (child == 0)
+   {
+      // The child only keeps its own connection. It stops when its client leaves
+      close(this->listener);
+      this->listener = -1;
+      for (std::map<pid_t, int>::iterator job = this->jobs.begin(); job != this->jobs.end(); ++job)
+         close(job->second);
+      this->jobs.clear();
+      signal(SIGPIPE, SIG_DFL);
+      signal(SIGINT, SIG_DFL);
+      signal(SIGTERM, SIG_DFL);
+
+      const int status = serve(request, client);
+      std::cout.flush();
+      std::cerr.flush();
+      // Singletons and buffers are not cleaned up: they are copies of those of the daemon
+      _exit(status);
+   }
+   this->jobs[child] = client;
+}
+
+void solverService::run()
+{
+   sockaddr_un address;
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   if (this->socketName.size() >= sizeof(address.sun_path))
+   {
+      std::cout << "ERROR[!] The name of the socket is too long: " << this->socketName << std::endl;
+      exit(1);
+   }
+   strcpy(address.sun_path, this->socketName.c_str());
+
+   unlink(this->socketName.c_str());
+   this->listener = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (this->listener < 0 || bind(this->listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(this->listener, 64) != 0)
+   {
+      std::cout << "ERROR[!] Cannot listen on " << this->socketName << ": " << strerror(errno) << std::endl;
+      exit(1);
+   }
+
+   // Signals interrupt the waits instead of restarting them
+   struct sigaction action;
+   memset(&action, 0, sizeof(action));
+   action.sa_handler = &solverServiceSignal;
+   sigemptyset(&action.sa_mask);
+   sigaction(SIGINT, &action, NULL);
+   sigaction(SIGTERM, &action, NULL);
+   signal(SIGPIPE, SIG_IGN);
+
+   std::cerr << "Listening on " << this->socketName << " (" << this->maxJobs << " requests at a time)" << std::endl;
+   while (!solverServiceStop)
+   {
+      reap(false);
+      if (this->jobs.size() >= this->maxJobs)
+      {
+         reap(true);
+         continue;
+      }
+
+      // Finished children are collected at least every half a second
+      pollfd waiting;
+      waiting.fd = this->listener;
+      waiting.events = POLLIN;
+      if (poll(&waiting, 1, 500) <= 0)
+         continue;
+      const int client = accept(this->listener, NULL, NULL);
+      if (client < 0)
+         continue;
+
+      solverRequest request;
+      std::string error;
+      descriptorBuffer buffer(client);
+      std::ostream answer(&buffer);
+      if (!readRequest(client, request, error) || !prepare(request, answer, error))
+      {
+         answer << "error " << error << "\n" << std::flush;
+         close(client);
+         continue;
+      }
+      answer.flush();
+      dispatch(client, request);
+   }
+
+   for (std::map<pid_t, int>::iterator job = this->jobs.begin(); job != this->jobs.end(); ++job)
+      kill(job->first, SIGTERM);
+   solverServiceStop = 0;
+   while (!this->jobs.empty())
+      reap(true);
+   std::cerr << "Stopped" << std::endl;
+}
+
+int solverService::request(const std::string& socketName, const solverRequest& request, std::ostream& output)
+{
+   sockaddr_un address;
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   strncpy(address.sun_path, socketName.c_str(), sizeof(address.sun_path) - 1);
+
+   const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (server < 0 || connect(server, (sockaddr*)&address, sizeof(address)) != 0)
+   {
+      std::cout << "ERROR[!] Cannot connect to " << socketName << ": " << strerror(errno) << std::endl;
+      exit(1);
+   }
+
+   std::string message = "solve";
+   for (size_t i = 0; i < request.arguments.size(); i++)
+      message += " " + request.arguments[i];
+   message += "\n";
+   if (!request.data.empty())
+   {
+      message += request.data;
+      if (message[message.size() - 1] != '\n')
+         message += "\n";
+      message += ".\n";
+   }
+   signal(SIGPIPE, SIG_IGN);
+   writeToDescriptor(server, message.c_str(), message.size());
+
+   // Lines are copied as they arrive, until the daemon closes the connection. The
+   //   answer is only good if nothing comes after the 'done' line
+   std::string received, line;
+   char buffer[4096];
+   ssize_t length;
+   int status = 1;
+   while ((length = read(server, buffer, sizeof(buffer))) != 0)
+   {
+      if (length < 0)
+      {
+         if (errno == EINTR)
+            continue;
+         break;
+      }
+      received.append(buffer, length);
+      size_t end;
+      while ((end = received.find('\n')) != std::string::npos)
+      {
+         line = received.substr(0, end);
+         received.erase(0, end + 1);
+         output << line << std::endl;
+         status = (line.compare(0, 5, "done ") == 0) ? 0 : 1;
+      }
+   }
+   close(server);
+   if (!received.empty())
+   {
+      output << received << std::endl;
+      status = 1;
+   }
+   return status;
+}
+
+#endif
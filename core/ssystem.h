@@ -101,7 +101,8 @@
 #ifndef SYSTEM_H
 #define SYSTEM_H
 
-#include <vector>
+#include <set>
+#include <vector>
 
 #include "agent.h"
 #include "multiObjectiveSolution.h"
@@ -193,7 +194,7 @@ class ssystem
       /**
          Default destructor. It frees all the memory used by this class.
       */
-      ~ssystem();
+      virtual ~ssystem();
 
       /** 
          Method that returns the group of agent the system has.
@@ -292,10 +293,19 @@ ssystem::ssystem()
 
 ssystem::~ssystem()
 {
-   delete(this->bestSolution); 
+   // The agents may share their best solution (with the system too), so each one
+   //   is deleted once
+   std::set<multiObjectiveSolution*> bestSolutions;
+   bestSolutions.insert(this->bestSolution);
+   for (unsigned i = 0; i < agents.size(); i++)
+      if (this->agents[i]->getCore() != NULL)
+         bestSolutions.insert(this->agents[i]->getCore()->releaseBestSolution());
+
    delete(this->stopController);
    for (unsigned i = 0; i < agents.size(); i++)
       delete(this->agents[i]);
+   for (std::set<multiObjectiveSolution*>::iterator solution = bestSolutions.begin(); solution != bestSolutions.end(); ++solution)
+      delete(*solution);
 }
 
 inline std::vector<agent*> ssystem::getAgents()
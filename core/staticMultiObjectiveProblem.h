@@ -0,0 +1,455 @@
+/**
+   @class staticMultiObjectiveProblem
+
+   @brief Deals with multi-objective problems whose objectives are known at compile time.
+
+   This class is an alternative to multiObjectiveProblem. Instead of holding
+   a vector of pointers to singleObjectiveProblem, the list of objectives is
+   given as a template parameter (a typelist built with 'objectiveList').
+   Each objective is stored by value, so its 'evaluate' method is bound at
+   compile time and can be inlined. The values of the objectives are stored
+   in a boost::array whose size is the length of the list, and both the
+   Pareto and the lexicographic comparators are unrolled by the compiler.
+
+   An objective list is written as follows:
+   \code
+      typedef objectiveList<staticObjective<firstProblem, 1, true, true>,
+              objectiveList<staticObjective<secondProblem, 0, true, false>,
+              objectiveListEnd> > myObjectives;
+   \endcode
+   where the second parameter of 'staticObjective' is the priority of the
+   objective and the last two are the 'comparable' and 'globalComparable'
+   flags (see singleObjectiveProblem).
+
+   The class staticMultiObjectiveProblemAdapter wraps this problem behind
+   the interface of multiObjectiveProblem, thus agents and phases can work
+   with either form.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef STATICMULTIOBJECTIVEPROBLEM_H
+#define STATICMULTIOBJECTIVEPROBLEM_H
+
+#include <algorithm>
+#include <string>
+
+#include "../libs/boost/array.hpp"
+
+#include "header.h"
+#include "multiObjectiveSolution.h"
+#include "multiObjectiveProblem.h"
+
+/**
+   Marks the end of an objective list.
+*/
+struct objectiveListEnd { };
+
+/**
+   Describes one objective of the list: the class that evaluates it, its
+   priority and whether it is comparable and global-comparable.
+*/
+template <class Problem, unsigned Priority, bool Comparable, bool GlobalComparable>
+struct staticObjective
+{
+   typedef Problem problemType;
+
+   enum { priority = Priority };
+   enum { comparable = Comparable };
+   enum { globalComparable = GlobalComparable };
+};
+
+/**
+   Node of a list of objectives.
+*/
+template <class Head, class Tail = objectiveListEnd>
+struct objectiveList
+{
+   typedef Head head;
+   typedef Tail tail;
+};
+
+/**
+   Number of objectives in a list.
+*/
+template <class List>
+struct objectiveListLength
+{
+   enum { value = 1 + objectiveListLength<typename List::tail>::value };
+};
+
+template <>
+struct objectiveListLength<objectiveListEnd>
+{
+   enum { value = 0 };
+};
+
+/**
+   Position of the objective with the given priority. If there is no such
+   objective, the value is the length of the list.
+*/
+template <class List, unsigned Priority, unsigned Index = 0>
+struct indexOfPriority
+{
+   enum { value = ((unsigned)List::head::priority == Priority) ?
+                  Index :
+                  (unsigned)indexOfPriority<typename List::tail, Priority, Index + 1>::value };
+};
+
+template <unsigned Priority, unsigned Index>
+struct indexOfPriority<objectiveListEnd, Priority, Index>
+{
+   enum { value = Index };
+};
+
+/**
+   Set of objectives. It holds an instance of every problem of the list
+   and evaluates all of them in a row.
+*/
+template <class List>
+class objectiveSet
+{
+   private:
+      /**
+         Problem that evaluates the first objective of the list.
+      */
+      typename List::head::problemType problem;
+
+      /**
+         Remaining objectives.
+      */
+      objectiveSet<typename List::tail> rest;
+
+   protected:
+
+   public:
+      /**
+         Default constructor. It sets the priority and the flags of every problem.
+      */
+      objectiveSet()
+      {
+         problem.setPriority(List::head::priority);
+         problem.setIsComparable(List::head::comparable);
+         problem.setIsGlobalComparable(List::head::globalComparable);
+      }
+
+      /**
+         Method that evaluates every objective and stores the values from the given position on.
+         @param const Argument& is what the problems receive (a solution or a part of it).
+         @param T* is a pointer to the place where the first value is written.
+      */
+      template <class Argument>
+      void evaluate(const Argument& argument, T* values) const
+      {
+         *values = problem.evaluate(argument);
+         rest.evaluate(argument, values + 1);
+      }
+
+      /**
+         Method that adds the problems of this set to a multiObjectiveProblem, so its
+         vector of problems describes the same objectives.
+         @param multiObjectiveProblem* is the problem where the objectives are added.
+      */
+      void addTo(multiObjectiveProblem* MOP)
+      {
+         MOP->addProblem(&problem);
+         rest.addTo(MOP);
+      }
+};
+
+template <>
+class objectiveSet<objectiveListEnd>
+{
+   public:
+      template <class Argument>
+      void evaluate(const Argument&, T*) const { }
+
+      void addTo(multiObjectiveProblem*) { }
+};
+
+/**
+   Pareto comparator. It follows the same rules as basicParetoFrontMOScoreCriterion, but
+   only the objectives that are (global-)comparable are visited.
+*/
+template <class List, bool Global>
+struct dominanceComparator
+{
+   enum { considered = Global ? (bool)List::head::globalComparable : (bool)List::head::comparable };
+
+   static void count(const T* first, const T* second, unsigned& firstSum, unsigned& secondSum, unsigned& comparableProblems)
+   {
+      if (considered)
+      {
+         if (*first == *second)
+         {
+            firstSum++;
+            secondSum++;
+         }
+         else if (*first < *second)
+            firstSum++;
+         else
+            secondSum++;
+         comparableProblems++;
+      }
+      dominanceComparator<typename List::tail, Global>::count(first + 1, second + 1, firstSum, secondSum, comparableProblems);
+   }
+};
+
+template <bool Global>
+struct dominanceComparator<objectiveListEnd, Global>
+{
+   static void count(const T*, const T*, unsigned&, unsigned&, unsigned&) { }
+};
+
+/**
+   Lexicographic comparator. Objectives are compared from priority 'Priority'
+   to 'Last - 1'. Unlike lexicographicMOScoreCriterion, the order is fixed.
+*/
+template <class List, unsigned Priority, unsigned Last>
+struct lexicographicComparator
+{
+   enum { index = indexOfPriority<List, Priority>::value };
+
+   static triBool compare(const T* first, const T* second)
+   {
+      if ((unsigned)index < Last)
+      {
+         if (first[index] < second[index])
+            return triBool(true);
+         if (first[index] > second[index])
+            return triBool(false);
+      }
+      return lexicographicComparator<List, Priority + 1, Last>::compare(first, second);
+   }
+};
+
+template <class List, unsigned Last>
+struct lexicographicComparator<List, Last, Last>
+{
+   static triBool compare(const T*, const T*) { return triBool(null); }
+};
+
+
+template <class List>
+class staticMultiObjectiveProblem
+{
+   public:
+      enum { numberOfObjectives = objectiveListLength<List>::value };
+
+      /**
+         Fixed-size vector of objectives.
+      */
+      typedef boost::array<T, numberOfObjectives> staticObjectivesType;
+
+   private:
+      /**
+         Instances of the objectives.
+      */
+      objectiveSet<List> objectives;
+
+   protected:
+
+   public:
+      /**
+         Default constructor. It does nothing.
+      */
+      staticMultiObjectiveProblem() { };
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~staticMultiObjectiveProblem() { };
+
+      /**
+         Method that evaluates all the objectives.
+         @param const Argument& is what the problems receive (a solution or a part of it).
+         @param staticObjectivesType& is where the values are written.
+      */
+      template <class Argument>
+      void evaluate(const Argument&, staticObjectivesType&) const;
+
+      /**
+         Method that returns (True/False/Undefined) using Pareto dominance.
+         @param const T* is a pointer to the objectives of the first solution.
+         @param const T* is a pointer to the objectives of the second solution.
+         @param const bool is true if the global-comparable objectives are used.
+         @return a triBool object (see basicParetoFrontMOScoreCriterion).
+      */
+      static triBool firstIsBetterPareto(const T*, const T*, const bool);
+
+      /**
+         Method that returns (True/False/Undefined) using the priorities of the objectives.
+         @param const T* is a pointer to the objectives of the first solution.
+         @param const T* is a pointer to the objectives of the second solution.
+         @return a triBool object.
+      */
+      static triBool firstIsBetterLexicographic(const T*, const T*);
+
+      /**
+         Method that returns the set of objectives.
+         @return a reference to the objectives of this problem.
+      */
+      objectiveSet<List>& getObjectiveSet();
+};
+
+template <class List>
+template <class Argument>
+inline void staticMultiObjectiveProblem<List>::evaluate(const Argument& argument, staticObjectivesType& values) const
+{
+   this->objectives.evaluate(argument, values.c_array());
+}
+
+template <class List>
+inline triBool staticMultiObjectiveProblem<List>::firstIsBetterPareto(const T* first, const T* second, const bool global)
+{
+   unsigned firstSum = 0;
+   unsigned secondSum = 0;
+   unsigned comparableProblems = 0;
+
+   if (global)
+      dominanceComparator<List, true>::count(first, second, firstSum, secondSum, comparableProblems);
+   else
+      dominanceComparator<List, false>::count(first, second, firstSum, secondSum, comparableProblems);
+
+   if (firstSum == secondSum)
+       return triBool(null);
+
+   if (firstSum == comparableProblems)
+      return triBool(true);
+
+   if (secondSum == comparableProblems)
+      return triBool(false);
+
+   return triBool(null);
+}
+
+template <class List>
+inline triBool staticMultiObjectiveProblem<List>::firstIsBetterLexicographic(const T* first, const T* second)
+{
+   return lexicographicComparator<List, 0, numberOfObjectives>::compare(first, second);
+}
+
+template <class List>
+inline objectiveSet<List>& staticMultiObjectiveProblem<List>::getObjectiveSet()
+{
+   return this->objectives;
+}
+
+
+/**
+   @class staticMultiObjectiveProblemAdapter
+
+   @brief Makes a staticMultiObjectiveProblem look like a multiObjectiveProblem.
+
+   The objectives are also added to the vector of problems of the base class,
+   so the code that asks for 'getProblems' keeps working. Evaluations and
+   comparisons are carried out by the static problem; the score criterion
+   of the base class is not used.
+*/
+template <class List>
+class staticMultiObjectiveProblemAdapter : public multiObjectiveProblem
+{
+   public:
+      /**
+         Types of comparison.
+      */
+      enum comparisonType { paretoComparison, lexicographicComparison };
+
+   private:
+      /**
+         The problem itself.
+      */
+      staticMultiObjectiveProblem<List> problem;
+
+      /**
+         Type of comparison to be used in 'firstSolutionIsBetter'.
+      */
+      comparisonType comparison;
+
+   protected:
+
+   public:
+      /**
+         Constructor. It adds the objectives to the vector of problems.
+         @param const comparisonType is the type of comparison.
+      */
+      staticMultiObjectiveProblemAdapter(const comparisonType = paretoComparison);
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~staticMultiObjectiveProblemAdapter() { };
+
+      /**
+         Method that compares two solutions. If the option is "<global>" the
+         global-comparable objectives are used in the Pareto comparison.
+         @param const multiObjectiveSolution* is a pointer to the first solution to be compared.
+         @param const multiObjectiveSolution* is a pointer to the second solution to be compared.
+         @param const std::string is reserved data field for options.
+         @return a triBool object.
+      */
+      triBool firstSolutionIsBetter(const multiObjectiveSolution*, const multiObjectiveSolution*, const std::string) const;
+
+      /**
+         Method that evaluates the objectives and puts the result in the multiobjectiveSolution
+         received as a parameter.
+         @param multiObjectiveSolution* is a pointer to the solution to be updated.
+      */
+      void evaluate(multiObjectiveSolution*) const;
+};
+
+template <class List>
+staticMultiObjectiveProblemAdapter<List>::staticMultiObjectiveProblemAdapter(const comparisonType comparison)
+{
+   this->comparison = comparison;
+   this->problem.getObjectiveSet().addTo(this);
+}
+
+template <class List>
+inline triBool staticMultiObjectiveProblemAdapter<List>::firstSolutionIsBetter(const multiObjectiveSolution* s1,
+                                                                               const multiObjectiveSolution* s2,
+                                                                               const std::string options) const
+{
+   assert(s1 != NULL);
+   assert(s2 != NULL);
+   assert(s1->getNumberOfObjectives() == (unsigned)staticMultiObjectiveProblem<List>::numberOfObjectives);
+   assert(s2->getNumberOfObjectives() == (unsigned)staticMultiObjectiveProblem<List>::numberOfObjectives);
+
+   const T* first = s1->getObjectives().data();
+   const T* second = s2->getObjectives().data();
+
+   if (this->comparison == lexicographicComparison)
+      return staticMultiObjectiveProblem<List>::firstIsBetterLexicographic(first, second);
+
+   return staticMultiObjectiveProblem<List>::firstIsBetterPareto(first, second, options == "<global>");
+}
+
+template <class List>
+inline void staticMultiObjectiveProblemAdapter<List>::evaluate(multiObjectiveSolution* MOSolution) const
+{
+   objectivesType* objectives = MOSolution->getPointerToObjectives();
+
+   // A solution that has already been evaluated is taken from the cache
+   evaluationCache* cache = getEvaluationCache();
+   hashType hash = 0;
+   if (cache != NULL)
+   {
+      hash = MOSolution->getHash();
+      if (hash != 0 && cache->lookUp(hash, *objectives))
+         return;
+   }
+
+   // Every objective reads the solution in place, there is no need to copy it
+   typename staticMultiObjectiveProblem<List>::staticObjectivesType values;
+   this->problem.evaluate(MOSolution, values);
+
+   // The vector of objectives is only created the first time the solution is evaluated
+   if (objectives->size() != values.size())
+      objectives->resize(values.size());
+   std::copy(values.begin(), values.end(), objectives->begin());
+
+   if (hash != 0)
+      cache->insert(hash, *objectives);
+}
+
+#endif
@@ -5,7 +5,11 @@
 
    This class inherits from systemStopCriterion to enable stop controllers in
    system's main loop. This class shares the same philosophy that the one in
-   generalStopCriterion (please refer to this class for more information).
+   generalStopCriterion (please refer to this class for more information).
+
+   The time is wall time (a monotonic clock), counted from the construction of
+   the criterion or from the start given with setStartTime, so threads running
+   in parallel do not make the budget run out sooner.
 
    @author Group of Intelligent Computing - Universidad de La Laguna - 2008
 */
@@ -13,6 +17,8 @@
 #ifndef SYSTEMGENERALSTOPCRITERION_H
 #define SYSTEMGENERALSTOPCRITERION_H
 
+#include <time.h>
+
 #include "header.h"
 #include "ssystem.h"
 #include "systemStopCriterion.h"
@@ -24,7 +30,12 @@ class systemGeneralStopCriterion: public systemStopCriterion
       /**
          Max time the loop is alive. After this time the loop will be forced to finish.
       */
-      double maxTime;
+      double maxTime;
+
+      /**
+         Moment the time is counted from (seconds of the monotonic clock).
+      */
+      double startTime;
 
       /**
          Max number of iterations the loop is alive. After this number of iterations
@@ -74,7 +85,19 @@ class systemGeneralStopCriterion: public systemStopCriterion
          Method that sets the max time until the loop is forced to end.
          @param const double is the max time the loop should be alive.
       */
-      void setMaxTime(const double);
+      void setMaxTime(const double);
+
+      /**
+         Method that sets the moment the time is counted from.
+         @param const double is the moment, as returned by wallTime.
+      */
+      void setStartTime(const double);
+
+      /**
+         Method that returns the current moment of the monotonic clock.
+         @return the seconds of the clock.
+      */
+      static double wallTime();
 
       /**
          Method that sets the max number of iterations until the loop is forced to end.
@@ -98,7 +121,8 @@ class systemGeneralStopCriterion: public systemStopCriterion
 
 systemGeneralStopCriterion::systemGeneralStopCriterion()
 { 
-   maxTime = (double)INFd;
+   maxTime = (double)INFd;
+   startTime = wallTime();
    maxIteration = (long)INFi;
    extSignal = false; 
 }
@@ -123,6 +147,18 @@ inline void systemGeneralStopCriterion::setMaxTime(const double time)
    this->maxTime = time;
 }
 
+inline void systemGeneralStopCriterion::setStartTime(const double time)
+{
+   this->startTime = time;
+}
+
+inline double systemGeneralStopCriterion::wallTime()
+{
+   struct timespec now;
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
 inline void systemGeneralStopCriterion::setMaxIteration(const unsigned i)
 {
    this->maxIteration = i;
@@ -135,7 +171,7 @@ inline void systemGeneralStopCriterion::setExtSignal(const bool signal)
 
 inline bool systemGeneralStopCriterion::stop(ssystem* sys)
 {
-   return (this->extSignal || ((double)(clock() / CLOCKS_PER_SEC) > this->maxTime) || (sys->getIteration() >= this->maxIteration));
+   return (this->extSignal || (wallTime() - this->startTime > this->maxTime) || (sys->getIteration() >= this->maxIteration));
 }
 
 #endif
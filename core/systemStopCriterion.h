@@ -15,6 +15,7 @@
 #ifndef SYSTEMSTOPCRITERION_H
 #define SYSTEMSTOPCRITERION_H
 
+#include "checkpoint.h"
 #include "ssystem.h"
 
 class ssystem;
@@ -35,7 +36,7 @@ class systemStopCriterion
       /**
          Default destructor. It does nothing.
       */
-      ~systemStopCriterion() { };
+      virtual ~systemStopCriterion() { };
 
       /**
          Virtual method that is intended to be implemented in the stop
@@ -44,6 +45,15 @@ class systemStopCriterion
          live and do their operations.
       */
       virtual bool stop(ssystem*) = 0;
+
+      /**
+         Virtual methods that write the state the criterion keeps between iterations
+         into a checkpoint and read it back. By default there is none.
+         @param stateStream& is the stream.
+         @return false if the stream failed or it does not match this criterion.
+      */
+      virtual void saveState(stateStream&) const { };
+      virtual bool loadState(stateStream&) { return true; }
 };
 
 #endif
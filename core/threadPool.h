@@ -0,0 +1,284 @@
+/**
+   @class parallelTask
+
+   @brief Task that can be split into chunks run by the threads of a threadPool.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+/**
+   @class threadPool
+
+   @brief Threads that run the chunks of a task in parallel.
+
+   Some operations of a single agent (the scan of a neighbourhood of a large
+   route-plan, for instance) can be split into independent chunks. This
+   class keeps a set of threads waiting for a task: the thread that calls
+   run takes chunks too, and run returns when every chunk is done. Chunks
+   are handed out in increasing order. Tasks must write the result of each
+   chunk apart and reduce them afterwards in the same order, so the result
+   does not depend on the number of threads or on which thread runs which
+   chunk.
+
+   The pool runs one task at a time. If a thread calls run while the pool is
+   busy with the task of another thread (agents in asynchronousArchitecture,
+   for instance), it runs all the chunks itself, so the cores that run agents
+   are never oversubscribed. The class is implemented using a Singleton
+   Pattern and it has no threads until setNumberOfWorkers is called.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+class parallelTask
+{
+   private:
+
+   protected:
+
+   public:
+      /**
+         Default destructor. It does nothing.
+      */
+      virtual ~parallelTask() { };
+
+      /**
+         Virtual method that runs a chunk of the task. It may be called from any thread.
+         @param const unsigned is the chunk.
+      */
+      virtual void run(const unsigned) = 0;
+};
+
+class threadPool
+{
+   private:
+      /**
+         Singleton Pattern. This is a pointer to the object itself.
+      */
+      static threadPool* threadPoolInstance;
+
+      /**
+         Threads of the pool (the thread that calls run is not one of them).
+      */
+      std::vector<pthread_t> workers;
+
+      /**
+         Task being run, number of chunks, next chunk to be handed out and
+         number of chunks that have not finished yet.
+      */
+      parallelTask* task;
+      unsigned numberOfChunks, nextChunk, pendingChunks;
+
+      /**
+         True when the threads have to finish.
+      */
+      bool finished;
+
+      /**
+         Synchronization: the mutex guards the task and the counters, the
+         threads wait for a task in 'wakeUp' and run waits in 'done' for
+         the chunks run by other threads. 'busy' is held while a task runs.
+      */
+      pthread_mutex_t mutex, busy;
+      pthread_cond_t wakeUp, done;
+
+      /**
+         Method that runs in each thread of the pool.
+      */
+      static void* workerThread(void*);
+
+      /**
+         Method that stops the threads of the pool.
+      */
+      void stopWorkers();
+
+   protected:
+      /**
+          Default constructor. It creates a pool without threads.
+          It's protected due to its Singleton nature.
+      */
+      threadPool();
+
+      /**
+          Default destructor. It stops the threads.
+          It's protected due to its Singleton nature.
+      */
+      ~threadPool();
+
+      /**
+          Standard Singleton's destructor. It frees the memory this object takes.
+      */
+      static void destroySingleton();
+
+   public:
+      /**
+          Method that creates a new object if this is its first invokation. Otherwise,
+          it will return a pointer to the existent one.
+      */
+      static threadPool* instance();
+
+      /**
+         Method that returns the number of cores of the machine.
+      */
+      static unsigned getNumberOfCores();
+
+      /**
+         Method that sets the number of threads of the pool. It must not be called
+         while a task is running.
+         @param const unsigned is the number of threads (0 to run every task in the
+         calling thread).
+      */
+      void setNumberOfWorkers(const unsigned);
+
+      unsigned getNumberOfWorkers() const { return this->workers.size(); }
+
+      /**
+         Method that runs all the chunks of a task and returns when they are done.
+         @param parallelTask& is the task.
+         @param const unsigned is the number of chunks.
+      */
+      void run(parallelTask&, const unsigned);
+};
+
+threadPool* threadPool::threadPoolInstance = NULL;
+
+threadPool::threadPool()
+{
+   this->task = NULL;
+   this->numberOfChunks = 0;
+   this->nextChunk = 0;
+   this->pendingChunks = 0;
+   this->finished = false;
+   pthread_mutex_init(&(this->mutex), NULL);
+   pthread_mutex_init(&(this->busy), NULL);
+   pthread_cond_init(&(this->wakeUp), NULL);
+   pthread_cond_init(&(this->done), NULL);
+}
+
+threadPool::~threadPool()
+{
+   stopWorkers();
+   pthread_cond_destroy(&(this->done));
+   pthread_cond_destroy(&(this->wakeUp));
+   pthread_mutex_destroy(&(this->busy));
+   pthread_mutex_destroy(&(this->mutex));
+}
+
+void threadPool::destroySingleton()
+{
+   delete(threadPoolInstance);
+   threadPoolInstance = NULL;
+}
+
+threadPool* threadPool::instance()
+{
+   if (threadPoolInstance == NULL)
+   {
+      threadPoolInstance = new threadPool;
+      std::atexit(&threadPool::destroySingleton);
+   }
+   return threadPoolInstance;
+}
+
+inline unsigned threadPool::getNumberOfCores()
+{
+   long cores = sysconf(_SC_NPROCESSORS_ONLN);
+   return (cores < 1) ? 1 : cores;
+}
+
+void threadPool::setNumberOfWorkers(const unsigned numberOfWorkers)
+{
+   stopWorkers();
+
+   this->finished = false;
+   this->workers.resize(numberOfWorkers);
+   for (unsigned i = 0; i < numberOfWorkers; i++)
+      if (pthread_create(&(this->workers[i]), NULL, workerThread, this) != 0)
+      {
+         std::cout << "ERROR[!] Cannot start the threads of the pool" << std::endl;
+         exit(1);
+      }
+}
+
+void threadPool::stopWorkers()
+{
+   pthread_mutex_lock(&(this->mutex));
+   this->finished = true;
+   pthread_cond_broadcast(&(this->wakeUp));
+   pthread_mutex_unlock(&(this->mutex));
+
+   for (size_t i = 0; i < this->workers.size(); i++)
+      pthread_join(this->workers[i], NULL);
+   this->workers.clear();
+}
+
+void* threadPool::workerThread(void* argument)
+{
+   threadPool* pool = static_cast<threadPool*>(argument);
+
+   pthread_mutex_lock(&(pool->mutex));
+   while (true)
+   {
+      while (!pool->finished && (pool->task == NULL || pool->nextChunk >= pool->numberOfChunks))
+         pthread_cond_wait(&(pool->wakeUp), &(pool->mutex));
+      if (pool->finished)
+         break;
+
+      parallelTask* task = pool->task;
+      const unsigned chunk = pool->nextChunk++;
+      pthread_mutex_unlock(&(pool->mutex));
+
+      task->run(chunk);
+
+      pthread_mutex_lock(&(pool->mutex));
+      if (--(pool->pendingChunks) == 0)
+         pthread_cond_signal(&(pool->done));
+   }
+   pthread_mutex_unlock(&(pool->mutex));
+   return NULL;
+}
+
+void threadPool::run(parallelTask& task, const unsigned numberOfChunks)
+{
+   // Without threads, or if another thread is using them, the chunks are run here
+   if (this->workers.empty() || numberOfChunks < 2 || pthread_mutex_trylock(&(this->busy)) != 0)
+   {
+      for (unsigned i = 0; i < numberOfChunks; i++)
+         task.run(i);
+      return;
+   }
+
+   pthread_mutex_lock(&(this->mutex));
+   this->task = &task;
+   this->numberOfChunks = numberOfChunks;
+   this->nextChunk = 0;
+   this->pendingChunks = numberOfChunks;
+   pthread_cond_broadcast(&(this->wakeUp));
+
+   // The calling thread takes chunks as well
+   while (this->nextChunk < this->numberOfChunks)
+   {
+      const unsigned chunk = this->nextChunk++;
+      pthread_mutex_unlock(&(this->mutex));
+      task.run(chunk);
+      pthread_mutex_lock(&(this->mutex));
+      this->pendingChunks--;
+   }
+   while (this->pendingChunks > 0)
+      pthread_cond_wait(&(this->done), &(this->mutex));
+   this->task = NULL;
+   pthread_mutex_unlock(&(this->mutex));
+
+   pthread_mutex_unlock(&(this->busy));
+}
+
+#endif
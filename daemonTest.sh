@@ -0,0 +1,47 @@
+# Daemon test: starts a daemon, sends it some requests and checks that every
+#   answer ends with its 'done' line. The client reads the socket until the
+#   daemon closes it, so anything written after the 'done' line (e.g. the
+#   'error' line of a child that crashed while finishing) fails the test.
+#
+# Usage: ./daemonTest.sh [data] [vehicles agents evolutions ranking seed]
+# Example: ./daemonTest.sh problems/VRPTW/benchs/Cordeau/c101 10 4 100 0 1
+#
+# The answers are written to daemonTest.<request>.out
+
+DATA=${1:-problems/VRPTW/benchs/Cordeau/c101}
+if [ $# -ge 6 ]; then
+   ARGUMENTS="$2 $3 $4 $5 $6"
+else
+   ARGUMENTS="10 4 100 0 1"
+fi
+SOCKET=/tmp/daemonTest.$$
+
+./CODEA2 daemon=$SOCKET jobs=2 2> daemonTest.daemon.out &
+DAEMON=$!
+while [ ! -S $SOCKET ]; do
+   if ! kill -0 $DAEMON 2> /dev/null; then
+      echo "FAILED: the daemon did not start"
+      exit 1
+   fi
+   sleep 0.1
+done
+
+# The instance read by the daemon, sent with the request, and with a time budget
+FAILED=0
+REQUEST=0
+for OPTIONS in "" "inline=1" "budget=1"; do
+   ./CODEA2 $DATA $ARGUMENTS server=$SOCKET $OPTIONS > daemonTest.$REQUEST.out
+   STATUS=$?
+   LAST=$(tail -n 1 daemonTest.$REQUEST.out)
+   if [ $STATUS -ne 0 ] || [ "${LAST%% *}" != "done" ]; then
+      echo "FAILED: request $REQUEST ($OPTIONS) ended with: $LAST"
+      FAILED=1
+   else
+      echo "OK: request $REQUEST ($OPTIONS)"
+   fi
+   REQUEST=$((REQUEST + 1))
+done
+
+kill $DAEMON
+wait $DAEMON
+exit $FAILED
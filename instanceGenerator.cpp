@@ -0,0 +1,265 @@
+/**
+   Generator of synthetic VRPTW instances in the style of Solomon's ones, for
+   benchmarks on sizes the bundled sets do not reach (see scaling.sh).
+
+   - r: costumers are spread uniformly over a square.
+   - c: costumers are grouped in clusters around random centres.
+   - rc: half of them are clustered and the other half are random.
+
+   The side of the square grows with the square root of the number of
+   costumers, so the density of costumers (and the length of the routes in
+   costumers) does not change with the size. The depot is in the centre and
+   it is open from 0 to the horizon. A costumer with a time window gets one
+   centred at a random time at which it can be served and returned from,
+   whose width is a fraction of the horizon; costumers without one can be
+   served at any time they can be reached. The same seed always gives the
+   same instance, and the positions and demands do not depend on the time
+   windows, so tightening them keeps the rest of the instance.
+
+   Usage: ./instanceGenerator file costumers seed [options]
+   Example: ./instanceGenerator rc1000.txt 1000 7 type=rc width=0.05
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+// C++ classes
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "./libs/conversions.h"
+#include "./misc/MersenneTwister.h"
+
+using namespace std;
+
+/**
+   Data of a costumer, as the readers of CODEA2 expect it.
+*/
+struct costumer
+{
+   double x, y;
+   long demand, service, ready, due;
+};
+
+/**
+   Reads the optional arguments given after the positional ones. They have
+   the form name=value (e.g. type=rc).
+*/
+map<string, string> readOptions(int argc, char **argv, int first)
+{
+   map<string, string> options;
+   for (int i = first; i < argc; i++)
+   {
+      string argument(argv[i]);
+      size_t equal = argument.find('=');
+      if (equal == string::npos || equal == 0)
+      {
+         cout << "ERROR[!] Options must be given as name=value: " << argument << endl;
+         exit(1);
+      }
+      options[argument.substr(0, equal)] = argument.substr(equal + 1);
+   }
+   return options;
+}
+
+/**
+   Returns the value of an option or the default value if it was not given.
+*/
+string getOption(const map<string, string>& options, const string& name, const string& defaultValue)
+{
+   map<string, string>::const_iterator option = options.find(name);
+   return (option == options.end()) ? defaultValue : option->second;
+}
+
+/**
+   Writes the instance in the format of Cordeau's files (see readCordeauData in CODEA2.cpp).
+*/
+void writeCordeau(ostream& file, const vector<costumer>& costumers, unsigned vehicles, long capacity)
+{
+   file << "4 " << vehicles << " " << costumers.size() - 1 << " 1" << endl;
+   file << "0 " << capacity << endl;
+   file << fixed << setprecision(2);
+   for (size_t i = 0; i < costumers.size(); i++)
+   {
+      const costumer& c = costumers[i];
+      file << setw(5) << i << " " << c.x << " " << c.y << " " << (double)c.service << " " << (double)c.demand;
+      if (i == 0)
+         file << " 0 0 0 ";
+      else
+         file << " 1 1 1 ";
+      file << c.ready << " " << c.due << endl;
+   }
+}
+
+/**
+   Writes the instance in the format of Solomon's files (see readSolomonDataFile in CODEA2.cpp).
+*/
+void writeSolomon(ostream& file, const string& name, const vector<costumer>& costumers, unsigned vehicles, long capacity)
+{
+   file << name << endl << endl;
+   file << "VEHICLE" << endl;
+   file << "NUMBER     CAPACITY" << endl;
+   file << setw(5) << vehicles << setw(12) << capacity << endl << endl;
+   file << "CUSTOMER" << endl;
+   file << "CUST NO.  XCOORD.   YCOORD.    DEMAND   READY TIME  DUE DATE   SERVICE   TIME" << endl << endl;
+   file << fixed << setprecision(2);
+   for (size_t i = 0; i < costumers.size(); i++)
+   {
+      const costumer& c = costumers[i];
+      file << setw(5) << i << setw(11) << c.x << setw(11) << c.y << setw(11) << c.demand
+           << setw(11) << c.ready << setw(11) << c.due << setw(11) << c.service << endl;
+   }
+}
+
+int main( int argc, char **argv )
+{
+   if (argc < 4)
+   {
+      cout << "ERROR[!]" << endl;
+      cout << "You must provide:" << endl;
+      cout << "  - the file the instance is written into." << endl;
+      cout << "  - the number of costumers." << endl;
+      cout << "  - seed." << endl;
+      cout << "Options (name=value) may follow:" << endl;
+      cout << "  - type: r (default) for random positions, c for clustered ones or rc for both." << endl;
+      cout << "  - format: cordeau (default) or solomon." << endl;
+      cout << "  - side: side of the square (default 100 for 100 costumers, growing with their square root)." << endl;
+      cout << "  - clusters: number of clusters (default one per 10 costumers)." << endl;
+      cout << "  - spread: standard deviation of the clusters, as a fraction of the side (default 0.03)." << endl;
+      cout << "  - horizon: time the depot closes (default 3 times the side plus twice the service time)." << endl;
+      cout << "  - width: width of the time windows, as a fraction of the horizon (default 0.1)." << endl;
+      cout << "  - density: fraction of the costumers with a time window (default 1)." << endl;
+      cout << "  - service: service time (default 10)." << endl;
+      cout << "  - demand: largest demand, demands are uniform from 1 (default 30)." << endl;
+      cout << "  - capacity: capacity of the vehicles (default 200)." << endl;
+      cout << "  - vehicles: size of the fleet (default one per 4 costumers)." << endl;
+      cout << "Example ./instanceGenerator rc1000.txt 1000 7 type=rc width=0.05" << endl;
+      exit(1);
+   }
+
+   string fileName = argv[1];
+   unsigned numberOfCostumers = atoi(argv[2]);
+   unsigned seed = atoi(argv[3]);
+   map<string, string> options = readOptions(argc, argv, 4);
+
+   string type = getOption(options, "type", "r");
+   string format = getOption(options, "format", "cordeau");
+   if (type != "r" && type != "c" && type != "rc")
+   {
+      cout << "ERROR[!] Unknown type of instance: " << type << endl;
+      exit(1);
+   }
+   if (format != "cordeau" && format != "solomon")
+   {
+      cout << "ERROR[!] Unknown format: " << format << endl;
+      exit(1);
+   }
+   if (numberOfCostumers == 0)
+   {
+      cout << "ERROR[!] The instance needs at least a costumer" << endl;
+      exit(1);
+   }
+
+   const double side = atof(getOption(options, "side", "0").c_str()) > 0 ? atof(getOption(options, "side", "0").c_str())
+                                                                          : 100 * sqrt(numberOfCostumers / 100.0);
+   const unsigned numberOfClusters = max(atoi(getOption(options, "clusters", somethingToString(numberOfCostumers / 10)).c_str()), 1);
+   const double spread = atof(getOption(options, "spread", "0.03").c_str()) * side;
+   const long service = atol(getOption(options, "service", "10").c_str());
+   const long horizon = atol(getOption(options, "horizon", "0").c_str()) > 0 ? atol(getOption(options, "horizon", "0").c_str())
+                                                                             : (long)ceil(3 * side) + 2 * service;
+   const double width = atof(getOption(options, "width", "0.1").c_str()) * horizon;
+   const double density = atof(getOption(options, "density", "1").c_str());
+   const long maxDemand = max(atol(getOption(options, "demand", "30").c_str()), 1L);
+   const long capacity = atol(getOption(options, "capacity", "200").c_str());
+   const unsigned vehicles = max(atoi(getOption(options, "vehicles", somethingToString(numberOfCostumers / 4)).c_str()), 1);
+
+   // Every costumer must be reachable, even from the farthest corner of the square
+   if (horizon < 2 * ceil(side * sqrt(2.0) / 2) + service)
+   {
+      cout << "ERROR[!] The horizon is too short for the side of the square" << endl;
+      exit(1);
+   }
+   if (maxDemand > capacity)
+   {
+      cout << "ERROR[!] The largest demand does not fit into a vehicle" << endl;
+      exit(1);
+   }
+
+   MTRand randomNumber(seed);
+   vector<costumer> costumers(numberOfCostumers + 1);
+   costumers[0].x = costumers[0].y = side / 2;
+   costumers[0].demand = costumers[0].service = costumers[0].ready = 0;
+   costumers[0].due = horizon;
+
+   // Positions. Clustered costumers are dealt to the clusters in turns
+   vector<pair<double, double> > centres(numberOfClusters);
+   for (unsigned k = 0; k < numberOfClusters; k++)
+      centres[k] = make_pair(side * (0.1 + 0.8 * randomNumber.rand()), side * (0.1 + 0.8 * randomNumber.rand()));
+   const unsigned numberOfClustered = (type == "c") ? numberOfCostumers : (type == "rc") ? numberOfCostumers / 2 : 0;
+   for (unsigned i = 1; i <= numberOfCostumers; i++)
+   {
+      costumer& c = costumers[i];
+      if (i <= numberOfClustered)
+      {
+         const pair<double, double>& centre = centres[(i - 1) % numberOfClusters];
+         c.x = min(max(randomNumber.randNorm(centre.first, spread), 0.0), side);
+         c.y = min(max(randomNumber.randNorm(centre.second, spread), 0.0), side);
+      }
+      else
+      {
+         c.x = randomNumber.rand(side);
+         c.y = randomNumber.rand(side);
+      }
+      // Positions are written with two decimals, so distances are computed from those
+      c.x = floor(c.x * 100 + 0.5) / 100;
+      c.y = floor(c.y * 100 + 0.5) / 100;
+   }
+
+   for (unsigned i = 1; i <= numberOfCostumers; i++)
+   {
+      costumers[i].demand = 1 + randomNumber.randInt(maxDemand - 1);
+      costumers[i].service = service;
+   }
+
+   // Time windows: the same numbers are drawn for every costumer, whatever its window is
+   for (unsigned i = 1; i <= numberOfCostumers; i++)
+   {
+      costumer& c = costumers[i];
+      const double distance = sqrt(pow(c.x - costumers[0].x, 2) + pow(c.y - costumers[0].y, 2));
+      const long earliest = (long)ceil(distance), latest = horizon - (long)ceil(distance) - service;
+      const bool hasWindow = (randomNumber.rand() < density);
+      const double centre = earliest + randomNumber.rand() * (latest - earliest);
+      if (hasWindow)
+      {
+         c.ready = max(earliest, (long)floor(centre - width / 2));
+         c.due = min(latest, (long)ceil(centre + width / 2));
+      }
+      else
+      {
+         c.ready = earliest;
+         c.due = latest;
+      }
+   }
+
+   ofstream file(fileName.c_str());
+   if (!file)
+   {
+      cout << "ERROR[!] Cannot write the instance into " << fileName << endl;
+      exit(1);
+   }
+
+   string name = type + somethingToString(numberOfCostumers) + "-" + somethingToString(seed);
+   transform(name.begin(), name.end(), name.begin(), ::toupper);
+   if (format == "cordeau")
+      writeCordeau(file, costumers, vehicles, capacity);
+   else
+      writeSolomon(file, name, costumers, vehicles, capacity);
+
+   return 0;
+}
@@ -0,0 +1,30 @@
+# Island model: runs several CODEA2 processes on the same instance. They
+#   exchange their best route-plans through shared memory and island 0
+#   merges the final solutions.
+#
+# Usage: ./islands.sh islands data vehicles agents evolutions ranking seed [options]
+# Example: ./islands.sh 4 data.txt 10 20 5000 0 200 migration=25 topology=all
+#
+# Island i uses the seed seed + i and writes its output to island.i.out
+
+if [ $# -lt 7 ]; then
+   echo "Usage: $0 islands data vehicles agents evolutions ranking seed [options]"
+   exit 1
+fi
+
+ISLANDS=$1
+DATA=$2
+VEHICLES=$3
+AGENTS=$4
+EVOLUTIONS=$5
+RANKING=$6
+SEED=$7
+shift 7
+
+# Island 0 (the coordinator) creates the segment, so it goes first
+for i in $(seq 0 $((ISLANDS - 1))); do
+   ./CODEA2 $DATA $VEHICLES $AGENTS $EVOLUTIONS $RANKING $((SEED + i)) islands=$ISLANDS island=$i "$@" > island.$i.out &
+done
+wait
+
+grep "islands:" island.0.out
@@ -12,7 +12,7 @@
 
 #include "paintable.h"
 
-#include "../libs/fileLock.h"
+#include "fileLock.h"
 
 class VRPSolDisplayer :  public paintable
 {
@@ -41,7 +41,7 @@ int getLock(std::string fileName)
 int freeLock(std::string fileName, int fd = 0) 
 {
    close(fd);
-   remove((fileName + ".lck").c_str());
+   return remove((fileName + ".lck").c_str());
 }
 
 bool tryWRString(std::string somethingToWrite, std::string fileName)
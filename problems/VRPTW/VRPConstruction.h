@@ -0,0 +1,359 @@
+/**
+   @library VRPConstruction
+
+   @brief Construction heuristics to build initial route-plans.
+
+   This library provides three classical heuristics for the VRPTW:
+
+   - Solomon's I1 insertion: routes are built one at a time, starting from
+     a seed costumer and inserting the costumer that saves more distance
+     with respect to serving it from the depot, taking into account the
+     delay it causes to the rest of the route.
+   - Savings (Clarke and Wright) with time windows: every costumer starts
+     in its own route and routes are merged in order of decreasing savings
+     while the merged route keeps feasible.
+   - Sweep: costumers are sorted by their polar angle around the depot and
+     inserted into the current route until it is full.
+
+   Every heuristic is randomised (seeds, parameters, savings and starting
+   angle) so different agents start from different route-plans. They only
+   use the random number generator they are given and they do not share
+   any state, so several agents can build their route-plans at the same
+   time: VRPConstructionTask builds a set of them on the threads of
+   threadPool.
+
+   Insertions use the checks of VRPInsertion, so the route-plans have no
+   violations unless a costumer cannot be served on time even alone. When
+   the distances are computed on demand (see VRPTWDataProblem::setDistanceMode)
+   the savings are only listed for the closest costumers of every one.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef VRPCONSTRUCTION_H
+#define VRPCONSTRUCTION_H
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dataTypes.h"
+#include "VRPInsertion.h"
+#include "VRPTWDataProblem.h"
+
+#include "../../core/threadPool.h"
+#include "../../misc/MersenneTwister.h"
+
+/**
+   Closest costumers of every one whose savings are listed when the distances
+   are computed on demand.
+*/
+#ifndef VRPSAVINGSNEIGHBOURS
+#define VRPSAVINGSNEIGHBOURS 50
+#endif
+
+/**
+   Solomon's I1 insertion heuristic.
+   @param const D& provides the distances (see VRPDistances.h).
+   @param MTRand& is the random number generator.
+   @param const bool states whether the seeds and parameters are chosen at random.
+   @return a route-plan.
+*/
+template <class D>
+inline chromosomeType solomonI1(const D& distances, MTRand& randomNumber, const bool randomised)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   const timeWindowType& timeWindow = VRPTWData->getTimeWindow();
+   const size_t n = VRPTWData->getClientCoords().size();
+
+   // Parameters (mu, lambda, alpha1): the ones of the original paper
+   const double mu = 1;
+   const double lambda = randomised ? 1 + randomNumber.randInt(1) : 1;
+   const double alpha1 = randomised ? 0.5 * randomNumber.randInt(2) : 1;
+   const double alpha2 = 1 - alpha1;
+
+   std::vector<cityIDType> unrouted;
+   for (cityIDType i = 1; i < n; i++)
+      unrouted.push_back(i);
+
+   std::vector<routeSchedule> routes;
+   while (!unrouted.empty())
+   {
+      // Seed: the farthest costumer or the one with the earliest deadline,
+      //   chosen among the three best ones if randomised.
+      const bool farthest = randomised ? (randomNumber.rand() < 0.5) : true;
+      std::vector<std::pair<double, size_t> > candidates;
+      for (size_t k = 0; k < unrouted.size(); k++)
+         candidates.push_back(std::make_pair(farthest ? -distances.distance(0, unrouted[k]) : (double)timeWindow[unrouted[k]].second, k));
+      const size_t top = std::min<size_t>(randomised ? 3 : 1, candidates.size());
+      std::partial_sort(candidates.begin(), candidates.begin() + top, candidates.end());
+      const size_t seed = candidates[randomNumber.randInt(top - 1)].second;
+
+      std::vector<cityIDType> costumers(1, unrouted[seed]);
+      routeSchedule route = makeSchedule(costumers);
+      unrouted.erase(unrouted.begin() + seed);
+
+      while (true)
+      {
+         bool found = false;
+         size_t bestCostumer = 0, bestPosition = 0;
+         double bestCriterion = 0;
+
+         for (size_t k = 0; k < unrouted.size(); k++)
+         {
+            const cityIDType u = unrouted[k];
+            bool feasible = false;
+            size_t position = 0;
+            double c1 = 0, extraDistance;
+
+            for (size_t p = 1; p < route.visits.size(); p++)
+               if (canInsert(distances, route, p, u, extraDistance))
+               {
+                  const double c11 = extraDistance + (1 - mu) * distances.distance(route.visits[p - 1], route.visits[p]);
+                  const double c12 = pushForward(distances, route, p, u);
+                  const double c = alpha1 * c11 + alpha2 * c12;
+                  if (!feasible || c < c1)
+                  {
+                     feasible = true;
+                     c1 = c;
+                     position = p;
+                  }
+               }
+
+            if (!feasible)
+               continue;
+            const double c2 = lambda * distances.distance(0, u) - c1;
+            if (!found || c2 > bestCriterion)
+            {
+               found = true;
+               bestCriterion = c2;
+               bestCostumer = k;
+               bestPosition = position;
+            }
+         }
+
+         if (!found)
+            break;
+         insertCostumer(distances, route, bestPosition, unrouted[bestCostumer]);
+         unrouted.erase(unrouted.begin() + bestCostumer);
+      }
+      routes.push_back(route);
+   }
+   return joinRoutes(routes);
+}
+
+inline chromosomeType solomonI1(MTRand& randomNumber, const bool randomised = true)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return solomonI1(VRPTWData->getOnDemandDistances(), randomNumber, randomised);
+   return solomonI1(VRPTWData->getDenseDistances(), randomNumber, randomised);
+}
+
+/**
+   Savings heuristic (Clarke and Wright) with time windows.
+   @param const D& provides the distances (see VRPDistances.h).
+   @param MTRand& is the random number generator.
+   @param const double is the amount of noise added to the savings (0 means none).
+   @return a route-plan.
+*/
+template <class D>
+inline chromosomeType savings(const D& distances, MTRand& randomNumber, const double noise)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   const size_t n = VRPTWData->getClientCoords().size();
+
+   // Savings of joining the end of a route at 'i' with the start of another one at 'j'.
+   //    Without a matrix the pairs are too many, so 'j' is one of the closest costumers
+   //    to 'i' (in the same order, so small instances get the same savings)
+   const bool closest = VRPTWData->isOnDemand();
+   std::vector<std::pair<double, std::pair<cityIDType, cityIDType> > > saving;
+   std::vector<cityIDType> neighbours;
+   for (cityIDType i = 1; i < n; i++)
+   {
+      if (closest)
+      {
+         VRPTWData->nearest(i, VRPSAVINGSNEIGHBOURS, neighbours);
+         std::sort(neighbours.begin(), neighbours.end());
+      }
+      const size_t count = closest ? neighbours.size() : n - 1;
+      for (size_t k = 0; k < count; k++)
+      {
+         const cityIDType j = closest ? neighbours[k] : k + 1;
+         if (i != j)
+         {
+            const double s = (distances.distance(i, 0) + distances.distance(0, j) - distances.distance(i, j)) * (1 + noise * (2 * randomNumber.rand() - 1));
+            if (s > 0)
+               saving.push_back(std::make_pair(-s, std::make_pair(i, j)));
+         }
+      }
+   }
+   std::sort(saving.begin(), saving.end());
+
+   // Each costumer starts alone in its route
+   std::vector<std::vector<cityIDType> > routes(n);
+   std::vector<size_t> routeOf(n);
+   for (cityIDType i = 1; i < n; i++)
+   {
+      routes[i].push_back(i);
+      routeOf[i] = i;
+   }
+
+   for (size_t k = 0; k < saving.size(); k++)
+   {
+      const cityIDType i = saving[k].second.first, j = saving[k].second.second;
+      const size_t ri = routeOf[i], rj = routeOf[j];
+      if (ri == rj || routes[ri].back() != i || routes[rj].front() != j)
+         continue;
+
+      std::vector<cityIDType> merged(routes[ri]);
+      merged.insert(merged.end(), routes[rj].begin(), routes[rj].end());
+      if (!isFeasible(makeSchedule(merged)))
+         continue;
+
+      routes[ri].swap(merged);
+      for (size_t c = 0; c < routes[rj].size(); c++)
+         routeOf[routes[rj][c]] = ri;
+      routes[rj].clear();
+   }
+
+   chromosomeType chromosome(1, 0);
+   for (size_t r = 1; r < n; r++)
+      if (!routes[r].empty())
+      {
+         chromosome.insert(chromosome.end(), routes[r].begin(), routes[r].end());
+         chromosome.push_back(0);
+      }
+   return chromosome;
+}
+
+inline chromosomeType savings(MTRand& randomNumber, const double noise = 0.1)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return savings(VRPTWData->getOnDemandDistances(), randomNumber, noise);
+   return savings(VRPTWData->getDenseDistances(), randomNumber, noise);
+}
+
+/**
+   Sweep heuristic.
+   @param MTRand& is the random number generator.
+   @param const bool states whether the starting angle and the direction are chosen at random.
+   @return a route-plan.
+*/
+inline chromosomeType sweep(MTRand& randomNumber, const bool randomised = true)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   const coordsType& coords = VRPTWData->getClientCoords();
+   const size_t n = coords.size();
+
+   const double pi = 3.14159265358979;
+   const double startAngle = randomised ? randomNumber.rand(2 * pi) : 0;
+   const double direction = (randomised && randomNumber.rand() < 0.5) ? -1 : 1;
+
+   std::vector<std::pair<double, cityIDType> > angle;
+   for (cityIDType i = 1; i < n; i++)
+   {
+      double a = direction * std::atan2(coords[i].second - coords[0].second, coords[i].first - coords[0].first) - startAngle;
+      while (a < 0)
+         a += 2 * pi;
+      angle.push_back(std::make_pair(a, i));
+   }
+   std::sort(angle.begin(), angle.end());
+
+   std::vector<routeSchedule> routes;
+   routeSchedule route = makeSchedule(std::vector<cityIDType>());
+   for (size_t k = 0; k < angle.size(); k++)
+   {
+      size_t position = 0;
+      double extraDistance;
+      if (!bestInsertion(route, angle[k].second, position, extraDistance))
+      {
+         if (route.visits.size() > 2)
+            routes.push_back(route);
+         route = makeSchedule(std::vector<cityIDType>());
+         position = 1;
+      }
+      insertCostumer(route, position, angle[k].second);
+   }
+   if (route.visits.size() > 2)
+      routes.push_back(route);
+
+   return joinRoutes(routes);
+}
+
+/**
+   Method that builds a route-plan with the heuristic of the given name
+   ("i1", "savings" or "sweep").
+   @return the route-plan, or an empty one if the name is not known.
+*/
+inline chromosomeType constructRoutes(const std::string& heuristic, MTRand& randomNumber)
+{
+   if (heuristic == "i1")
+      return solomonI1(randomNumber);
+   if (heuristic == "savings")
+      return savings(randomNumber);
+   if (heuristic == "sweep")
+      return sweep(randomNumber);
+   return chromosomeType();
+}
+
+/**
+   @class VRPConstructionTask
+
+   @brief Builds a set of route-plans in parallel (see threadPool).
+
+   Each route-plan is a chunk of the task, built with its own heuristic and a
+   generator seeded with its own seed, so the route-plans are the same whatever
+   thread builds them.
+*/
+class VRPConstructionTask : public parallelTask
+{
+   private:
+      std::vector<std::string> heuristics;
+      std::vector<MTRand::uint32> seeds;
+      std::vector<chromosomeType> routePlans;
+
+   protected:
+
+   public:
+      /**
+         Default destructor. It does nothing.
+      */
+      ~VRPConstructionTask() { };
+
+      /**
+         Method that adds a route-plan to be built.
+         @param const std::string& is the name of the heuristic (see constructRoutes).
+         @param const MTRand::uint32 is the seed of its generator.
+      */
+      void add(const std::string& heuristic, const MTRand::uint32 seed) { this->heuristics.push_back(heuristic); this->seeds.push_back(seed); }
+
+      /**
+         Method that builds a route-plan (see parallelTask).
+      */
+      void run(const unsigned);
+
+      /**
+         Method that builds all the route-plans added.
+      */
+      void build();
+
+      const chromosomeType& getRoutePlan(const size_t i) const { return this->routePlans[i]; }
+};
+
+void VRPConstructionTask::run(const unsigned chunk)
+{
+   MTRand randomNumber(this->seeds[chunk]);
+   this->routePlans[chunk] = constructRoutes(this->heuristics[chunk], randomNumber);
+}
+
+void VRPConstructionTask::build()
+{
+   this->routePlans.assign(this->heuristics.size(), chromosomeType());
+   threadPool::instance()->run(*this, this->heuristics.size());
+}
+
+#endif
@@ -0,0 +1,320 @@
+/**
+   @class VRPDenseDistances, VRPOnDemandDistances, VRPDistanceMatrixBuilder
+
+   @brief Providers of the distances and travel times between costumers.
+
+   A dense matrix of doubles takes 8 n^2 bytes, 3.2 GB for 20000 costumers.
+   Above a size (see VRPTWDataProblem::calculateDistanceMatrix) Euclidean
+   instances do not build it, and distances are computed from the positions
+   when they are needed. Both ways are offered through the same interface:
+
+   - distance(i, j) and travelTime(i, j), in the units of the instance (they
+     are truncated in the integer cost mode, see VRPTWDataProblem::setCostScale).
+   - scaledDistance(i, j) and scaledTravelTime(i, j), in the integer cost mode.
+
+   The evaluators and the operators that read many distances are templates
+   on the provider, and VRPTWDataProblem decides which one they get once per
+   call, so the dense path reads the matrix as it did before.
+
+   The on-demand provider computes the distance with the same expression the
+   matrix is built with, so both give the same values. Nothing is cached: the
+   scans for the nearest costumers, which would read whole rows, go through
+   the spatial index (see VRPSpatialIndex), and the other callers read a few
+   distances of each costumer.
+
+   The matrix itself is built by VRPDistanceMatrixBuilder in blocks of rows
+   run by the threads of threadPool. Only the upper triangle is computed;
+   the lower one is copied from it afterwards in square tiles, so the reads
+   of the columns stay in the cache.
+
+   Providers only point to the data of VRPTWDataProblem, so they are cheap to
+   copy and they must not outlive the changes of the instance.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef VRPDISTANCES_H
+#define VRPDISTANCES_H
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "dataTypes.h"
+#include "../../core/threadPool.h"
+
+/**
+   Rows of the distance matrix in each chunk of VRPDistanceMatrixBuilder (and
+   side of the tiles the lower triangle is copied in).
+*/
+#ifndef VRPDISTANCEBLOCK
+#define VRPDISTANCEBLOCK 64
+#endif
+
+/**
+   Method that computes the Euclidean distances from a position to a run of positions
+   stored by coordinate. Four of them are computed at a time if the compiler targets
+   AVX2 (e.g. -march=native). The results are the same either way, since the square
+   root is correctly rounded, as long as the products are not fused with the sum (use
+   -ffp-contract=off on targets with FMA).
+   @param const double are the coordinates of the position.
+   @param const double* are the abscissae of the run.
+   @param const double* are its ordinates.
+   @param distanceType* is where the distances are stored.
+   @param const size_t is the length of the run.
+*/
+inline void euclideanDistances(const double xi, const double yi, const double* x, const double* y, distanceType* d, const size_t count)
+{
+   size_t j = 0;
+#ifdef __AVX2__
+   const __m256d vxi = _mm256_set1_pd(xi), vyi = _mm256_set1_pd(yi);
+   for (; j + 4 <= count; j += 4)
+   {
+      const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + j), vxi);
+      const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + j), vyi);
+      _mm256_storeu_pd(d + j, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy))));
+   }
+#endif
+   for (; j < count; j++)
+   {
+      const double dx = x[j] - xi, dy = y[j] - yi;
+      d[j] = sqrt(dx * dx + dy * dy);
+   }
+}
+
+class VRPDenseDistances
+{
+   private:
+      const distanceMatrixType* matrix;
+      const distanceType* times;
+      size_t timeStride;
+      const scaledCostType* scaled;
+      const scaledCostType* scaledTimes;
+      size_t scaledStride;
+
+   protected:
+
+   public:
+      /**
+         Default constructor. The provider must be assigned before it is used.
+      */
+      VRPDenseDistances() : matrix(NULL), times(NULL), timeStride(0), scaled(NULL), scaledTimes(NULL), scaledStride(0) { };
+
+      /**
+         Constructor.
+         @param const distanceMatrixType& is the distance matrix.
+         @param const timeMatrixType& are the travel times by rows (empty if they are the distances).
+         @param const std::vector<scaledCostType>& are the scaled distances by rows (integer cost mode).
+         @param const std::vector<scaledCostType>& are the scaled travel times (empty if they are the distances).
+         @param const size_t is the length of the rows of the scaled data.
+      */
+      VRPDenseDistances(const distanceMatrixType&, const timeMatrixType&, const std::vector<scaledCostType>&,
+                        const std::vector<scaledCostType>&, const size_t);
+
+      double distance(const cityIDType i, const cityIDType j) const { return (*this->matrix)[i][j]; }
+      double travelTime(const cityIDType i, const cityIDType j) const
+      { return (this->times == NULL) ? (*this->matrix)[i][j] : this->times[i * this->timeStride + j]; }
+
+      scaledCostType scaledDistance(const cityIDType i, const cityIDType j) const { return this->scaled[i * this->scaledStride + j]; }
+      scaledCostType scaledTravelTime(const cityIDType i, const cityIDType j) const
+      { return (this->scaledTimes == NULL) ? this->scaled[i * this->scaledStride + j] : this->scaledTimes[i * this->scaledStride + j]; }
+};
+
+class VRPOnDemandDistances
+{
+   private:
+      /**
+         Positions of the costumers by coordinate.
+      */
+      const double* x;
+      const double* y;
+      unsigned scale;
+
+      double euclidean(const cityIDType i, const cityIDType j) const
+      {
+         const double dx = this->x[j] - this->x[i], dy = this->y[j] - this->y[i];
+         return sqrt(dx * dx + dy * dy);
+      }
+
+   protected:
+
+   public:
+      /**
+         Default constructor. The provider must be assigned before it is used.
+      */
+      VRPOnDemandDistances() : x(NULL), y(NULL), scale(0) { };
+
+      /**
+         Constructor.
+         @param const std::vector<double>& are the abscissae of the costumers.
+         @param const std::vector<double>& are their ordinates.
+         @param const unsigned is the scale of the integer cost mode (0 if costs are floating-point).
+      */
+      VRPOnDemandDistances(const std::vector<double>&, const std::vector<double>&, const unsigned);
+
+      scaledCostType scaledDistance(const cityIDType i, const cityIDType j) const
+      { return (scaledCostType)(euclidean(i, j) * this->scale + 1e-6); }
+      scaledCostType scaledTravelTime(const cityIDType i, const cityIDType j) const { return scaledDistance(i, j); }
+
+      double distance(const cityIDType i, const cityIDType j) const
+      { return (this->scale > 0) ? scaledDistance(i, j) / (double)this->scale : euclidean(i, j); }
+      double travelTime(const cityIDType i, const cityIDType j) const { return distance(i, j); }
+};
+
+class VRPDistanceMatrixBuilder : public parallelTask
+{
+   private:
+      const double* x;
+      const double* y;
+      size_t numberOfCostumers;
+
+      distanceMatrixType* matrix;
+      std::vector<scaledCostType>* scaled;
+      unsigned scale;
+
+      /**
+         True while the lower triangle is copied.
+      */
+      bool mirroring;
+
+      /**
+         Methods that compute the upper triangle of some rows and copy the lower one.
+      */
+      void computeRows(const size_t, const size_t);
+      void mirrorRows(const size_t, const size_t);
+
+   protected:
+
+   public:
+      /**
+         Constructor.
+         @param const std::vector<double>& are the abscissae of the costumers.
+         @param const std::vector<double>& are their ordinates.
+         @param distanceMatrixType& is the matrix to be built.
+         @param std::vector<scaledCostType>& are the scaled distances by rows (integer cost mode).
+         @param const unsigned is the scale of the integer cost mode (0 if costs are floating-point).
+      */
+      VRPDistanceMatrixBuilder(const std::vector<double>&, const std::vector<double>&, distanceMatrixType&,
+                               std::vector<scaledCostType>&, const unsigned);
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~VRPDistanceMatrixBuilder() { };
+
+      /**
+         Method that runs a block of rows (see parallelTask).
+      */
+      void run(const unsigned);
+
+      /**
+         Method that builds the matrix (and the scaled one in the integer cost mode,
+         where the distances are truncated).
+      */
+      void build();
+};
+
+VRPDenseDistances::VRPDenseDistances(const distanceMatrixType& matrix, const timeMatrixType& times,
+                                     const std::vector<scaledCostType>& scaled, const std::vector<scaledCostType>& scaledTimes,
+                                     const size_t scaledStride)
+{
+   this->matrix = &matrix;
+   this->times = times.empty() ? NULL : &times[0];
+   this->timeStride = matrix.size();
+   this->scaled = scaled.empty() ? NULL : &scaled[0];
+   this->scaledTimes = scaledTimes.empty() ? NULL : &scaledTimes[0];
+   this->scaledStride = scaledStride;
+}
+
+VRPOnDemandDistances::VRPOnDemandDistances(const std::vector<double>& x, const std::vector<double>& y, const unsigned scale)
+{
+   assert(x.size() == y.size() && !x.empty());
+   this->x = &x[0];
+   this->y = &y[0];
+   this->scale = scale;
+}
+
+VRPDistanceMatrixBuilder::VRPDistanceMatrixBuilder(const std::vector<double>& x, const std::vector<double>& y, distanceMatrixType& matrix,
+                                                   std::vector<scaledCostType>& scaled, const unsigned scale)
+{
+   assert(x.size() == y.size() && !x.empty());
+   this->x = &x[0];
+   this->y = &y[0];
+   this->numberOfCostumers = x.size();
+   this->matrix = &matrix;
+   this->scaled = &scaled;
+   this->scale = scale;
+   this->mirroring = false;
+}
+
+void VRPDistanceMatrixBuilder::computeRows(const size_t first, const size_t last)
+{
+   const size_t n = this->numberOfCostumers;
+   for (size_t i = first; i < last; i++)
+   {
+      std::vector<distanceType>& row = (*this->matrix)[i];
+      row.resize(n);
+      row[i] = 0;
+      euclideanDistances(this->x[i], this->y[i], this->x + i + 1, this->y + i + 1, &row[0] + i + 1, n - i - 1);
+
+      // Integer cost mode: the margin keeps integral distances (exact in floating-point) from being truncated down
+      if (this->scale > 0)
+      {
+         const double scale = this->scale;
+         scaledCostType* scaledRow = &(*this->scaled)[i * n];
+         for (size_t j = i + 1; j < n; j++)
+         {
+            scaledRow[j] = (scaledCostType)(row[j] * scale + 1e-6);
+            row[j] = scaledRow[j] / scale;
+         }
+      }
+   }
+}
+
+void VRPDistanceMatrixBuilder::mirrorRows(const size_t first, const size_t last)
+{
+   const size_t n = this->numberOfCostumers;
+   distanceMatrixType& matrix = *this->matrix;
+   for (size_t tile = 0; tile < last; tile += VRPDISTANCEBLOCK)
+      for (size_t i = first; i < last; i++)
+      {
+         const size_t end = std::min<size_t>(tile + VRPDISTANCEBLOCK, i);
+         for (size_t j = tile; j < end; j++)
+            matrix[i][j] = matrix[j][i];
+         if (this->scale > 0)
+            for (size_t j = tile; j < end; j++)
+               (*this->scaled)[i * n + j] = (*this->scaled)[j * n + i];
+      }
+}
+
+void VRPDistanceMatrixBuilder::run(const unsigned chunk)
+{
+   const size_t first = (size_t)chunk * VRPDISTANCEBLOCK;
+   const size_t last = std::min<size_t>(first + VRPDISTANCEBLOCK, this->numberOfCostumers);
+   if (this->mirroring)
+      mirrorRows(first, last);
+   else
+      computeRows(first, last);
+}
+
+void VRPDistanceMatrixBuilder::build()
+{
+   const size_t n = this->numberOfCostumers;
+   this->matrix->assign(n, std::vector<distanceType>());
+   if (this->scale > 0)
+      this->scaled->assign(n * n, 0);
+
+   // The chunks of the first rows, which have more distances, are handed out first
+   const unsigned numberOfChunks = (n + VRPDISTANCEBLOCK - 1) / VRPDISTANCEBLOCK;
+   this->mirroring = false;
+   threadPool::instance()->run(*this, numberOfChunks);
+   this->mirroring = true;
+   threadPool::instance()->run(*this, numberOfChunks);
+}
+
+#endif
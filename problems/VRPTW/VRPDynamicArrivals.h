@@ -0,0 +1,419 @@
+/**
+   @class VRPDynamicArrivals
+
+   @brief Costumers that arrive while the system is running (dynamic VRPTW).
+
+   New orders are read from a file or a named pipe, one per line:
+
+      <iteration> <x> <y> <demand> <service time> <ready time> <due time>
+
+   A costumer arrives once the system has run the given iteration (0 means as
+   soon as it is read), so a file replays a day of orders and a pipe receives
+   them live. Blank lines and lines that start with '#' are skipped. A thread
+   reads the source all the time, so the moment each line is read is known
+   even if the system is in the middle of an iteration, and new lines appended
+   to a file are read too.
+
+   Between two iterations (see problemChanges) the costumers that are due are
+   added to the instance (see VRPTWDataProblem::addCostumer), inserted into the
+   current route-plan of every agent and into the best one by cheapest feasible
+   insertion (see repairRoutes), and the agents go on optimising. A costumer
+   that fits no route gets a new route of its own, so the route-plans keep
+   feasible, and the route elimination and the local search may merge it
+   later. These routes are counted apart. Messages in the inboxes and archived
+   route-plans lack the new costumers, so they are dropped.
+
+   Two latencies are measured for every costumer, from the moment it arrives:
+   until it is in the route-plans, and until the best route-plan is feasible
+   (every time window and capacity is met). Each one is written into the
+   trace and a summary is printed when the system stops.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef VRPDYNAMICARRIVALS_H
+#define VRPDYNAMICARRIVALS_H
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dataTypes.h"
+#include "VRPInsertion.h"
+#include "VRPSolution.h"
+#include "VRPTWDataProblem.h"
+#include "../../core/agent.h"
+#include "../../core/header.h"
+#include "../../core/multiObjectiveProblem.h"
+#include "../../core/paretoArchive.h"
+#include "../../core/problemChanges.h"
+
+class VRPDynamicArrivals : public problemChanges
+{
+   private:
+      /**
+         Costumer read from the source.
+      */
+      struct arrival
+      {
+         iterationType iteration;
+         pointType position;
+         singleDemandType demand;
+         timeType service;
+         singleTimeWindowType window;
+         double time;
+      };
+
+      /**
+         Costumer inserted into the route-plans while the best one is not feasible yet.
+      */
+      struct pendingArrival
+      {
+         cityIDType costumer;
+         iterationType iteration;
+         double time;
+      };
+
+      /**
+         Source of the costumers and thread that reads it.
+      */
+      std::string source;
+      int descriptor;
+      pthread_t reader;
+      int running;
+
+      /**
+         Costumers read and not added yet, and lines that could not be read. Guarded by
+         the mutex.
+      */
+      std::deque<arrival> arrivals;
+      unsigned malformed;
+      pthread_mutex_t lock;
+
+      /**
+         Costumers waiting for a feasible best route-plan.
+      */
+      std::vector<pendingArrival> infeasible;
+
+      /**
+         Latencies of the costumers so far (seconds).
+      */
+      std::vector<double> insertionLatencies, feasibleLatencies;
+
+      /**
+         Routes opened for costumers that did not fit any route.
+      */
+      unsigned openedRoutes;
+
+      /**
+         Stream the trace is written into.
+      */
+      std::ostream* output;
+
+      /**
+         Method run by the reader thread.
+      */
+      static void* readSource(void*);
+
+      /**
+         Method that reads a costumer from a line.
+         @return false if the line does not hold a costumer.
+      */
+      static bool parse(const std::string&, arrival&);
+
+      /**
+         Method that returns the time of a monotonic clock (seconds).
+      */
+      static double now();
+
+      /**
+         Method that inserts costumers into a route-plan and evaluates it again.
+         @return the number of routes opened.
+      */
+      static unsigned insert(multiObjectiveSolution*, const std::vector<cityIDType>&, const multiObjectiveProblem*);
+
+      /**
+         Method that returns whether a route-plan meets every time window and capacity.
+      */
+      static bool isFeasible(const chromosomeType&);
+
+   protected:
+
+   public:
+      /**
+         Constructor. It opens the source and starts reading it.
+         @param const std::string& is the name of the file or the pipe.
+         @param std::ostream& is the stream the trace is written into.
+      */
+      VRPDynamicArrivals(const std::string&, std::ostream& = std::cerr);
+
+      /**
+         Destructor. It stops reading the source.
+      */
+      ~VRPDynamicArrivals();
+
+      /**
+         Method that adds the costumers that are due and inserts them into the route-plans.
+         @param const iterationType is the current iteration of the system.
+         @param std::vector<agent*>* is the set of agents.
+         @return true if any costumer was added.
+      */
+      bool apply(const iterationType, std::vector<agent*>*);
+
+      /**
+         Method that prints the summary of the latencies.
+      */
+      void finish(std::vector<agent*>*);
+
+      /**
+         Method that outputs the summary of the latencies.
+         @param std::ostream& is the stream.
+      */
+      void print(std::ostream&);
+};
+
+VRPDynamicArrivals::VRPDynamicArrivals(const std::string& source, std::ostream& output)
+{
+   this->source = source;
+   this->output = &output;
+   this->malformed = 0;
+   this->openedRoutes = 0;
+   this->running = 1;
+
+   // Opening a pipe must not wait for a writer
+   this->descriptor = open(source.c_str(), O_RDONLY | O_NONBLOCK);
+   if (this->descriptor < 0)
+   {
+      std::cout << "ERROR[!] Cannot open the source of arrivals: " << source << std::endl;
+      exit(1);
+   }
+   pthread_mutex_init(&(this->lock), NULL);
+   pthread_create(&(this->reader), NULL, &VRPDynamicArrivals::readSource, this);
+}
+
+VRPDynamicArrivals::~VRPDynamicArrivals()
+{
+   __sync_lock_test_and_set(&(this->running), 0);
+   pthread_join(this->reader, NULL);
+   close(this->descriptor);
+   pthread_mutex_destroy(&(this->lock));
+}
+
+inline double VRPDynamicArrivals::now()
+{
+   timespec time;
+   clock_gettime(CLOCK_MONOTONIC, &time);
+   return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+bool VRPDynamicArrivals::parse(const std::string& line, arrival& costumer)
+{
+   std::istringstream fields(line);
+   if (!(fields >> costumer.iteration >> costumer.position.first >> costumer.position.second >> costumer.demand
+                >> costumer.service >> costumer.window.first >> costumer.window.second))
+      return false;
+   return costumer.demand >= 0 && costumer.service >= 0 && costumer.window.first <= costumer.window.second;
+}
+
+void* VRPDynamicArrivals::readSource(void* argument)
+{
+   VRPDynamicArrivals* arrivals = static_cast<VRPDynamicArrivals*>(argument);
+   std::string pending;
+   char buffer[4096];
+
+   while (__sync_add_and_fetch(&(arrivals->running), 0))
+   {
+      pollfd request;
+      request.fd = arrivals->descriptor;
+      request.events = POLLIN;
+      poll(&request, 1, 100);
+
+      // The end of a file (lines may be appended) or of a pipe without writers
+      const ssize_t length = read(arrivals->descriptor, buffer, sizeof(buffer));
+      if (length <= 0)
+      {
+         timespec pause = { 0, 10000000 };
+         nanosleep(&pause, NULL);
+         continue;
+      }
+
+      const double time = now();
+      pending.append(buffer, length);
+      size_t end;
+      while ((end = pending.find('\n')) != std::string::npos)
+      {
+         const std::string line = pending.substr(0, end);
+         pending.erase(0, end + 1);
+         if (line.find_first_not_of(" \t\r") == std::string::npos || line[line.find_first_not_of(" \t\r")] == '#')
+            continue;
+
+         arrival costumer;
+         const bool valid = parse(line, costumer);
+         costumer.time = time;
+         pthread_mutex_lock(&(arrivals->lock));
+         if (valid)
+            arrivals->arrivals.push_back(costumer);
+         else
+            arrivals->malformed++;
+         pthread_mutex_unlock(&(arrivals->lock));
+      }
+   }
+   return NULL;
+}
+
+inline unsigned VRPDynamicArrivals::insert(multiObjectiveSolution* solution, const std::vector<cityIDType>& costumers,
+                                           const multiObjectiveProblem* MOP)
+{
+   VRPSolution* VRPSol = static_cast<VRPSolution*>(solution);
+   std::vector<routeSchedule> routes = splitRoutes(VRPSol->getRoutes());
+   const unsigned opened = repairRoutes(routes, costumers, true);
+   VRPSol->setRoutes(joinRoutes(routes));
+   MOP->evaluate(solution);
+   return opened;
+}
+
+inline bool VRPDynamicArrivals::isFeasible(const chromosomeType& chromosome)
+{
+   const std::vector<routeSchedule> routes = splitRoutes(chromosome);
+   for (size_t r = 0; r < routes.size(); r++)
+      if (!::isFeasible(routes[r]))
+         return false;
+   return true;
+}
+
+bool VRPDynamicArrivals::apply(const iterationType iteration, std::vector<agent*>* agents)
+{
+   assert(agents != NULL && !agents->empty());
+
+   const double start = now();
+   std::vector<arrival> due;
+   pthread_mutex_lock(&(this->lock));
+   for (std::deque<arrival>::iterator i = this->arrivals.begin(); i != this->arrivals.end(); )
+      if (i->iteration <= iteration)
+      {
+         due.push_back(*i);
+         i = this->arrivals.erase(i);
+      }
+      else
+         ++i;
+   pthread_mutex_unlock(&(this->lock));
+
+   agent* first = (*agents)[0];
+   multiObjectiveSolution* g = first->getCore()->getBestSolution();
+   if (!due.empty())
+   {
+      VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+      std::vector<cityIDType> costumers;
+      for (size_t i = 0; i < due.size(); i++)
+         costumers.push_back(VRPTWData->addCostumer(due[i].position, due[i].demand, due[i].window, due[i].service));
+
+      // Agents may share the best route-plan and the archive, so each one is adapted once
+      const multiObjectiveProblem* MOP = first->getCore()->getProblem();
+      std::set<multiObjectiveSolution*> adapted;
+      std::set<paretoArchive*> cleared;
+      unsigned opened = 0;
+      for (size_t a = 0; a < agents->size(); a++)
+      {
+         core* agentCore = (*agents)[a]->getCore();
+         multiObjectiveSolution* solutions[] = { agentCore->getCurrentSolution(), agentCore->getBestSolution() };
+         for (unsigned s = 0; s < 2; s++)
+            if (!solutions[s]->isEmpty() && adapted.insert(solutions[s]).second)
+               opened += insert(solutions[s], costumers, MOP);
+         (*agents)[a]->clearInBox();
+         if (agentCore->getArchive() != NULL && cleared.insert(agentCore->getArchive()).second)
+            agentCore->getArchive()->clear();
+      }
+
+      // The cheapest insertion may fit better into another route-plan than into the best one
+      for (size_t a = 0; a < agents->size(); a++)
+      {
+         core* agentCore = (*agents)[a]->getCore();
+         multiObjectiveSolution* xi = agentCore->getCurrentSolution();
+         agentCore->archiveSolution(xi);
+         if (agentCore->getBestSolution()->isEmpty() || MOP->firstSolutionIsBetter(xi, agentCore->getBestSolution(), "reset").isTrue())
+            agentCore->updateBestSolution(xi);
+      }
+
+      const double inserted = now();
+      this->openedRoutes += opened;
+      if (opened > 0)
+         *(this->output) << "Arrivals at iteration " << iteration << ": " << opened
+                         << " routes opened for costumers that fit no route" << std::endl;
+      for (size_t i = 0; i < due.size(); i++)
+      {
+         // A costumer for a later iteration arrives when the iteration ends
+         const double time = (due[i].iteration == iteration) ? std::max(due[i].time, start) : due[i].time;
+         this->insertionLatencies.push_back(inserted - time);
+         *(this->output) << "Costumer " << costumers[i] << " arrived at iteration " << iteration << ": inserted in "
+                         << 1000 * (inserted - time) << " ms" << std::endl;
+
+         pendingArrival pending;
+         pending.costumer = costumers[i];
+         pending.iteration = iteration;
+         pending.time = time;
+         this->infeasible.push_back(pending);
+      }
+   }
+
+   if (!this->infeasible.empty() && !g->isEmpty() && isFeasible(static_cast<VRPSolution*>(g)->getRoutes()))
+   {
+      const double feasible = now();
+      for (size_t i = 0; i < this->infeasible.size(); i++)
+      {
+         this->feasibleLatencies.push_back(feasible - this->infeasible[i].time);
+         *(this->output) << "Costumer " << this->infeasible[i].costumer << ": feasible route-plan in "
+                         << 1000 * (feasible - this->infeasible[i].time) << " ms ("
+                         << iteration - this->infeasible[i].iteration << " iterations)" << std::endl;
+      }
+      this->infeasible.clear();
+   }
+   return !due.empty();
+}
+
+void VRPDynamicArrivals::finish(std::vector<agent*>*)
+{
+   print(*(this->output));
+}
+
+void VRPDynamicArrivals::print(std::ostream& output)
+{
+   pthread_mutex_lock(&(this->lock));
+   const size_t notDue = this->arrivals.size();
+   const unsigned malformed = this->malformed;
+   pthread_mutex_unlock(&(this->lock));
+
+   output << "Dynamic arrivals: " << this->insertionLatencies.size() << " costumers added (" << notDue
+          << " not due yet, " << malformed << " malformed lines), " << this->openedRoutes
+          << " routes opened for costumers that fit no route" << std::endl;
+
+   const std::vector<double>* latencies[] = { &(this->insertionLatencies), &(this->feasibleLatencies) };
+   const char* names[] = { "Insertion latency", "Feasible route-plan latency" };
+   for (unsigned l = 0; l < 2; l++)
+   {
+      if (latencies[l]->empty())
+         continue;
+      double total = 0, maximum = 0;
+      for (size_t i = 0; i < latencies[l]->size(); i++)
+      {
+         total += (*latencies[l])[i];
+         maximum = std::max(maximum, (*latencies[l])[i]);
+      }
+      output << names[l] << ": mean " << 1000 * total / latencies[l]->size() << " ms, max " << 1000 * maximum << " ms" << std::endl;
+   }
+   if (!this->infeasible.empty())
+      output << this->infeasible.size() << " costumers are still waiting for a feasible route-plan" << std::endl;
+}
+
+#endif
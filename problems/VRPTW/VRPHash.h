@@ -0,0 +1,99 @@
+/**
+   @library VRPHash
+
+   @brief Signatures of route-plans.
+
+   A route-plan is hashed as the sum of a pseudo-random key per arc
+   (Zobrist-style hashing with additive combination). As a route-plan is
+   a sequence of costumers where 0 separates the routes, every route
+   contributes the arcs from the depot, between its costumers and back to
+   the depot. Thus, two route-plans that only differ in the order of their
+   routes get the same signature, which is fine since all the objectives
+   are evaluated route by route. The direction of the arcs is taken into
+   account (it matters when there are time windows).
+
+   Since the signature is a sum, it can be updated incrementally when a
+   move replaces a few arcs: the keys of the removed arcs are subtracted and
+   the keys of the new ones are added (see swapHash).
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef VRPHASH_H
+#define VRPHASH_H
+
+#include <algorithm>
+#include <cassert>
+
+#include "dataTypes.h"
+#include "../../core/header.h"
+
+// 64-bit constant built from two 32-bit halves (C++98 has no 64-bit literals)
+#define HASHCONSTANT(high, low) ((((hashType)(high)) << 32) | (hashType)(low))
+
+/**
+   Mixing function (SplitMix64 finalizer). It turns a number into a
+   pseudo-random key.
+*/
+inline hashType mixHash(hashType x)
+{
+   x += HASHCONSTANT(0x9E3779B9, 0x7F4A7C15);
+   x = (x ^ (x >> 30)) * HASHCONSTANT(0xBF58476D, 0x1CE4E5B9);
+   x = (x ^ (x >> 27)) * HASHCONSTANT(0x94D049BB, 0x133111EB);
+   return x ^ (x >> 31);
+}
+
+/**
+   Key of the arc that goes from a costumer to another one.
+*/
+inline hashType arcHash(const A from, const A to)
+{
+   return mixHash(((hashType)from << 32) | (hashType)to);
+}
+
+/**
+   Signature of a route-plan. It is never 0 (0 means 'no signature').
+*/
+inline hashType routesHash(const chromosomeType& routes)
+{
+   hashType hash = 0;
+   for (size_t i = 0; i + 1 < routes.size(); i++)
+      hash += arcHash(routes[i], routes[i + 1]);
+   return (hash == 0) ? 1 : hash;
+}
+
+/**
+   Signature of a route-plan after swapping the elements in positions i and j,
+   computed from the signature of the route-plan before the swap. 'routes' is
+   the route-plan before the swap. Neither i nor j can be the first or the last
+   position.
+*/
+inline hashType swapHash(hashType hash, const chromosomeType& routes, size_t i, size_t j)
+{
+   if (i == j)
+      return hash;
+   if (i > j)
+      std::swap(i, j);
+   assert(i > 0 && j + 1 < routes.size());
+
+   const A a = routes[i];
+   const A b = routes[j];
+
+   // Arcs that change
+   hash -= arcHash(routes[i - 1], a) + arcHash(b, routes[j + 1]);
+   hash += arcHash(routes[i - 1], b) + arcHash(a, routes[j + 1]);
+
+   if (j == i + 1)
+   {
+      hash -= arcHash(a, b);
+      hash += arcHash(b, a);
+   }
+   else
+   {
+      hash -= arcHash(a, routes[i + 1]) + arcHash(routes[j - 1], b);
+      hash += arcHash(b, routes[i + 1]) + arcHash(routes[j - 1], a);
+   }
+   return hash;
+}
+
+#endif
@@ -0,0 +1,439 @@
+/**
+   @library VRPInsertion
+
+   @brief Feasibility checks for the insertion of costumers into routes.
+
+   A routeSchedule keeps, for every visit of a route, the time the service
+   starts (computed forward from the depot) and the latest time it could
+   start without delaying any of the following visits beyond their time
+   windows (computed backward from the depot). The slack between both
+   times tells whether a costumer fits between two consecutive visits
+   without checking the rest of the route, so an insertion is tested in
+   constant time.
+
+   Times follow the model of the objectives: the vehicles leave the depot at
+   time 0, travel times are those of VRPTWDataProblem::getTravelTime (they
+   may differ from the distances), a vehicle that arrives before a
+   window opens waits and a late service is counted as a violation (it is
+   not forbidden). An insertion is feasible when it does not add new
+   violations: the inserted costumer is served on time, the next visit does
+   not start later than both its latest start and its current start, and
+   the load of the route keeps within the capacity of the vehicles.
+
+   The methods that read distances have a version templated on the provider
+   of the distances (see VRPDistances.h), for the callers that loop over
+   many insertions, and one that asks VRPTWDataProblem for it.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef VRPINSERTION_H
+#define VRPINSERTION_H
+
+#include <algorithm>
+#include <vector>
+
+#include "dataTypes.h"
+#include "VRPTWDataProblem.h"
+
+/**
+   Schedule of a route. Visits start and end at the depot.
+*/
+struct routeSchedule
+{
+   std::vector<cityIDType> visits;
+   std::vector<double> start;
+   std::vector<double> latest;
+   double load;
+   double distance;
+};
+
+/**
+   Time a vehicle leaves the visit in the given position.
+*/
+inline double departureTime(const routeSchedule& route, const size_t position)
+{
+   if (position == 0)
+      return 0;
+   return route.start[position] + VRPTWDataProblem::instance()->getServiceTime()[route.visits[position]];
+}
+
+/**
+   Method that computes the schedule of a route from its visits.
+*/
+template <class D>
+inline void updateSchedule(const D& distances, routeSchedule& route)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   const timeWindowType& timeWindow = VRPTWData->getTimeWindow();
+   const size_t n = route.visits.size();
+
+   route.start.resize(n);
+   route.latest.resize(n);
+   route.load = 0;
+   route.distance = 0;
+
+   route.start[0] = 0;
+   for (size_t i = 1; i < n; i++)
+   {
+      const cityIDType from = route.visits[i - 1], to = route.visits[i];
+      route.start[i] = std::max((double)timeWindow[to].first, departureTime(route, i - 1) + distances.travelTime(from, to));
+      route.load += VRPTWData->getDemand()[to];
+      route.distance += distances.distance(from, to);
+   }
+
+   route.latest[n - 1] = timeWindow[route.visits[n - 1]].second;
+   for (size_t i = n - 1; i-- > 0; )
+   {
+      const cityIDType from = route.visits[i], to = route.visits[i + 1];
+      const double service = (i == 0) ? 0 : VRPTWData->getServiceTime()[from];
+      route.latest[i] = std::min((double)timeWindow[from].second, route.latest[i + 1] - distances.travelTime(from, to) - service);
+   }
+}
+
+inline void updateSchedule(routeSchedule& route)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      updateSchedule(VRPTWData->getOnDemandDistances(), route);
+   else
+      updateSchedule(VRPTWData->getDenseDistances(), route);
+}
+
+/**
+   Method that builds the schedule of a route given its costumers.
+*/
+inline routeSchedule makeSchedule(const std::vector<cityIDType>& costumers)
+{
+   routeSchedule route;
+   route.visits.push_back(0);
+   route.visits.insert(route.visits.end(), costumers.begin(), costumers.end());
+   route.visits.push_back(0);
+   updateSchedule(route);
+   return route;
+}
+
+/**
+   Method that checks whether a costumer fits between two consecutive visits.
+   @param const D& provides the distances.
+   @param const cityIDType is the previous visit.
+   @param const double is the time the vehicle leaves the previous visit.
+   @param const cityIDType is the next visit.
+   @param const double is the latest start of the next visit that adds no violations.
+   @param const cityIDType is the costumer.
+   @param double& is where the increase of distance is returned.
+   @return true if the insertion is feasible (the load is not checked).
+*/
+template <class D>
+inline bool fitsBetween(const D& distances, const cityIDType previous, const double departure, const cityIDType next,
+                        const double nextLatest, const cityIDType costumer, double& extraDistance)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   const timeWindowType& timeWindow = VRPTWData->getTimeWindow();
+
+   const double start = std::max((double)timeWindow[costumer].first, departure + distances.travelTime(previous, costumer));
+   if (start > timeWindow[costumer].second)
+      return false;
+
+   const double nextStart = std::max((double)timeWindow[next].first, start + VRPTWData->getServiceTime()[costumer] + distances.travelTime(costumer, next));
+   if (nextStart > nextLatest)
+      return false;
+
+   extraDistance = distances.distance(previous, costumer) + distances.distance(costumer, next) - distances.distance(previous, next);
+   return true;
+}
+
+/**
+   Method that checks whether a costumer can be inserted before the given position.
+   @param const D& provides the distances.
+   @param const routeSchedule& is the route.
+   @param const size_t is the position (between 1 and the number of costumers + 1).
+   @param const cityIDType is the costumer.
+   @param double& is where the increase of distance is returned.
+   @return true if the insertion is feasible.
+*/
+template <class D>
+inline bool canInsert(const D& distances, const routeSchedule& route, const size_t position, const cityIDType costumer, double& extraDistance)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (route.load + VRPTWData->getDemand()[costumer] > VRPTWData->getFleet()[0].second)
+      return false;
+
+   return fitsBetween(distances, route.visits[position - 1], departureTime(route, position - 1), route.visits[position],
+                      std::max(route.latest[position], route.start[position]), costumer, extraDistance);
+}
+
+inline bool canInsert(const routeSchedule& route, const size_t position, const cityIDType costumer, double& extraDistance)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return canInsert(VRPTWData->getOnDemandDistances(), route, position, costumer, extraDistance);
+   return canInsert(VRPTWData->getDenseDistances(), route, position, costumer, extraDistance);
+}
+
+/**
+   Method that returns how much the start of the visit in the given position is
+   delayed if a costumer is inserted before it (the push forward).
+*/
+template <class D>
+inline double pushForward(const D& distances, const routeSchedule& route, const size_t position, const cityIDType costumer)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   const timeWindowType& timeWindow = VRPTWData->getTimeWindow();
+
+   const cityIDType previous = route.visits[position - 1], next = route.visits[position];
+   const double start = std::max((double)timeWindow[costumer].first, departureTime(route, position - 1) + distances.travelTime(previous, costumer));
+   const double nextStart = std::max((double)timeWindow[next].first, start + VRPTWData->getServiceTime()[costumer] + distances.travelTime(costumer, next));
+   return nextStart - route.start[position];
+}
+
+inline double pushForward(const routeSchedule& route, const size_t position, const cityIDType costumer)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return pushForward(VRPTWData->getOnDemandDistances(), route, position, costumer);
+   return pushForward(VRPTWData->getDenseDistances(), route, position, costumer);
+}
+
+/**
+   Method that checks whether a route has neither time window nor capacity violations.
+*/
+inline bool isFeasible(const routeSchedule& route)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (route.load > VRPTWData->getFleet()[0].second)
+      return false;
+   for (size_t i = 1; i < route.visits.size(); i++)
+      if (route.start[i] > VRPTWData->getTimeWindow()[route.visits[i]].second)
+         return false;
+   return true;
+}
+
+/**
+   Method that looks for the cheapest feasible position for a costumer in a route.
+   @param const routeSchedule& is the route.
+   @param const cityIDType is the costumer.
+   @param size_t& is where the position is returned.
+   @param double& is where the increase of distance is returned.
+   @return true if there is a feasible position.
+*/
+template <class D>
+inline bool bestInsertion(const D& distances, const routeSchedule& route, const cityIDType costumer, size_t& bestPosition, double& bestExtraDistance)
+{
+   bool found = false;
+   double extraDistance;
+   for (size_t position = 1; position < route.visits.size(); position++)
+      if (canInsert(distances, route, position, costumer, extraDistance) && (!found || extraDistance < bestExtraDistance))
+      {
+         found = true;
+         bestPosition = position;
+         bestExtraDistance = extraDistance;
+      }
+   return found;
+}
+
+inline bool bestInsertion(const routeSchedule& route, const cityIDType costumer, size_t& bestPosition, double& bestExtraDistance)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return bestInsertion(VRPTWData->getOnDemandDistances(), route, costumer, bestPosition, bestExtraDistance);
+   return bestInsertion(VRPTWData->getDenseDistances(), route, costumer, bestPosition, bestExtraDistance);
+}
+
+/**
+   Method that looks for the cheapest feasible position for a costumer in a route
+   once the costumer in another position is removed from it, without building the
+   schedule of the shorter route: the starts before the removed visit and the latest
+   starts after it do not change, and the others are computed while the positions
+   are checked, so each position is still checked in constant time. The result is
+   the same as removing the costumer and calling bestInsertion.
+   @param const routeSchedule& is the route.
+   @param const size_t is the position of the costumer to be removed.
+   @param const cityIDType is the costumer to be inserted.
+   @param size_t& is where the position (in the route without the removed costumer) is returned.
+   @param double& is where the increase of distance is returned.
+   @return true if there is a feasible position.
+*/
+template <class D>
+inline bool bestInsertionWithout(const D& distances, const routeSchedule& route, const size_t removed, const cityIDType costumer,
+                                 size_t& bestPosition, double& bestExtraDistance)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   const timeWindowType& timeWindow = VRPTWData->getTimeWindow();
+   const std::vector<cityIDType>& visits = route.visits;
+
+   if (route.load - VRPTWData->getDemand()[visits[removed]] + VRPTWData->getDemand()[costumer] > VRPTWData->getFleet()[0].second)
+      return false;
+
+   bool found = false;
+   double extraDistance;
+
+   // From the removed position on, the visits start earlier (forward)
+   cityIDType previous = visits[removed - 1];
+   double departure = departureTime(route, removed - 1);
+   for (size_t i = removed + 1; i < visits.size(); i++)
+   {
+      const cityIDType next = visits[i];
+      const double start = std::max((double)timeWindow[next].first, departure + distances.travelTime(previous, next));
+      if (fitsBetween(distances, previous, departure, next, std::max(route.latest[i], start), costumer, extraDistance) &&
+          (!found || extraDistance < bestExtraDistance))
+      {
+         found = true;
+         bestPosition = i - 1;
+         bestExtraDistance = extraDistance;
+      }
+      previous = next;
+      departure = start + VRPTWData->getServiceTime()[next];
+   }
+
+   // Before the removed position, the visits may start later (backward). Ties go
+   // to the first position, as in bestInsertion
+   cityIDType next = visits[removed + 1];
+   double latest = route.latest[removed + 1];
+   for (size_t i = removed; --i > 0; )
+   {
+      latest = std::min((double)timeWindow[visits[i]].second, latest - distances.travelTime(visits[i], next) - VRPTWData->getServiceTime()[visits[i]]);
+      next = visits[i];
+      if (fitsBetween(distances, visits[i - 1], departureTime(route, i - 1), next, std::max(latest, route.start[i]), costumer, extraDistance) &&
+          (!found || extraDistance <= bestExtraDistance))
+      {
+         found = true;
+         bestPosition = i;
+         bestExtraDistance = extraDistance;
+      }
+   }
+   return found;
+}
+
+inline bool bestInsertionWithout(const routeSchedule& route, const size_t removed, const cityIDType costumer, size_t& bestPosition, double& bestExtraDistance)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return bestInsertionWithout(VRPTWData->getOnDemandDistances(), route, removed, costumer, bestPosition, bestExtraDistance);
+   return bestInsertionWithout(VRPTWData->getDenseDistances(), route, removed, costumer, bestPosition, bestExtraDistance);
+}
+
+/**
+   Method that inserts a costumer before the given position and updates the schedule.
+*/
+template <class D>
+inline void insertCostumer(const D& distances, routeSchedule& route, const size_t position, const cityIDType costumer)
+{
+   route.visits.insert(route.visits.begin() + position, costumer);
+   updateSchedule(distances, route);
+}
+
+inline void insertCostumer(routeSchedule& route, const size_t position, const cityIDType costumer)
+{
+   route.visits.insert(route.visits.begin() + position, costumer);
+   updateSchedule(route);
+}
+
+/**
+   Method that removes the costumer in the given position and updates the schedule.
+*/
+inline void removeCostumer(routeSchedule& route, const size_t position)
+{
+   route.visits.erase(route.visits.begin() + position);
+   updateSchedule(route);
+}
+
+/**
+   Method that inserts a set of costumers, one after the other, into their cheapest
+   feasible positions. A costumer that does not fit anywhere is inserted into the
+   position that least increases the distance (the number of routes is kept), or
+   into a new route of its own if routes may be opened.
+   @param std::vector<routeSchedule>& is the set of routes.
+   @param const std::vector<cityIDType>& is the set of costumers to be inserted.
+   @param const bool states whether new routes may be opened.
+   @return the number of routes opened.
+*/
+template <class D>
+inline unsigned repairRoutes(const D& distances, std::vector<routeSchedule>& routes, const std::vector<cityIDType>& costumers,
+                             const bool openRoutes = false)
+{
+   unsigned opened = 0;
+   for (size_t k = 0; k < costumers.size(); k++)
+   {
+      const cityIDType costumer = costumers[k];
+      bool feasible = false;
+      size_t bestRoute = 0, bestPosition = 1, position = 0;
+      double bestExtraDistance = 0, extraDistance = 0;
+
+      for (size_t r = 0; r < routes.size(); r++)
+         if (bestInsertion(distances, routes[r], costumer, position, extraDistance) && (!feasible || extraDistance < bestExtraDistance))
+         {
+            feasible = true;
+            bestRoute = r;
+            bestPosition = position;
+            bestExtraDistance = extraDistance;
+         }
+
+      if (!feasible && openRoutes)
+      {
+         routes.push_back(makeSchedule(std::vector<cityIDType>(1, costumer)));
+         opened++;
+         continue;
+      }
+      if (!feasible)
+      {
+         bool found = false;
+         for (size_t r = 0; r < routes.size(); r++)
+            for (size_t p = 1; p < routes[r].visits.size(); p++)
+            {
+               const cityIDType previous = routes[r].visits[p - 1], next = routes[r].visits[p];
+               extraDistance = distances.distance(previous, costumer) + distances.distance(costumer, next) - distances.distance(previous, next);
+               if (!found || extraDistance < bestExtraDistance)
+               {
+                  found = true;
+                  bestRoute = r;
+                  bestPosition = p;
+                  bestExtraDistance = extraDistance;
+               }
+            }
+      }
+      insertCostumer(distances, routes[bestRoute], bestPosition, costumer);
+   }
+   return opened;
+}
+
+inline unsigned repairRoutes(std::vector<routeSchedule>& routes, const std::vector<cityIDType>& costumers, const bool openRoutes = false)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return repairRoutes(VRPTWData->getOnDemandDistances(), routes, costumers, openRoutes);
+   return repairRoutes(VRPTWData->getDenseDistances(), routes, costumers, openRoutes);
+}
+
+/**
+   Method that splits a route-plan into schedules. Empty routes are kept.
+*/
+inline std::vector<routeSchedule> splitRoutes(const chromosomeType& chromosome)
+{
+   std::vector<routeSchedule> routes;
+   std::vector<cityIDType> costumers;
+   for (size_t i = 1; i < chromosome.size(); i++)
+   {
+      if (chromosome[i] == 0)
+      {
+         routes.push_back(makeSchedule(costumers));
+         costumers.clear();
+      }
+      else
+         costumers.push_back(chromosome[i]);
+   }
+   return routes;
+}
+
+/**
+   Method that joins a set of schedules into a route-plan.
+*/
+inline chromosomeType joinRoutes(const std::vector<routeSchedule>& routes)
+{
+   chromosomeType chromosome(1, 0);
+   for (size_t r = 0; r < routes.size(); r++)
+      chromosome.insert(chromosome.end(), routes[r].visits.begin() + 1, routes[r].visits.end());
+   return chromosome;
+}
+
+#endif
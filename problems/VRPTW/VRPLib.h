@@ -18,9 +18,12 @@
 #include "../../libs/funcLibrary.h"
 #include "../../libs/IOlibrary.h"
 #include "../../misc/MersenneTwister.h"
+#include "VRPHash.h"
 #include "VRPTWDataProblem.h"
+#include "VRPInsertion.h"
 
 #include "../../core/codeaParameters.h"
+#include "../../core/threadPool.h"
 #include "../../core/singleObjectiveProblem.h"
 
 #include "./objectives/elapsedTimeProblem.h"
@@ -69,8 +72,8 @@ inline unsigned selectAnElement(const chromosomeType& chromosome)
 }
 
 inline bool findElements(const chromosomeType& parent, unsigned start, unsigned length, unsigned element)
-{
-   for (size_t i = start; i < start + length; i++)
+{
+   for (size_t i = start; i < start + length; i++)
       if (parent[i] == element)
          return true;
    return false;
@@ -109,7 +112,207 @@ inline chromosomeType lambdaOneInterchange(const chromosomeType& parent, const s
    return offspring;
 }
 
-chromosomeType localSearch(const chromosomeType& parent, const string target = "")
+/**
+   Minimum size of a route-plan for the swaps of localSearch and twoOpt to be
+   scanned in parallel. Each swap is evaluated in O(n), so smaller route-plans
+   are scanned faster by a single thread.
+*/
+#ifndef PARALLELSCANMINIMUMSIZE
+#define PARALLELSCANMINIMUMSIZE 200
+#endif
+
+/**
+   Number of closest costumers closerNode looks at first. It looks at twice as
+   many whenever none of them is in the route-plan.
+*/
+#ifndef CLOSERNODENEIGHBOURS
+#define CLOSERNODENEIGHBOURS 8
+#endif
+
+/**
+   @class swapScan
+
+   @brief Parallel scan of the swaps of localSearch and twoOpt.
+
+   The swaps of the positions i and i + distance of a route-plan are numbered
+   by distance and then by i, as the sequential loops visit them. Each chunk
+   scans a block of consecutive swaps on its own copy of the route-plan, and
+   the results of the chunks are reduced in the same order, so the swap chosen
+   is the one the sequential scan would choose whatever the number of threads:
+   the first one that improves the given scores (firstImprovement) or the
+   first one with the shortest distance (bestDistance). In firstImprovement,
+   chunks stop as soon as an earlier swap is known to improve.
+*/
+class swapScan : public parallelTask
+{
+   public:
+      enum criterionType { firstImprovement, bestDistance };
+
+   private:
+      const chromosomeType& parent;
+      criterionType criterion;
+      timeWindownViolationProblem twvp;
+      distanceProblem dp;
+      double bestScore, bestScoreTW;
+
+      /**
+         First swap of each distance (the last element is the number of swaps)
+         and number of swaps of each chunk.
+      */
+      std::vector<size_t> distanceStart;
+      size_t numberOfChunks, chunkSize;
+
+      /**
+         Swap chosen by each chunk (the number of swaps if none) and its scores.
+      */
+      std::vector<size_t> chosen;
+      std::vector<double> chosenScore, chosenScoreTW;
+
+      /**
+         Smallest improving swap found so far by any chunk (firstImprovement).
+      */
+      volatile size_t found;
+
+   public:
+      /**
+         Constructor.
+         @param const chromosomeType& is the route-plan.
+         @param criterionType is the swap to be chosen.
+         @param const size_t is the first distance not scanned.
+         @param double are the distance and the time window violations to be improved (firstImprovement).
+      */
+      swapScan(const chromosomeType&, criterionType, const size_t, double = INFd, double = INFd);
+
+      /**
+         Method that scans the swaps of a chunk.
+      */
+      void run(const unsigned);
+
+      size_t getNumberOfChunks() const { return this->numberOfChunks; }
+
+      /**
+         Method that reduces the results of the chunks.
+         @param size_t& are the positions of the chosen swap.
+         @param double& are its distance and time window violations.
+         @return false if no swap was chosen.
+      */
+      bool getSwap(size_t&, size_t&, double&, double&) const;
+};
+
+swapScan::swapScan(const chromosomeType& parent, criterionType criterion, const size_t endDistance, double bestScore, double bestScoreTW)
+   : parent(parent)
+{
+   this->criterion = criterion;
+   this->bestScore = bestScore;
+   this->bestScoreTW = bestScoreTW;
+
+   this->distanceStart.push_back(0);
+   for (size_t distance = 1; distance < endDistance && distance + 2 < parent.size(); distance++)
+      this->distanceStart.push_back(this->distanceStart.back() + parent.size() - distance - 2);
+   const size_t numberOfSwaps = this->distanceStart.back();
+
+   // Several chunks per thread, so the threads finish at the same time
+   this->numberOfChunks = 8 * (threadPool::instance()->getNumberOfWorkers() + 1);
+   this->chunkSize = (numberOfSwaps + this->numberOfChunks - 1) / this->numberOfChunks;
+   if (this->chunkSize == 0)
+      this->chunkSize = 1;
+
+   this->chosen.assign(this->numberOfChunks, numberOfSwaps);
+   this->chosenScore.assign(this->numberOfChunks, INFd);
+   this->chosenScoreTW.assign(this->numberOfChunks, INFd);
+   this->found = numberOfSwaps;
+}
+
+void swapScan::run(const unsigned chunk)
+{
+   const size_t numberOfSwaps = this->distanceStart.back();
+   size_t swap = chunk * this->chunkSize;
+   const size_t end = std::min(swap + this->chunkSize, numberOfSwaps);
+   if (swap >= end)
+      return;
+
+   size_t distance = std::upper_bound(this->distanceStart.begin(), this->distanceStart.end(), swap) - this->distanceStart.begin();
+   size_t i = 1 + swap - this->distanceStart[distance - 1];
+   chromosomeType offspring = this->parent;
+
+   for (; swap < end; swap++)
+   {
+      if (this->criterion == firstImprovement && swap > __sync_add_and_fetch(&(this->found), 0))
+         break;
+
+      basic::swap(offspring, i, i + distance);
+      const double score = this->dp.evaluate(offspring);
+      if (this->criterion == firstImprovement)
+      {
+         const double scoreTW = this->twvp.evaluate(offspring);
+         if (this->bestScore >= score && this->bestScoreTW > scoreTW)
+         {
+            this->chosen[chunk] = swap;
+            this->chosenScore[chunk] = score;
+            this->chosenScoreTW[chunk] = scoreTW;
+
+            size_t current = __sync_add_and_fetch(&(this->found), 0);
+            while (swap < current)
+               current = __sync_val_compare_and_swap(&(this->found), current, swap);
+            break;
+         }
+      }
+      else if (score < this->chosenScore[chunk])
+      {
+         this->chosen[chunk] = swap;
+         this->chosenScore[chunk] = score;
+      }
+      basic::swap(offspring, i, i + distance);
+
+      if (++i + distance + 1 >= offspring.size())
+      {
+         distance++;
+         i = 1;
+      }
+   }
+}
+
+bool swapScan::getSwap(size_t& first, size_t& second, double& score, double& scoreTW) const
+{
+   const size_t numberOfSwaps = this->distanceStart.back();
+   size_t best = this->numberOfChunks;
+
+   // The earliest chunk wins, so ties are broken as in the sequential scan
+   for (size_t chunk = 0; chunk < this->numberOfChunks; chunk++)
+      if (this->chosen[chunk] < numberOfSwaps &&
+          (best == this->numberOfChunks ||
+           (this->criterion == bestDistance && this->chosenScore[chunk] < this->chosenScore[best])))
+      {
+         best = chunk;
+         if (this->criterion == firstImprovement)
+            break;
+      }
+   if (best == this->numberOfChunks)
+      return false;
+
+   const size_t swap = this->chosen[best];
+   const size_t distance = std::upper_bound(this->distanceStart.begin(), this->distanceStart.end(), swap) - this->distanceStart.begin();
+   first = 1 + swap - this->distanceStart[distance - 1];
+   second = first + distance;
+   score = this->chosenScore[best];
+   scoreTW = this->chosenScoreTW[best];
+   return true;
+}
+
+/**
+   Method that returns whether the swaps of a route-plan are worth scanning in parallel.
+*/
+inline bool parallelScan(const chromosomeType& chromosome)
+{
+   return (chromosome.size() >= PARALLELSCANMINIMUMSIZE && threadPool::instance()->getNumberOfWorkers() > 0);
+}
+
+/**
+   Swap local search. If the signature of the parent is given (see VRPHash.h), it is
+   updated with every swap that is kept, so the route-plan returned does not need
+   to be hashed again.
+*/
+chromosomeType localSearch(const chromosomeType& parent, const string target = "", hashType* hash = NULL)
 {
    codeaParameters* neuralItem = codeaParameters::instance();
 
@@ -121,21 +324,45 @@ chromosomeType localSearch(const chromosomeType& parent, const string target = "
    double scoreTW = INFd;
    chromosomeType bestOffspring;
    chromosomeType offspring = parent;
+   const bool hashed = (hash != NULL && *hash != 0);
+   hashType offspringHash = hashed ? *hash : 0;
+   hashType bestHash = offspringHash;
    bool improvement = true;
    bool greedy = true;
    while (improvement)
    {
       improvement = false;
+      if (greedy && parallelScan(offspring))
+      {
+         swapScan scan(offspring, swapScan::firstImprovement, offspring.size() - 1, bestScore, bestScoreTW);
+         threadPool::instance()->run(scan, scan.getNumberOfChunks());
+         size_t first, second;
+         if (scan.getSwap(first, second, bestScore, bestScoreTW))
+         {
+            if (hashed)
+               offspringHash = swapHash(offspringHash, offspring, first, second);
+            basic::swap(offspring, first, second);
+            bestOffspring = offspring;
+            bestHash = offspringHash;
+            improvement = true;
+         }
+         offspring = bestOffspring;
+         offspringHash = bestHash;
+         continue;
+      }
       for (size_t distance = 1; distance < (offspring.size() - 1); distance++)
       {
          for (size_t i = 1; i < (offspring.size() - distance - 1); i++)
          {
+            // The signature is updated from the route-plan before the swap
+            const hashType swappedHash = hashed ? swapHash(offspringHash, offspring, i, i + distance) : 0;
             basic::swap(offspring, i, i + distance);
             scoreTW = twvp.evaluate(offspring);
             score = dp.evaluate(offspring);
             if (bestScore >= score && bestScoreTW > scoreTW)
             {
                bestOffspring = offspring;
+               bestHash = swappedHash;
                bestScore = score;
                bestScoreTW = scoreTW;
                improvement = true;
@@ -148,7 +375,10 @@ chromosomeType localSearch(const chromosomeType& parent, const string target = "
             break;
       }
       offspring = bestOffspring;
+      offspringHash = bestHash;
    }
+   if (hashed)
+      *hash = bestHash;
    return bestOffspring;
 }
 //****************************[  Re-coded using score criterions  ]******************************
@@ -214,16 +444,39 @@ chromosomeType closerNode(const chromosomeType& parent, const string target = "
    int index = -1;
 
    unsigned node = selectAnElement(offspring);
+
+   // First position of each costumer among the candidates. The costumer in 'node' may be
+   //    there too if it is the depot
+   std::vector<int> position(VRPTWData->getClientCoords().size(), -1);
    for (size_t i = 1; i < offspring.size() - 3; i++)
-      if (i != node) 
+      if (i != node && position[offspring[i]] < 0)
+         position[offspring[i]] = i;
+   if (position[offspring[node]] >= 0)
+   {
+      bestScore = 0;
+      index = position[offspring[node]];
+   }
+
+   // Costumers come from the closest one, so the search stops at the first one that is
+   //    farther than the best one. Ties go to the first position
+   std::vector<cityIDType> neighbours;
+   for (unsigned k = CLOSERNODENEIGHBOURS; ; k *= 2)
+   {
+      VRPTWData->nearest(offspring[node], k, neighbours, true);
+      bool farther = false;
+      for (size_t j = 0; j < neighbours.size() && !farther; j++)
       {
-         score = VRPTWData->getDistanceMatrix()[offspring[node]][offspring[i]];
-         if (score < bestScore)
+         score = VRPTWData->getDistance(offspring[node], neighbours[j]);
+         farther = (score > bestScore);
+         if (!farther && position[neighbours[j]] >= 0 && (score < bestScore || position[neighbours[j]] < index))
          {
             bestScore = score;
-            index = i;
+            index = position[neighbours[j]];
          }
       }
+      if (farther || neighbours.size() < k)
+         break;
+   }
 
    basic::move<A>(offspring, index, node);
    return offspring;
@@ -242,6 +495,19 @@ inline chromosomeType twoOpt(const chromosomeType& parent, const string target =
 
    unsigned dist = 1;
    unsigned numberOfLoops = offspring.size() - 3;
+   if (parallelScan(offspring))
+   {
+      swapScan scan(offspring, swapScan::bestDistance, numberOfLoops);
+      threadPool::instance()->run(scan, scan.getNumberOfChunks());
+      size_t first, second;
+      double scoreTW;
+      if (scan.getSwap(first, second, bestScoreA, scoreTW))
+      {
+         bestOffspring = offspring;
+         basic::swap(bestOffspring, first, second);
+      }
+      return bestOffspring;
+   }
    for (size_t k = 1; k < numberOfLoops; k++)
       for (size_t i = 1; i + k <= offspring.size() - 2; i++)
       {
@@ -336,7 +602,52 @@ chromosomeType twitter(const chromosomeType& follower, const chromosomeType& att
    return localSearch(next);
 }
 
+/**
+   Method that copies a route of the attractor into the follower, like twitter,
+   but keeping the rest of the follower feasible: the costumers of the copied
+   route are removed from the follower routes, the follower route with fewest
+   costumers is replaced by the copied one and its costumers are reinserted
+   into their cheapest feasible positions (see repairRoutes). The number of
+   routes is kept. Unlike twitter, it does not run the local search on the
+   result: the resolutor phase does it afterwards (see localSearchMethod).
+*/
+chromosomeType twitterRepair(const chromosomeType& follower, const chromosomeType& attractor, const string target = " ")
+{
+   codeaParameters* neuralItem = codeaParameters::instance();
+   if (neuralItem->getRandomNumber()->rand() < 0.60)
+      return MType0(attractor, follower, target);
 
+   std::vector<routeSchedule> attractorRoutes = splitRoutes(attractor);
+   std::vector<size_t> candidates;
+   for (size_t r = 0; r < attractorRoutes.size(); r++)
+      if (attractorRoutes[r].visits.size() > 2)
+         candidates.push_back(r);
+   if (candidates.empty())
+      return follower;
+
+   const routeSchedule& copied = attractorRoutes[candidates[neuralItem->getRandomNumber()->randInt(candidates.size() - 1)]];
+   std::vector<bool> inCopied(VRPTWDataProblem::instance()->getClientCoords().size(), false);
+   for (size_t i = 1; i + 1 < copied.visits.size(); i++)
+      inCopied[copied.visits[i]] = true;
+
+   std::vector<routeSchedule> routes = splitRoutes(follower);
+   size_t shortest = 0;
+   for (size_t r = 0; r < routes.size(); r++)
+   {
+      std::vector<cityIDType> costumers;
+      for (size_t i = 1; i + 1 < routes[r].visits.size(); i++)
+         if (!inCopied[routes[r].visits[i]])
+            costumers.push_back(routes[r].visits[i]);
+      routes[r] = makeSchedule(costumers);
+      if (routes[r].visits.size() < routes[shortest].visits.size())
+         shortest = r;
+   }
 
+   std::vector<cityIDType> removed(routes[shortest].visits.begin() + 1, routes[shortest].visits.end() - 1);
+   routes[shortest] = copied;
+   repairRoutes(routes, removed);
+
+   return joinRoutes(routes);
+}
 
 #endif
@@ -0,0 +1,214 @@
+/**
+   @class VRPRouteElimination
+
+   @brief Removes routes from a route-plan.
+
+   The route with the fewest costumers is dissolved and its costumers are
+   moved to an ejection pool. Costumers are taken from the pool one by one
+   and inserted into the cheapest feasible position of the remaining routes
+   (see VRPInsertion). When a costumer does not fit anywhere, it is
+   inserted into a route after ejecting another costumer of that route,
+   which goes to the pool. The costumer to eject is the one that has caused
+   fewer failures so far, so costumers that are hard to insert end up in
+   the routes and the easy ones are moved around (Nagata and Braysy, 2009).
+
+   The route is eliminated if the pool gets empty within a number of
+   iterations. Otherwise the route-plan is left as it was. Empty routes
+   (consecutive depots) are eliminated straightaway.
+
+   Insertions never add time window or capacity violations, so an
+   eliminated route only changes the number of vehicles and the distance.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef VRPROUTEELIMINATION_H
+#define VRPROUTEELIMINATION_H
+
+#include <vector>
+
+#include "dataTypes.h"
+#include "VRPInsertion.h"
+#include "VRPTWDataProblem.h"
+
+#include "../../core/codeaParameters.h"
+
+class VRPRouteElimination
+{
+   private:
+      /**
+         Maximum number of ejections per elimination attempt.
+      */
+      unsigned maxIterations;
+
+      /**
+         Number of times each costumer could not be inserted without ejections.
+      */
+      std::vector<unsigned> failures;
+
+      /**
+         Counters for statistical purposes.
+      */
+      unsigned long attempts, eliminations;
+
+      /**
+         Method that inserts a costumer into the cheapest feasible position.
+         @return true if the costumer was inserted.
+      */
+      bool insert(std::vector<routeSchedule>&, const cityIDType) const;
+
+      /**
+         Method that inserts a costumer ejecting another one.
+         @return true if the costumer was inserted. The ejected costumer is added to the pool.
+      */
+      bool insertWithEjection(std::vector<routeSchedule>&, const cityIDType, std::vector<cityIDType>&) const;
+
+   protected:
+
+   public:
+      /**
+         Default constructor. It sets the default parameters.
+      */
+      VRPRouteElimination();
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~VRPRouteElimination() { };
+
+      void setMaxIterations(const unsigned maxIterations) { this->maxIterations = maxIterations; }
+      unsigned long getAttempts() const { return this->attempts; }
+      unsigned long getEliminations() const { return this->eliminations; }
+
+      /**
+         Method that tries to remove one route from a route-plan.
+         @param chromosomeType& is the route-plan. It is modified only if a route is removed.
+         @return true if a route was removed.
+      */
+      bool run(chromosomeType&);
+};
+
+VRPRouteElimination::VRPRouteElimination()
+{
+   this->maxIterations = 500;
+   this->attempts = 0;
+   this->eliminations = 0;
+}
+
+inline bool VRPRouteElimination::insert(std::vector<routeSchedule>& routes, const cityIDType costumer) const
+{
+   bool found = false;
+   size_t bestRoute = 0, bestPosition = 0, position = 0;
+   double bestExtraDistance = 0, extraDistance = 0;
+
+   for (size_t r = 0; r < routes.size(); r++)
+      if (bestInsertion(routes[r], costumer, position, extraDistance) && (!found || extraDistance < bestExtraDistance))
+      {
+         found = true;
+         bestRoute = r;
+         bestPosition = position;
+         bestExtraDistance = extraDistance;
+      }
+
+   if (found)
+      insertCostumer(routes[bestRoute], bestPosition, costumer);
+   return found;
+}
+
+inline bool VRPRouteElimination::insertWithEjection(std::vector<routeSchedule>& routes, const cityIDType costumer, std::vector<cityIDType>& pool) const
+{
+   codeaParameters* neuralItem = codeaParameters::instance();
+   bool found = false;
+   size_t bestRoute = 0, bestEjected = 0, bestPosition = 0, position = 0;
+   unsigned bestFailures = 0;
+   double bestExtraDistance = 0, extraDistance = 0;
+
+   for (size_t r = 0; r < routes.size(); r++)
+      for (size_t e = 1; e + 1 < routes[r].visits.size(); e++)
+      {
+         const unsigned ejectedFailures = this->failures[routes[r].visits[e]];
+         if (found && ejectedFailures > bestFailures)
+            continue;
+
+         if (!bestInsertionWithout(routes[r], e, costumer, position, extraDistance))
+            continue;
+
+         // Ties are broken at random so the search does not cycle
+         if (!found || ejectedFailures < bestFailures ||
+             (extraDistance < bestExtraDistance && neuralItem->getRandomNumber()->rand() < 0.9))
+         {
+            found = true;
+            bestRoute = r;
+            bestEjected = e;
+            bestPosition = position;
+            bestFailures = ejectedFailures;
+            bestExtraDistance = extraDistance;
+         }
+      }
+
+   if (found)
+   {
+      pool.push_back(routes[bestRoute].visits[bestEjected]);
+      removeCostumer(routes[bestRoute], bestEjected);
+      insertCostumer(routes[bestRoute], bestPosition, costumer);
+   }
+   return found;
+}
+
+inline bool VRPRouteElimination::run(chromosomeType& chromosome)
+{
+   std::vector<routeSchedule> routes = splitRoutes(chromosome);
+
+   // Empty routes
+   size_t r = 0;
+   for (size_t i = 0; i < routes.size(); i++)
+      if (routes[i].visits.size() > 2)
+         routes[r++] = routes[i];
+   if (r < routes.size() && r > 0)
+   {
+      routes.resize(r);
+      chromosome = joinRoutes(routes);
+      this->eliminations++;
+      return true;
+   }
+   if (routes.size() < 2)
+      return false;
+
+   this->attempts++;
+   this->failures.assign(VRPTWDataProblem::instance()->getClientCoords().size(), 1);
+
+   // The shortest route is moved to the pool
+   size_t shortest = 0;
+   for (size_t i = 1; i < routes.size(); i++)
+      if (routes[i].visits.size() < routes[shortest].visits.size() ||
+          (routes[i].visits.size() == routes[shortest].visits.size() && routes[i].distance < routes[shortest].distance))
+         shortest = i;
+
+   std::vector<cityIDType> pool(routes[shortest].visits.begin() + 1, routes[shortest].visits.end() - 1);
+   routes.erase(routes.begin() + shortest);
+
+   for (unsigned iteration = 0; !pool.empty() && iteration < this->maxIterations; iteration++)
+   {
+      const cityIDType costumer = pool.back();
+      pool.pop_back();
+
+      if (insert(routes, costumer))
+         continue;
+
+      this->failures[costumer]++;
+      if (!insertWithEjection(routes, costumer, pool))
+      {
+         pool.push_back(costumer);
+         break;
+      }
+   }
+
+   if (!pool.empty())
+      return false;
+
+   chromosome = joinRoutes(routes);
+   this->eliminations++;
+   return true;
+}
+
+#endif
@@ -0,0 +1,523 @@
+/**
+   @class VRPRuinRecreate
+
+   @brief Adaptive large neighbourhood search for the VRPTW.
+
+   Every iteration removes a block of costumers from the route-plan (ruin)
+   and inserts them again (recreate). There are four ruin methods:
+
+   - random: costumers chosen at random.
+   - Shaw: costumers related to a random one (close to it, with a similar
+     time window and demand), so they can be exchanged among routes. The
+     ranking is built from the closest costumers (see VRPSpatialIndex) and
+     stops as soon as farther ones cannot be related enough to enter it.
+   - route: all the costumers of a random route.
+   - worst: the costumers whose removal saves more distance.
+
+   and three recreate methods: greedy insertion (regret-1), regret-2 and
+   regret-3 insertion. A regret-k insertion inserts first the costumer that
+   would lose more by not being inserted into its best route now.
+
+   Methods are chosen by roulette wheel. Their weights are updated from the
+   scores they get (new best plan, better plan, accepted plan) every segment
+   of iterations (Ropke and Pisinger, 2006). New plans are accepted if they
+   are not worse than the best one by more than a threshold.
+
+   Routes are kept as schedules (see VRPInsertion), so each insertion is
+   checked in constant time. The cost of inserting each costumer into each
+   route is cached during a recreate and only the column of the route that
+   receives a costumer is computed again.
+
+   The cost of a route-plan is its distance plus penalties for the non-empty
+   routes and the violations. The number of routes is kept (ruined routes can
+   stay empty; empty routes are removed by VRPRouteElimination).
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef VRPRUINRECREATE_H
+#define VRPRUINRECREATE_H
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "dataTypes.h"
+#include "VRPInsertion.h"
+#include "VRPTWDataProblem.h"
+
+#include "../../core/checkpoint.h"
+#include "../../core/codeaParameters.h"
+
+class VRPRuinRecreate
+{
+   public:
+      enum ruinType { randomRuin, shawRuin, routeRuin, worstRuin, numberOfRuins };
+      enum recreateType { greedyRecreate, regret2Recreate, regret3Recreate, numberOfRecreates };
+
+   private:
+      /**
+         Weights, scores and uses of the methods in the current segment.
+      */
+      std::vector<double> ruinWeight, ruinScore, recreateWeight, recreateScore;
+      std::vector<unsigned> ruinUses, recreateUses;
+
+      /**
+         Iterations per segment and reaction factor of the weights.
+      */
+      unsigned segmentLength;
+      double reaction;
+      unsigned iteration;
+
+      /**
+         Accepted deviation (relative) from the best cost.
+      */
+      double threshold;
+
+      /**
+         Penalties of the cost of a route-plan.
+      */
+      double routePenalty, violationPenalty;
+
+      /**
+         Method that returns the cost of a route-plan.
+      */
+      double cost(const std::vector<routeSchedule>&) const;
+
+      /**
+         Method that chooses a method by roulette wheel.
+      */
+      static unsigned select(const std::vector<double>&);
+
+      /**
+         Method that returns the number of costumers to remove.
+      */
+      unsigned ruinSize(const unsigned) const;
+
+      /**
+         Ruin methods. They remove costumers from the routes and add them to the given vector.
+      */
+      void ruin(std::vector<routeSchedule>&, const ruinType, std::vector<cityIDType>&) const;
+
+      /**
+         Method that removes a set of costumers from the routes.
+      */
+      static void removeCostumers(std::vector<routeSchedule>&, const std::vector<bool>&);
+
+      /**
+         Method that inserts the costumers with a regret-k insertion (k = 1 is greedy).
+      */
+      void recreate(std::vector<routeSchedule>&, std::vector<cityIDType>&, const unsigned) const;
+
+      /**
+         Method that updates the weights at the end of a segment.
+      */
+      void updateWeights();
+
+   protected:
+
+   public:
+      /**
+         Default constructor. It sets the default parameters.
+      */
+      VRPRuinRecreate();
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~VRPRuinRecreate() { };
+
+      void setThreshold(const double threshold) { this->threshold = threshold; }
+      void setSegmentLength(const unsigned segmentLength) { this->segmentLength = segmentLength; }
+      const std::vector<double>& getRuinWeights() const { return this->ruinWeight; }
+      const std::vector<double>& getRecreateWeights() const { return this->recreateWeight; }
+
+      /**
+         Method that carries out a number of ruin and recreate iterations.
+         @param chromosomeType& is the route-plan. It is replaced by the best plan found.
+         @param const unsigned is the number of iterations.
+         @return true if a better route-plan was found.
+      */
+      bool run(chromosomeType&, const unsigned);
+
+      /**
+         Method that writes the weights, the scores of the current segment and
+         the iteration counter into a checkpoint.
+      */
+      void saveState(stateStream&) const;
+
+      /**
+         Method that reads the state written by saveState.
+         @return false if the stream failed.
+      */
+      bool loadState(stateStream&);
+};
+
+VRPRuinRecreate::VRPRuinRecreate()
+{
+   this->ruinWeight.assign(numberOfRuins, 1);
+   this->ruinScore.assign(numberOfRuins, 0);
+   this->ruinUses.assign(numberOfRuins, 0);
+   this->recreateWeight.assign(numberOfRecreates, 1);
+   this->recreateScore.assign(numberOfRecreates, 0);
+   this->recreateUses.assign(numberOfRecreates, 0);
+   this->segmentLength = 100;
+   this->reaction = 0.1;
+   this->iteration = 0;
+   this->threshold = 0.01;
+   this->routePenalty = 1000;
+   this->violationPenalty = 10000;
+}
+
+inline double VRPRuinRecreate::cost(const std::vector<routeSchedule>& routes) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   double total = 0;
+   for (size_t r = 0; r < routes.size(); r++)
+   {
+      if (routes[r].visits.size() <= 2)
+         continue;
+      total += routes[r].distance + this->routePenalty;
+      if (routes[r].load > VRPTWData->getFleet()[0].second)
+         total += this->violationPenalty;
+      for (size_t i = 1; i < routes[r].visits.size(); i++)
+         if (routes[r].start[i] > VRPTWData->getTimeWindow()[routes[r].visits[i]].second)
+            total += this->violationPenalty;
+   }
+   return total;
+}
+
+inline unsigned VRPRuinRecreate::select(const std::vector<double>& weight)
+{
+   codeaParameters* neuralItem = codeaParameters::instance();
+   double total = 0;
+   for (size_t i = 0; i < weight.size(); i++)
+      total += weight[i];
+
+   double value = neuralItem->getRandomNumber()->rand(total);
+   for (size_t i = 0; i + 1 < weight.size(); i++)
+   {
+      if (value < weight[i])
+         return i;
+      value -= weight[i];
+   }
+   return weight.size() - 1;
+}
+
+inline unsigned VRPRuinRecreate::ruinSize(const unsigned numberOfCostumers) const
+{
+   codeaParameters* neuralItem = codeaParameters::instance();
+   const unsigned lower = std::max(1u, numberOfCostumers / 20);
+   const unsigned upper = std::max(lower, std::min(50u, (2 * numberOfCostumers) / 10));
+   return lower + neuralItem->getRandomNumber()->randInt(upper - lower);
+}
+
+inline void VRPRuinRecreate::removeCostumers(std::vector<routeSchedule>& routes, const std::vector<bool>& removed)
+{
+   for (size_t r = 0; r < routes.size(); r++)
+   {
+      std::vector<cityIDType> costumers;
+      for (size_t i = 1; i + 1 < routes[r].visits.size(); i++)
+         if (!removed[routes[r].visits[i]])
+            costumers.push_back(routes[r].visits[i]);
+      if (costumers.size() + 2 != routes[r].visits.size())
+         routes[r] = makeSchedule(costumers);
+   }
+}
+
+inline void VRPRuinRecreate::ruin(std::vector<routeSchedule>& routes, const ruinType method, std::vector<cityIDType>& pool) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   codeaParameters* neuralItem = codeaParameters::instance();
+   const size_t n = VRPTWData->getClientCoords().size();
+
+   std::vector<cityIDType> routed;
+   for (size_t r = 0; r < routes.size(); r++)
+      routed.insert(routed.end(), routes[r].visits.begin() + 1, routes[r].visits.end() - 1);
+   if (routed.empty())
+      return;
+
+   const unsigned size = std::min<unsigned>(ruinSize(n - 1), routed.size());
+   std::vector<bool> removed(n, false);
+
+   if (method == randomRuin)
+   {
+      for (unsigned k = 0; k < size; k++)
+      {
+         std::swap(routed[k], routed[k + neuralItem->getRandomNumber()->randInt(routed.size() - 1 - k)]);
+         removed[routed[k]] = true;
+      }
+   }
+   else if (method == shawRuin)
+   {
+      const timeWindowType& timeWindow = VRPTWData->getTimeWindow();
+      const demandType& demand = VRPTWData->getDemand();
+      double maxDistance = 1, maxTime = 1, maxDemand = 1;
+      for (size_t i = 1; i < n; i++)
+      {
+         maxDistance = std::max(maxDistance, VRPTWData->getDistance(0, i));
+         maxTime = std::max(maxTime, (double)timeWindow[i].first);
+         maxDemand = std::max(maxDemand, demand[i]);
+      }
+
+      std::vector<bool> isRouted(n, false);
+      for (size_t k = 0; k < routed.size(); k++)
+         isRouted[routed[k]] = true;
+      // Distances of the matrix may be truncated (see VRPTWDataProblem::setCostScale)
+      const double slack = (VRPTWData->getCostScale() > 0) ? 1.0 / VRPTWData->getCostScale() : 0;
+
+      std::vector<cityIDType> chosen(1, routed[neuralItem->getRandomNumber()->randInt(routed.size() - 1)]);
+      removed[chosen[0]] = true;
+      std::vector<cityIDType> neighbours;
+      std::vector<std::pair<double, cityIDType> > related;
+      while (chosen.size() < size)
+      {
+         const cityIDType reference = chosen[neuralItem->getRandomNumber()->randInt(chosen.size() - 1)];
+         const size_t index = (size_t)(std::pow(neuralItem->getRandomNumber()->randExc(), 6) * (routed.size() - chosen.size()));
+
+         // The costumer in position 'index' of the ranking by relatedness is the largest of the
+         //    index + 1 most related ones, kept in a heap. Costumers come from the closest one and
+         //    they are at least as unrelated as their distance makes them, so the search stops
+         //    when that is already larger than the largest one kept
+         for (size_t k = std::max<size_t>(2 * (index + 1), 16); ; k *= 2)
+         {
+            related.clear();
+            VRPTWData->nearest(reference, k, neighbours);
+            bool farther = false;
+            for (size_t j = 0; j < neighbours.size() && !farther; j++)
+            {
+               const cityIDType c = neighbours[j];
+               farther = (related.size() > index && 9 * (VRPTWData->nearestDistance(reference, c) - slack) / maxDistance > related.front().first);
+               if (farther || !isRouted[c] || removed[c])
+                  continue;
+               related.push_back(std::make_pair(9 * VRPTWData->getDistance(reference, c) / maxDistance +
+                                                3 * std::fabs((double)(timeWindow[reference].first - timeWindow[c].first)) / maxTime +
+                                                2 * std::fabs(demand[reference] - demand[c]) / maxDemand, c));
+               std::push_heap(related.begin(), related.end());
+               if (related.size() > index + 1)
+               {
+                  std::pop_heap(related.begin(), related.end());
+                  related.pop_back();
+               }
+            }
+            if (farther || neighbours.size() < k)
+               break;
+         }
+         chosen.push_back(related.front().second);
+         removed[related.front().second] = true;
+      }
+   }
+   else if (method == routeRuin)
+   {
+      std::vector<size_t> candidates;
+      for (size_t r = 0; r < routes.size(); r++)
+         if (routes[r].visits.size() > 2)
+            candidates.push_back(r);
+      const routeSchedule& route = routes[candidates[neuralItem->getRandomNumber()->randInt(candidates.size() - 1)]];
+      for (size_t i = 1; i + 1 < route.visits.size(); i++)
+         removed[route.visits[i]] = true;
+   }
+   else if (method == worstRuin)
+   {
+      for (unsigned k = 0; k < size; k++)
+      {
+         std::vector<std::pair<double, cityIDType> > saving;
+         for (size_t r = 0; r < routes.size(); r++)
+         {
+            // Savings are computed as if the costumers removed so far were still in the route
+            const std::vector<cityIDType>& visits = routes[r].visits;
+            for (size_t i = 1; i + 1 < visits.size(); i++)
+               if (!removed[visits[i]])
+                  saving.push_back(std::make_pair(-(VRPTWData->getDistance(visits[i - 1], visits[i]) + VRPTWData->getDistance(visits[i], visits[i + 1]) -
+                                                    VRPTWData->getDistance(visits[i - 1], visits[i + 1])), visits[i]));
+         }
+         if (saving.empty())
+            break;
+         std::sort(saving.begin(), saving.end());
+         const size_t index = (size_t)(std::pow(neuralItem->getRandomNumber()->randExc(), 3) * saving.size());
+         removed[saving[index].second] = true;
+      }
+   }
+
+   for (size_t i = 1; i < n; i++)
+      if (removed[i])
+         pool.push_back(i);
+   removeCostumers(routes, removed);
+}
+
+inline void VRPRuinRecreate::recreate(std::vector<routeSchedule>& routes, std::vector<cityIDType>& pool, const unsigned k) const
+{
+   const size_t numberOfRoutes = routes.size();
+
+   // Best feasible insertion of each costumer of the pool into each route
+   std::vector<std::vector<double> > extra(pool.size(), std::vector<double>(numberOfRoutes));
+   std::vector<std::vector<size_t> > position(pool.size(), std::vector<size_t>(numberOfRoutes));
+   std::vector<std::vector<char> > feasible(pool.size(), std::vector<char>(numberOfRoutes));
+   for (size_t c = 0; c < pool.size(); c++)
+      for (size_t r = 0; r < numberOfRoutes; r++)
+         feasible[c][r] = bestInsertion(routes[r], pool[c], position[c][r], extra[c][r]);
+
+   std::vector<cityIDType> unplaced;
+   std::vector<double> costs;
+   while (!pool.empty())
+   {
+      bool found = false;
+      size_t bestCostumer = 0, bestRoute = 0;
+      double bestRegret = 0, bestExtra = 0;
+
+      for (size_t c = 0; c < pool.size(); c++)
+      {
+         costs.clear();
+         size_t route = 0;
+         for (size_t r = 0; r < numberOfRoutes; r++)
+            if (feasible[c][r])
+            {
+               if (costs.empty() || extra[c][r] < extra[c][route])
+                  route = r;
+               costs.push_back(extra[c][r]);
+            }
+         if (costs.empty())
+            continue;
+
+         // Regret: what is lost by inserting the costumer into its k - 1 next best routes
+         double regret = 0;
+         const size_t m = std::min<size_t>(k, costs.size());
+         std::partial_sort(costs.begin(), costs.begin() + m, costs.end());
+         for (size_t i = 1; i < k; i++)
+            regret += ((i < m) ? costs[i] : 1e9) - costs[0];
+
+         if (!found || regret > bestRegret || (regret == bestRegret && costs[0] < bestExtra))
+         {
+            found = true;
+            bestCostumer = c;
+            bestRoute = route;
+            bestRegret = regret;
+            bestExtra = costs[0];
+         }
+      }
+
+      if (!found)
+      {
+         unplaced.insert(unplaced.end(), pool.begin(), pool.end());
+         pool.clear();
+         break;
+      }
+
+      insertCostumer(routes[bestRoute], position[bestCostumer][bestRoute], pool[bestCostumer]);
+
+      pool.erase(pool.begin() + bestCostumer);
+      extra.erase(extra.begin() + bestCostumer);
+      position.erase(position.begin() + bestCostumer);
+      feasible.erase(feasible.begin() + bestCostumer);
+
+      // Only the route that changed is evaluated again
+      for (size_t c = 0; c < pool.size(); c++)
+         feasible[c][bestRoute] = bestInsertion(routes[bestRoute], pool[c], position[c][bestRoute], extra[c][bestRoute]);
+   }
+
+   // Costumers without feasible positions
+   repairRoutes(routes, unplaced);
+}
+
+inline void VRPRuinRecreate::updateWeights()
+{
+   for (size_t i = 0; i < this->ruinWeight.size(); i++)
+   {
+      if (this->ruinUses[i] > 0)
+         this->ruinWeight[i] = (1 - this->reaction) * this->ruinWeight[i] + this->reaction * this->ruinScore[i] / this->ruinUses[i];
+      this->ruinWeight[i] = std::max(this->ruinWeight[i], 0.05);
+      this->ruinScore[i] = 0;
+      this->ruinUses[i] = 0;
+   }
+   for (size_t i = 0; i < this->recreateWeight.size(); i++)
+   {
+      if (this->recreateUses[i] > 0)
+         this->recreateWeight[i] = (1 - this->reaction) * this->recreateWeight[i] + this->reaction * this->recreateScore[i] / this->recreateUses[i];
+      this->recreateWeight[i] = std::max(this->recreateWeight[i], 0.05);
+      this->recreateScore[i] = 0;
+      this->recreateUses[i] = 0;
+   }
+}
+
+inline bool VRPRuinRecreate::run(chromosomeType& chromosome, const unsigned iterations)
+{
+   std::vector<routeSchedule> current = splitRoutes(chromosome);
+   std::vector<routeSchedule> best = current;
+   const double initialCost = cost(current);
+   double currentCost = initialCost, bestCost = initialCost;
+
+   std::vector<cityIDType> pool;
+   for (unsigned it = 0; it < iterations; it++)
+   {
+      const unsigned ruinMethod = select(this->ruinWeight);
+      const unsigned recreateMethod = select(this->recreateWeight);
+
+      std::vector<routeSchedule> candidate = current;
+      pool.clear();
+      ruin(candidate, (ruinType)ruinMethod, pool);
+      recreate(candidate, pool, recreateMethod + 1);
+      const double candidateCost = cost(candidate);
+
+      // Scores: 33 new best, 9 better than the current one, 13 accepted
+      double score = 0;
+      if (candidateCost < bestCost - 1e-7)
+      {
+         score = 33;
+         best = candidate;
+         bestCost = candidateCost;
+      }
+      else if (candidateCost < currentCost - 1e-7)
+         score = 9;
+      else if (candidateCost <= bestCost * (1 + this->threshold))
+         score = 13;
+
+      if (score > 0)
+      {
+         current.swap(candidate);
+         currentCost = candidateCost;
+      }
+
+      this->ruinScore[ruinMethod] += score;
+      this->ruinUses[ruinMethod]++;
+      this->recreateScore[recreateMethod] += score;
+      this->recreateUses[recreateMethod]++;
+      if (++this->iteration % this->segmentLength == 0)
+         updateWeights();
+   }
+
+   if (bestCost < initialCost - 1e-7)
+   {
+      chromosome = joinRoutes(best);
+      return true;
+   }
+   return false;
+}
+
+inline void VRPRuinRecreate::saveState(stateStream& state) const
+{
+   state.writeVector(this->ruinWeight);
+   state.writeVector(this->ruinScore);
+   state.writeVector(this->ruinUses);
+   state.writeVector(this->recreateWeight);
+   state.writeVector(this->recreateScore);
+   state.writeVector(this->recreateUses);
+   state.write(this->iteration);
+}
+
+inline bool VRPRuinRecreate::loadState(stateStream& state)
+{
+   state.readVector(this->ruinWeight);
+   state.readVector(this->ruinScore);
+   state.readVector(this->ruinUses);
+   state.readVector(this->recreateWeight);
+   state.readVector(this->recreateScore);
+   state.readVector(this->recreateUses);
+   state.read(this->iteration);
+   if (this->ruinWeight.size() != numberOfRuins || this->ruinScore.size() != numberOfRuins || this->ruinUses.size() != numberOfRuins ||
+       this->recreateWeight.size() != numberOfRecreates || this->recreateScore.size() != numberOfRecreates || this->recreateUses.size() != numberOfRecreates)
+      state.fail();
+   return state.good();
+}
+
+#endif
@@ -27,6 +27,7 @@
 
 #include "./dataTypes.h"
 #include "./VRPTWDataProblem.h"
+#include "./VRPHash.h"
 
 #include <functional>
 #include <algorithm>
@@ -45,6 +46,12 @@ class VRPSolution : public multiObjectiveSolution
       */
       routesType::iterator routesIterator;
 
+      /**
+         Signature of the route-plan. It is computed the first time
+         it is asked for (0 means it has not been computed yet).
+      */
+      mutable hashType hash;
+
    protected:
 
    public:
@@ -52,7 +59,7 @@ class VRPSolution : public multiObjectiveSolution
       /**
          Default constructor. It does nothing.
       */
-      VRPSolution() { };
+      VRPSolution() : hash(0) { };
 
       /** 
          Alternative constructor. It gets the number of
@@ -86,6 +93,13 @@ class VRPSolution : public multiObjectiveSolution
       */
       void copy(const multiObjectiveSolution* const);
 
+      /**
+         Method that creates a copy of the solution.
+         @return a pointer to a new solution with the same
+         route-plan and objectives.
+      */
+      multiObjectiveSolution* clone() const;
+
       /**
          Method that initializes the strutures.
          It does the same as the Alterntive Constructor.
@@ -99,8 +113,10 @@ class VRPSolution : public multiObjectiveSolution
          Standard Constructor. 
          @param const routesType& is the object that contains
          the route-plan.
+         @param const hashType is the signature of the route-plan if
+         it is known (see swapHash), 0 to compute it when asked for.
       */
-      void setRoutes(const routesType&);
+      void setRoutes(const routesType&, const hashType = 0);
 
       /**
          Method that creates a random route-plan as a 
@@ -148,6 +164,37 @@ class VRPSolution : public multiObjectiveSolution
       */
       static bool isFeasible(const routesType&);
 
+      /**
+         Method that returns the signature of the route-plan (see VRPHash.h).
+         Route-plans that only differ in the order of their routes have the
+         same signature.
+         @return the signature of the route-plan.
+      */
+      hashType getHash() const;
+
+      /**
+         Method that returns whether the route-plan is the same as the one of another
+         solution, with its routes in the same order.
+         @param const multiObjectiveSolution* is the solution to be compared with.
+         @return true if both route-plans are the same.
+      */
+      bool equals(const multiObjectiveSolution* const) const;
+
+      /**
+         Method that writes the route-plan into a buffer of bytes.
+         @param std::vector<char>& is the buffer.
+      */
+      void pack(std::vector<char>&) const;
+
+      /**
+         Method that reads the route-plan from a buffer written by pack. The
+         route-plan is only accepted if it starts and ends at the depot and
+         it visits every costumer of the instance exactly once.
+         @param const std::vector<char>& is the buffer.
+         @return true if the route-plan was accepted.
+      */
+      bool unpack(const std::vector<char>&);
+
       /**
          Method that formats the solution in a std::string.
          @return a std::string with the solution data.
@@ -158,12 +205,14 @@ class VRPSolution : public multiObjectiveSolution
 VRPSolution::VRPSolution(const routesType& routes)
 {
    this->routes = routes;
+   this->hash = 0;
 }
 
 VRPSolution::VRPSolution(const unsigned& numberOfCostumers)
 {
    for (size_t i = 1; i < numberOfCostumers; i++)
       this->routes.push_back(i);
+   this->hash = 0;
 }
 
 void VRPSolution::copy(const multiObjectiveSolution* const newSolution)
@@ -171,15 +220,24 @@ void VRPSolution::copy(const multiObjectiveSolution* const newSolution)
    // Routes
    const VRPSolution* const newVRPSolution = static_cast<const VRPSolution* const>(newSolution);
    this->routes = newVRPSolution->getRoutes();
+   this->hash = newVRPSolution->hash;
 
    // The objectives of the mother class
    setObjectives(newSolution->getObjectives());
 }
 
+multiObjectiveSolution* VRPSolution::clone() const
+{
+   VRPSolution* newSolution = new VRPSolution();
+   newSolution->copy(this);
+   return newSolution;
+}
+
 void VRPSolution::initialize(const unsigned& numberOfCities)
 {
    for (size_t i = 0; i < numberOfCities; i++)
       this->routes.push_back(i);
+   this->hash = 0;
 }
 
 const unsigned VRPSolution::getNumberOfRoutes()
@@ -211,11 +269,13 @@ inline void VRPSolution::setRandomRoutes(const unsigned& n = 10)
    random_shuffle(routes.begin(), routes.end(), p_myrandom);
    routes.insert(routes.begin(), 0);
    routes.push_back(0);
+   this->hash = 0;
 }
 
-inline void VRPSolution::setRoutes(const routesType& routes)
+inline void VRPSolution::setRoutes(const routesType& routes, const hashType hash)
 {
    this->routes = routes;   
+   this->hash = hash;
 }
 
 inline const routesType& VRPSolution::getRoutes() const
@@ -228,6 +288,55 @@ inline const routesType* VRPSolution::getPointerToRoutes() const
    return &(this->routes); 
 }
 
+inline hashType VRPSolution::getHash() const
+{
+   if (this->hash == 0)
+      this->hash = routesHash(this->routes);
+   return this->hash;
+}
+
+inline bool VRPSolution::equals(const multiObjectiveSolution* const solution) const
+{
+   // The signatures tell most of the different route-plans apart at once
+   const VRPSolution* const otherSolution = static_cast<const VRPSolution* const>(solution);
+   return (getHash() == otherSolution->getHash() && this->routes == otherSolution->routes);
+}
+
+inline void VRPSolution::pack(std::vector<char>& buffer) const
+{
+   buffer.clear();
+   if (this->routes.empty())
+      return;
+   const char* const data = reinterpret_cast<const char*>(&this->routes[0]);
+   buffer.assign(data, data + this->routes.size() * sizeof(cityIDType));
+}
+
+inline bool VRPSolution::unpack(const std::vector<char>& buffer)
+{
+   const size_t numberOfCities = VRPTWDataProblem::instance()->getClientCoords().size();
+   if (buffer.empty() || buffer.size() % sizeof(cityIDType) != 0)
+      return false;
+
+   routesType routes(buffer.size() / sizeof(cityIDType));
+   std::copy(buffer.begin(), buffer.end(), reinterpret_cast<char*>(&routes[0]));
+   if (routes.front() != 0 || routes.back() != 0)
+      return false;
+
+   std::vector<bool> visited(numberOfCities, false);
+   for (size_t i = 0; i < routes.size(); i++)
+   {
+      if (routes[i] >= numberOfCities || (routes[i] != 0 && visited[routes[i]]))
+         return false;
+      visited[routes[i]] = true;
+   }
+   if (std::count(visited.begin() + 1, visited.end(), false) != 0)
+      return false;
+
+   this->routes.swap(routes);
+   this->hash = 0;
+   return true;
+}
+
 std::ostream& operator<<(std::ostream& os, const VRPSolution& object)
 {
    os << std::endl;
@@ -0,0 +1,303 @@
+/**
+   @class VRPSpatialIndex
+
+   @brief Uniform grid over the positions of the costumers.
+
+   Looking for the costumers close to a given one used to mean scanning a
+   whole row of the distance matrix, and building a neighbour list for every
+   costumer took O(n^2 log n). This class buckets the costumers into a grid of
+   square cells with about VRPSPATIALINDEXDENSITY costumers per cell, so that:
+
+   - k-nearest queries visit rings of cells around the costumer until no
+     unvisited cell can hold a closer one, and
+   - radius queries only visit the cells that overlap the circle.
+
+   Both return the costumers sorted by Euclidean distance and then by id, the
+   order a sort of (distance, id) pairs of a row of the matrix gives, so the
+   operators that use them behave as before. Queries can leave the depot out
+   and keep only the costumers whose time windows are compatible with the one
+   of the given costumer: one of them can be served after the other one,
+   travelling at unit speed.
+
+   Building the grid takes O(n) and it is read-only afterwards, so agents
+   running in parallel can share it.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef VRPSPATIALINDEX_H
+#define VRPSPATIALINDEX_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "dataTypes.h"
+
+/**
+   Mean number of costumers per cell of the grid.
+*/
+#ifndef VRPSPATIALINDEXDENSITY
+#define VRPSPATIALINDEXDENSITY 2
+#endif
+
+class VRPSpatialIndex
+{
+   private:
+      /**
+         Positions, time windows and service times of the costumers.
+      */
+      coordsType coords;
+      timeWindowType timeWindow;
+      serviceTimeType serviceTime;
+
+      /**
+         Corner of the grid, side of the cells and number of cells per axis.
+      */
+      double minX, minY, cellSize;
+      long columns, rows;
+
+      /**
+         Costumers of each cell, by rows.
+      */
+      std::vector<std::vector<cityIDType> > cells;
+
+      /**
+         Number of costumers when the grid was built. Costumers inserted afterwards go
+         into the cells that contain them or, if they are outside the grid, into the
+         closest ones, which keeps the queries exact; the grid is built again when
+         the number of costumers doubles.
+      */
+      size_t builtSize;
+
+      long columnOf(const double x) const;
+      long rowOf(const double y) const;
+
+      /**
+         Method that adds the costumers of a cell that pass the filters to the candidates.
+      */
+      void addCell(const long, const long, const cityIDType, const bool, const bool, std::vector<std::pair<double, cityIDType> >&) const;
+
+   protected:
+
+   public:
+      /**
+         Default constructor. The index is empty until it is built.
+      */
+      VRPSpatialIndex();
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~VRPSpatialIndex() { };
+
+      /**
+         Method that builds the grid.
+         @param const coordsType& are the positions of the costumers (the depot is 0).
+         @param const timeWindowType& are their time windows.
+         @param const serviceTimeType& are their service times.
+      */
+      void build(const coordsType&, const timeWindowType&, const serviceTimeType&);
+
+      /**
+         Method that adds a costumer, whose id is the number of costumers so far.
+         @param const pointType& is its position.
+         @param const singleTimeWindowType& is its time window.
+         @param const timeType is its service time.
+      */
+      void insert(const pointType&, const singleTimeWindowType&, const timeType);
+
+      size_t size() const { return this->coords.size(); }
+
+      /**
+         Method that returns the Euclidean distance between two costumers, computed as
+         the distance matrix is (see VRPTWDataProblem::calculateDistanceMatrix).
+      */
+      double distance(const cityIDType, const cityIDType) const;
+
+      /**
+         Method that returns whether one of the costumers can be served after the other one.
+      */
+      bool areCompatible(const cityIDType, const cityIDType) const;
+
+      /**
+         Method that looks for the closest costumers to a given one.
+         @param const cityIDType is the costumer (it is never returned).
+         @param const unsigned is the number of costumers to look for.
+         @param std::vector<cityIDType>& is where they are stored, from the closest one.
+         @param const bool is true to consider the depot.
+         @param const bool is true to keep only the costumers with compatible time windows.
+      */
+      void nearest(const cityIDType, const unsigned, std::vector<cityIDType>&, const bool = false, const bool = false) const;
+
+      /**
+         Method that looks for the costumers within a distance of a given one.
+         @param const cityIDType is the costumer (it is never returned).
+         @param const double is the distance.
+         @param std::vector<cityIDType>& is where they are stored, from the closest one.
+         @param const bool is true to consider the depot.
+         @param const bool is true to keep only the costumers with compatible time windows.
+      */
+      void withinRadius(const cityIDType, const double, std::vector<cityIDType>&, const bool = false, const bool = false) const;
+};
+
+VRPSpatialIndex::VRPSpatialIndex()
+{
+   this->minX = this->minY = 0;
+   this->cellSize = 1;
+   this->columns = this->rows = 0;
+   this->builtSize = 0;
+}
+
+inline long VRPSpatialIndex::columnOf(const double x) const
+{
+   return std::min(std::max((long)((x - this->minX) / this->cellSize), 0L), this->columns - 1);
+}
+
+inline long VRPSpatialIndex::rowOf(const double y) const
+{
+   return std::min(std::max((long)((y - this->minY) / this->cellSize), 0L), this->rows - 1);
+}
+
+void VRPSpatialIndex::build(const coordsType& coords, const timeWindowType& timeWindow, const serviceTimeType& serviceTime)
+{
+   this->coords = coords;
+   this->timeWindow = timeWindow;
+   this->serviceTime = serviceTime;
+   this->cells.clear();
+   this->columns = this->rows = 0;
+   this->builtSize = coords.size();
+   if (coords.empty())
+      return;
+
+   double maxX = coords[0].first, maxY = coords[0].second;
+   this->minX = maxX;
+   this->minY = maxY;
+   for (size_t i = 1; i < coords.size(); i++)
+   {
+      this->minX = std::min(this->minX, coords[i].first);
+      this->minY = std::min(this->minY, coords[i].second);
+      maxX = std::max(maxX, coords[i].first);
+      maxY = std::max(maxY, coords[i].second);
+   }
+
+   // Cells are squares, so elongated instances get more cells along their long side
+   const double width = std::max(maxX - this->minX, 1e-9), height = std::max(maxY - this->minY, 1e-9);
+   const double numberOfCells = std::max((double)coords.size() / VRPSPATIALINDEXDENSITY, 1.0);
+   this->cellSize = std::max(std::sqrt(width * height / numberOfCells), std::max(width, height) / numberOfCells);
+   this->columns = (long)(width / this->cellSize) + 1;
+   this->rows = (long)(height / this->cellSize) + 1;
+
+   this->cells.assign(this->columns * this->rows, std::vector<cityIDType>());
+   for (size_t i = 0; i < coords.size(); i++)
+      this->cells[rowOf(coords[i].second) * this->columns + columnOf(coords[i].first)].push_back(i);
+}
+
+void VRPSpatialIndex::insert(const pointType& position, const singleTimeWindowType& window, const timeType service)
+{
+   this->coords.push_back(position);
+   this->timeWindow.push_back(window);
+   this->serviceTime.push_back(service);
+
+   if (this->coords.size() >= 2 * this->builtSize)
+   {
+      const coordsType coords(this->coords);
+      const timeWindowType timeWindow(this->timeWindow);
+      const serviceTimeType serviceTime(this->serviceTime);
+      build(coords, timeWindow, serviceTime);
+   }
+   else
+      this->cells[rowOf(position.second) * this->columns + columnOf(position.first)].push_back(this->coords.size() - 1);
+}
+
+inline double VRPSpatialIndex::distance(const cityIDType i, const cityIDType j) const
+{
+   return sqrt(pow(this->coords[j].first - this->coords[i].first, 2) + pow(this->coords[j].second - this->coords[i].second, 2));
+}
+
+inline bool VRPSpatialIndex::areCompatible(const cityIDType i, const cityIDType j) const
+{
+   const double travel = distance(i, j);
+   return (this->timeWindow[i].first + this->serviceTime[i] + travel <= this->timeWindow[j].second) ||
+          (this->timeWindow[j].first + this->serviceTime[j] + travel <= this->timeWindow[i].second);
+}
+
+inline void VRPSpatialIndex::addCell(const long column, const long row, const cityIDType id, const bool depot, const bool compatible,
+                                     std::vector<std::pair<double, cityIDType> >& candidates) const
+{
+   if (column < 0 || row < 0 || column >= this->columns || row >= this->rows)
+      return;
+
+   const std::vector<cityIDType>& cell = this->cells[row * this->columns + column];
+   for (size_t i = 0; i < cell.size(); i++)
+      if (cell[i] != id && (depot || cell[i] != 0) && (!compatible || areCompatible(id, cell[i])))
+         candidates.push_back(std::make_pair(distance(id, cell[i]), cell[i]));
+}
+
+void VRPSpatialIndex::nearest(const cityIDType id, const unsigned k, std::vector<cityIDType>& neighbours,
+                              const bool depot, const bool compatible) const
+{
+   assert(id < this->coords.size());
+
+   neighbours.clear();
+   if (k == 0)
+      return;
+
+   const long column = columnOf(this->coords[id].first), row = rowOf(this->coords[id].second);
+   const long maxRing = std::max(std::max(column, this->columns - 1 - column), std::max(row, this->rows - 1 - row));
+
+   // Costumers beyond ring r are farther than r cells, so the search stops when the
+   //    k-th closest costumer found so far is closer than that
+   std::vector<std::pair<double, cityIDType> > candidates;
+   for (long ring = 0; ring <= maxRing; ring++)
+   {
+      if (ring == 0)
+         addCell(column, row, id, depot, compatible, candidates);
+      else
+      {
+         for (long c = column - ring; c <= column + ring; c++)
+         {
+            addCell(c, row - ring, id, depot, compatible, candidates);
+            addCell(c, row + ring, id, depot, compatible, candidates);
+         }
+         for (long r = row - ring + 1; r <= row + ring - 1; r++)
+         {
+            addCell(column - ring, r, id, depot, compatible, candidates);
+            addCell(column + ring, r, id, depot, compatible, candidates);
+         }
+      }
+
+      if (candidates.size() >= k)
+      {
+         std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end());
+         if (candidates[k - 1].first < ring * this->cellSize)
+            break;
+      }
+   }
+
+   const size_t found = std::min<size_t>(k, candidates.size());
+   std::partial_sort(candidates.begin(), candidates.begin() + found, candidates.end());
+   for (size_t i = 0; i < found; i++)
+      neighbours.push_back(candidates[i].second);
+}
+
+void VRPSpatialIndex::withinRadius(const cityIDType id, const double radius, std::vector<cityIDType>& neighbours,
+                                   const bool depot, const bool compatible) const
+{
+   assert(id < this->coords.size());
+
+   neighbours.clear();
+   std::vector<std::pair<double, cityIDType> > candidates;
+   const long lastColumn = columnOf(this->coords[id].first + radius), lastRow = rowOf(this->coords[id].second + radius);
+   for (long r = rowOf(this->coords[id].second - radius); r <= lastRow; r++)
+      for (long c = columnOf(this->coords[id].first - radius); c <= lastColumn; c++)
+         addCell(c, r, id, depot, compatible, candidates);
+
+   std::sort(candidates.begin(), candidates.end());
+   for (size_t i = 0; i < candidates.size() && candidates[i].first <= radius; i++)
+      neighbours.push_back(candidates[i].second);
+}
+
+#endif
@@ -13,6 +13,8 @@
 #ifndef VRPTWDATAPROBLEM_H
 #define VRPTWDATAPROBLEM_H
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <cstdlib>
 #include <iomanip>
@@ -20,13 +22,29 @@
 
 #include "../../libs/conversions.h"
 #include "dataTypes.h"
+#include "VRPDistances.h"
+#include "VRPSpatialIndex.h"
 #include "../../libs/IOlibrary.h"
 #include "../../libs/funcLibrary.h"
 
 #define isIn(n, l, u) (n >= l && n <= u)
 
+/**
+   Number of costumers above which Euclidean distances are computed on demand
+   instead of stored in a matrix (see VRPTWDataProblem::setDistanceMode).
+*/
+#ifndef VRPDENSEDISTANCESLIMIT
+#define VRPDENSEDISTANCESLIMIT 8000
+#endif
+
 class VRPTWDataProblem 
 {
+   public:
+      /**
+         Ways of providing the distances (see setDistanceMode).
+      */
+      enum distanceModeType { automaticDistances, denseDistances, onDemandDistances };
+
    private:
       /**
          Singleton Pattern. This pointers refers to itself.
@@ -44,9 +62,26 @@ class VRPTWDataProblem
       distanceMatrixType distanceMatrix;
 
       /** 
-         Matrix that stores the travel time between any pair of clients.
+         Matrix that stores the travel time between any pair of clients, by rows of
+         timeStride elements. It is empty if travel times are the distances.
       */
       timeMatrixType timeMatrix;
+      size_t timeStride;
+
+      /**
+         True if the distances were given (e.g. by a road-network router) instead of
+         calculated from the positions. They may differ from one way to the other.
+      */
+      bool givenDistances;
+
+      /**
+         Way of providing the distances and whether they are computed on demand, in
+         which case the matrix is empty. The positions are kept by coordinate too,
+         as the distances are computed from them (see VRPOnDemandDistances).
+      */
+      distanceModeType distanceMode;
+      bool onDemand;
+      std::vector<double> coordX, coordY;
 
       /** 
          Vector that stores the service time of the clients, i.e, the time
@@ -70,16 +105,57 @@ class VRPTWDataProblem
       demandType demand; 
 
       /**
-         Matrix that divides the costumers in zones
+         Matrix that divides the costumers in zones: zone i holds, in order of id,
+         the costumers whose time window midpoint is in (i * zoneLength, (i + 1) * zoneLength].
+         It is the time-bucket index used to look for temporally compatible costumers.
       */
       costumerZoneType costumerZone;
+
+      /**
+         Zone of each costumer and length of the zones.
+      */
+      std::vector<unsigned> zoneOfCostumer;
+      long zoneLength;
+
+      /**
+         Method that returns the zone a time falls into (the last one if it is beyond the zones).
+      */
+      unsigned zoneOfTime(const long) const;
+
+      /**
+         Grid over the positions of the costumers for proximity queries.
+      */
+      VRPSpatialIndex spatialIndex;
+
+      /**
+         Scale of the integer cost mode (0 if costs are floating-point).
+      */
+      unsigned costScale;
+
+      /**
+         Distances, time windows and service times multiplied by the scale and
+         truncated to integers, only in the integer cost mode. Distances are
+         stored by rows of scaledStride elements in a single vector, so rows have
+         room for the costumers that arrive during the run (see addCostumer).
+      */
+      std::vector<scaledCostType> scaledDistance, scaledTravelTime;
+      size_t scaledStride;
+      std::vector<scaledCostType> scaledReadyTime, scaledDueTime, scaledServiceTime;
+
+      /**
+         Method that builds the scaled data and rounds the distance matrix to it.
+         @param const bool is false if the distances are already scaled (see
+         VRPDistanceMatrixBuilder).
+      */
+      void scaleCosts(const bool = true);
       
 
    protected:
       /**
-         Default constructor. It does nothing.
+         Default constructor. Costs are floating-point.
       */
-      VRPTWDataProblem() { };
+      VRPTWDataProblem() : timeStride(0), givenDistances(false), distanceMode(automaticDistances), onDemand(false),
+                           zoneLength(0), costScale(0), scaledStride(0) { };
 
       /**
          Default destructor. It does nothing.
@@ -107,14 +183,16 @@ class VRPTWDataProblem
       void setClientCoords(const coordsType&); 
 
       /**
-         Method that sets the distance matrix.
+         Method that sets the distance matrix. It may be asymmetric, and
+         calculateDistanceMatrix keeps it instead of using the positions.
          @param const distanceMatrixType& is the matrix that contains the matrix distance.
       */
       void setDistanceMatrix(const distanceMatrixType&);
 
       /**
-         Method that sets the travel time matrix.
-         @param const timeMatrixType& is the matrix that contains the matrix time travel.
+         Method that sets the travel time matrix. It may be asymmetric. Without it,
+         the travel times are the distances.
+         @param const timeMatrixType& is the matrix that contains the matrix time travel, by rows.
       */
       void setTimeMatrix(const timeMatrixType&);
 
@@ -148,18 +226,76 @@ class VRPTWDataProblem
       */
       const coordsType& getClientCoords() const { return this->clientCoords; };
 
+      /**
+         Method that returns the spatial index of the costumers, built along with the
+         distance matrix (see calculateDistanceMatrix).
+      */
+      const VRPSpatialIndex& getSpatialIndex() const { return this->spatialIndex; }
+
       /**
          Method that returns the distances between any two pair of clients.
-         @return a matrix tha contains the matrix with de distances.
+         @return a matrix tha contains the matrix with de distances (empty if they are
+         computed on demand).
       */
       const distanceMatrixType& getDistanceMatrix() const;
 
+      /**
+         Method that sets how the distances are provided: a matrix, computed from the
+         positions when they are needed, or the latter only for instances of more
+         than VRPDENSEDISTANCESLIMIT costumers (the default). Given distances are
+         always a matrix. It must be called before calculateDistanceMatrix.
+      */
+      void setDistanceMode(const distanceModeType mode) { this->distanceMode = mode; }
+
+      bool isOnDemand() const { return this->onDemand; }
+
+      /**
+         Methods that return the providers of the distances (see VRPDistances.h). The
+         one that matches isOnDemand must be used.
+      */
+      VRPDenseDistances getDenseDistances() const
+      { return VRPDenseDistances(this->distanceMatrix, this->timeMatrix, this->scaledDistance, this->scaledTravelTime, this->scaledStride); }
+      VRPOnDemandDistances getOnDemandDistances() const
+      { return VRPOnDemandDistances(this->coordX, this->coordY, this->costScale); }
+
+      /**
+         Method that returns a distance, whatever the provider is. Loops over many
+         distances should use the providers instead.
+      */
+      double getDistance(const cityIDType i, const cityIDType j) const
+      { return this->onDemand ? getOnDemandDistances().distance(i, j) : this->distanceMatrix[i][j]; }
+
       /**
          Method that returns the time travel between any to pair of clients.
-         @return a vector that contains the coords of the client.
+         @return the matrix by rows, empty if travel times are the distances.
       */
       const timeMatrixType& getTimeMatrix() const;
 
+      /**
+         Method that returns the time it takes to go from a costumer to another one.
+      */
+      double getTravelTime(const cityIDType i, const cityIDType j) const
+      { return this->onDemand ? getOnDemandDistances().travelTime(i, j) : getDenseDistances().travelTime(i, j); }
+
+      /**
+         Method that looks for the closest costumers to a given one (in the distances
+         from it). The spatial index answers it from the positions, unless the distances
+         were given: then the row of the costumer is scanned.
+         @param const cityIDType is the costumer (it is never returned).
+         @param const unsigned is the number of costumers to look for.
+         @param std::vector<cityIDType>& is where they are stored, from the closest one.
+         @param const bool is true to consider the depot.
+      */
+      void nearest(const cityIDType, const unsigned, std::vector<cityIDType>&, const bool = false) const;
+
+      /**
+         Method that returns a lower bound of the distance from a costumer to another
+         one that never decreases along the costumers returned by nearest: the
+         Euclidean distance, or the distance itself if the distances were given.
+      */
+      double nearestDistance(const cityIDType i, const cityIDType j) const
+      { return this->givenDistances ? this->distanceMatrix[i][j] : this->spatialIndex.distance(i, j); }
+
       /**
          Method that returns the service time of the clients
          @return a vector that contains the service time of the clients.
@@ -187,9 +323,36 @@ class VRPTWDataProblem
       /**
          Method that returns the zone a costumer is depending on the time window it has
          @return the zone according to the time window the costumer is in
+         @warning createZones must have been called.
       */
       const cityIDType getZone(cityIDType) const;
 
+      /**
+         Method that returns the number of zones (0 until createZones is called).
+      */
+      unsigned getNumberOfZones() const { return this->costumerZone.size(); }
+
+      /**
+         Method that returns the costumers of a zone.
+      */
+      const std::vector<cityIDType>& getCostumersInZone(const unsigned zone) const { return this->costumerZone[zone]; }
+
+      /**
+         Method that returns the midpoint of the time window of a costumer.
+      */
+      long getTimeWindowMidpoint(const cityIDType id) const { return (this->timeWindow[id].first + this->timeWindow[id].second) / 2; }
+
+      /**
+         Method that looks for the costumers whose time window midpoint is close to
+         the one of a costumer. Only the zones that may hold them are scanned.
+         @param const cityIDType is the costumer.
+         @param const long is the maximum difference between the midpoints.
+         @param std::vector<cityIDType>& is where the costumers are stored (the
+         costumer itself and the depot are not included).
+         @warning createZones must have been called.
+      */
+      void getTemporalNeighbours(const cityIDType, const long, std::vector<cityIDType>&) const;
+
       /**
          Method to add a new vehicle into the fleet.
          @param const vehicle& is the new vechile to be added.
@@ -222,17 +385,71 @@ class VRPTWDataProblem
 
       /**
          Method that sets the distance matrix by using the coords of the clients.
-         It applies the Ecludian equation to calculate the distance.
+         It applies the Ecludian equation to calculate the distance, unless the
+         distances were given (see setDistanceMatrix) or they are computed on
+         demand (see setDistanceMode).
       */
       void calculateDistanceMatrix();
 
-  
+      /**
+         Method that adds a costumer once the distance matrix has been calculated, as
+         when orders arrive during the run. Only the distances from the new costumer
+         are calculated, and the spatial index, the zones and the scaled data grow.
+         @param const pointType& is the position of the costumer.
+         @param const singleDemandType is its demand.
+         @param const singleTimeWindowType& is its time window.
+         @param const timeType is its service time.
+         @return the id of the new costumer.
+         @warning No agent can be running, since the matrix is reallocated. The distances
+         and travel times must not have been given, since they are calculated.
+      */
+      cityIDType addCostumer(const pointType&, const singleDemandType, const singleTimeWindowType&, const timeType);
+
+      /**
+         Method that sets the integer cost mode. Distances are multiplied by the
+         scale and truncated, as usual in the literature (a scale of 10 keeps a
+         decimal), and the objectives accumulate integers, so a route-plan gets
+         exactly the same values whatever the order of the operations. The
+         distance matrix is rounded to the same values, so the heuristics agree
+         with the evaluations.
+         @param const unsigned is the scale (0 for floating-point costs, the default).
+      */
+      void setCostScale(const unsigned);
+
+      unsigned getCostScale() const { return this->costScale; }
+
+      /**
+         Methods that return the scaled data (only in the integer cost mode).
+      */
+      scaledCostType getScaledDistance(const cityIDType i, const cityIDType j) const
+      { return this->onDemand ? getOnDemandDistances().scaledDistance(i, j) : getDenseDistances().scaledDistance(i, j); }
+      scaledCostType getScaledTravelTime(const cityIDType i, const cityIDType j) const
+      { return this->onDemand ? getOnDemandDistances().scaledTravelTime(i, j) : getDenseDistances().scaledTravelTime(i, j); }
+      scaledCostType getScaledReadyTime(const cityIDType i) const { return this->scaledReadyTime[i]; }
+      scaledCostType getScaledDueTime(const cityIDType i) const { return this->scaledDueTime[i]; }
+      scaledCostType getScaledServiceTime(const cityIDType i) const { return this->scaledServiceTime[i]; }
+
+      /**
+         Method that converts a scaled cost back to the units of the instance.
+      */
+      double unscale(const scaledCostType cost) const { return (double)cost / this->costScale; }
 
       /**
           Method that classify costumers by their time window
           @param unsigned is the number of vehicles we are going to use
+          @param const bool is true to print the zones (for debugging purposes)
+      */
+      void createZones(unsigned, const bool = false);
+
+      /**
+         Methods that keep several instances in memory (see the daemon mode of CODEA2).
+         Since the agents read the data from the singleton, an instance is loaded into
+         it, copied out and restored into it when it is solved.
       */
-      void createZones(unsigned);
+      VRPTWDataProblem* clone() const { return new VRPTWDataProblem(*this); }
+      static void dispose(VRPTWDataProblem* data) { delete data; }
+      void restore(const VRPTWDataProblem& data) { *this = data; }
+      void clear() { *this = VRPTWDataProblem(); }
 
       /** 
          Method that prints the attributes of this objects.
@@ -259,11 +476,16 @@ VRPTWDataProblem* VRPTWDataProblem::instance()
 inline void VRPTWDataProblem::setDistanceMatrix(const distanceMatrixType& distanceMatrix)
 {
    this->distanceMatrix = distanceMatrix;
+   this->givenDistances = true;
+   for (size_t i = 0; i < distanceMatrix.size(); i++)
+      assert(distanceMatrix[i].size() == distanceMatrix.size());
 }
 
 inline void VRPTWDataProblem::setTimeMatrix(const timeMatrixType& timeMatrix)
 {
    this->timeMatrix = timeMatrix;
+   this->timeStride = (size_t)(sqrt((double)timeMatrix.size()) + 0.5);
+   assert(this->timeStride * this->timeStride == timeMatrix.size());
 }
 
 inline void VRPTWDataProblem::setServiceTime(const serviceTimeType& serviceTime)
@@ -343,51 +565,217 @@ inline void VRPTWDataProblem::insertServiceTime(const timeType& singleServiceTim
 
 inline void VRPTWDataProblem::calculateDistanceMatrix()
 {
-   distanceMatrix.resize(clientCoords.size());
-   for (coordsType::size_type i = 0; i < clientCoords.size(); i++)
-      distanceMatrix[i].resize(clientCoords.size());
+   if (this->givenDistances)
+   {
+      assert(this->distanceMatrix.size() == clientCoords.size());
+      spatialIndex.build(clientCoords, timeWindow, serviceTime);
+      if (this->costScale > 0)
+         scaleCosts();
+      return;
+   }
 
+   // Positions by coordinate, as the distances are computed from them
+   coordX.resize(clientCoords.size());
+   coordY.resize(clientCoords.size());
    for (coordsType::size_type i = 0; i < clientCoords.size(); i++)
-   { 
-      distanceMatrix[i][i] = 0;
-      for (coordsType::size_type j = 0; j < clientCoords.size(); j++)
-         if (i != j)
+   {
+      coordX[i] = clientCoords[i].first;
+      coordY[i] = clientCoords[i].second;
+   }
+
+   this->onDemand = (this->distanceMode == onDemandDistances) ||
+                    (this->distanceMode == automaticDistances && clientCoords.size() > VRPDENSEDISTANCESLIMIT + 1);
+   if (this->onDemand)
+   {
+      distanceMatrixType().swap(distanceMatrix);
+
+      spatialIndex.build(clientCoords, timeWindow, serviceTime);
+      if (this->costScale > 0)
+         scaleCosts();
+      return;
+   }
+
+   // The builder truncates the distances in the integer cost mode
+   VRPDistanceMatrixBuilder builder(coordX, coordY, distanceMatrix, scaledDistance, this->costScale);
+   builder.build();
+
+   spatialIndex.build(clientCoords, timeWindow, serviceTime);
+   if (this->costScale > 0)
+      scaleCosts(false);
+}
+
+inline void VRPTWDataProblem::setCostScale(const unsigned scale)
+{
+   this->costScale = scale;
+   if (scale > 0 && (!this->distanceMatrix.empty() || this->onDemand))
+      scaleCosts();
+}
+
+inline void VRPTWDataProblem::scaleCosts(const bool scaleDistances)
+{
+   const size_t n = this->distanceMatrix.size();
+   const double scale = this->costScale;
+
+   // Distances computed on demand are scaled by the provider, the matrix is empty then
+
+   // The margin keeps integral distances (exact in floating-point) from being truncated down
+   this->scaledStride = n;
+   if (scaleDistances)
+   {
+      this->scaledDistance.resize(n * n);
+      for (size_t i = 0; i < n; i++)
+         for (size_t j = 0; j < n; j++)
          {
-            distanceMatrix[i][j] = sqrt(pow(clientCoords[j].first - clientCoords[i].first, 2) 
-                                      + pow(clientCoords[j].second - clientCoords[i].second, 2));
-            distanceMatrix[j][i] = distanceMatrix[i][j];
+            this->scaledDistance[i * n + j] = (scaledCostType)(this->distanceMatrix[i][j] * scale + 1e-6);
+            this->distanceMatrix[i][j] = this->scaledDistance[i * n + j] / scale;
          }
    }
+   if (!this->timeMatrix.empty())
+   {
+      assert(this->timeStride == n);
+      this->scaledTravelTime.resize(n * n);
+      for (size_t k = 0; k < n * n; k++)
+      {
+         this->scaledTravelTime[k] = (scaledCostType)(this->timeMatrix[k] * scale + 1e-6);
+         this->timeMatrix[k] = this->scaledTravelTime[k] / scale;
+      }
+   }
+
+   this->scaledReadyTime.resize(this->timeWindow.size());
+   this->scaledDueTime.resize(this->timeWindow.size());
+   for (size_t i = 0; i < this->timeWindow.size(); i++)
+   {
+      this->scaledReadyTime[i] = (scaledCostType)this->timeWindow[i].first * this->costScale;
+      this->scaledDueTime[i] = (scaledCostType)this->timeWindow[i].second * this->costScale;
+   }
+   this->scaledServiceTime.resize(this->serviceTime.size());
+   for (size_t i = 0; i < this->serviceTime.size(); i++)
+      this->scaledServiceTime[i] = (scaledCostType)this->serviceTime[i] * this->costScale;
+}
+
+cityIDType VRPTWDataProblem::addCostumer(const pointType& position, const singleDemandType demand,
+                                         const singleTimeWindowType& window, const timeType service)
+{
+   assert(!this->distanceMatrix.empty() || this->onDemand);
+   if (this->givenDistances || !this->timeMatrix.empty())
+   {
+      std::cout << "ERROR[!] Costumers cannot be added when distances or travel times are given" << std::endl;
+      exit(1);
+   }
+
+   const cityIDType id = this->clientCoords.size();
+   insertCoord(position);
+   insertDemand(demand);
+   insertTimeWindow(window);
+   insertServiceTime(service);
+
+   this->coordX.push_back(position.first);
+   this->coordY.push_back(position.second);
+   if (!this->onDemand)
+   {
+      this->distanceMatrix.push_back(std::vector<distanceType>(id + 1, 0));
+      for (cityIDType i = 0; i < id; i++)
+      {
+         distanceType distance = sqrt(pow(position.first - clientCoords[i].first, 2)
+                                    + pow(position.second - clientCoords[i].second, 2));
+         if (this->costScale > 0)
+            distance = (scaledCostType)(distance * this->costScale + 1e-6) / (double)this->costScale;
+         this->distanceMatrix[i].push_back(distance);
+         this->distanceMatrix[id][i] = distance;
+      }
+   }
+
+   if (this->costScale > 0 && !this->onDemand)
+   {
+      // Rows get room for as many costumers again, so the matrix is not moved on every arrival
+      if (id + 1 > this->scaledStride)
+      {
+         const size_t stride = 2 * (id + 1);
+         std::vector<scaledCostType> grown(stride * stride);
+         for (size_t i = 0; i < id; i++)
+            std::copy(this->scaledDistance.begin() + i * this->scaledStride,
+                      this->scaledDistance.begin() + i * this->scaledStride + id, grown.begin() + i * stride);
+         this->scaledDistance.swap(grown);
+         this->scaledStride = stride;
+      }
+      for (size_t i = 0; i <= id; i++)
+      {
+         const scaledCostType distance = (scaledCostType)(this->distanceMatrix[i][id] * this->costScale + 1e-6);
+         this->scaledDistance[i * this->scaledStride + id] = distance;
+         this->scaledDistance[id * this->scaledStride + i] = distance;
+      }
+   }
+   if (this->costScale > 0)
+   {
+      this->scaledReadyTime.push_back((scaledCostType)window.first * this->costScale);
+      this->scaledDueTime.push_back((scaledCostType)window.second * this->costScale);
+      this->scaledServiceTime.push_back((scaledCostType)service * this->costScale);
+   }
+
+   this->spatialIndex.insert(position, window, service);
+   if (!this->costumerZone.empty())
+   {
+      this->zoneOfCostumer.push_back(zoneOfTime(getTimeWindowMidpoint(id)));
+      this->costumerZone[this->zoneOfCostumer[id]].push_back(id);
+   }
+   return id;
+}
+
+void VRPTWDataProblem::nearest(const cityIDType id, const unsigned k, std::vector<cityIDType>& neighbours, const bool depot) const
+{
+   if (!this->givenDistances)
+   {
+      this->spatialIndex.nearest(id, k, neighbours, depot);
+      return;
+   }
+
+   // Ties are broken by id, as in the spatial index
+   std::vector<std::pair<distanceType, cityIDType> > candidates;
+   candidates.reserve(this->distanceMatrix.size());
+   for (cityIDType j = depot ? 0 : 1; j < this->distanceMatrix.size(); j++)
+      if (j != id)
+         candidates.push_back(std::make_pair(this->distanceMatrix[id][j], j));
+
+   const size_t found = std::min<size_t>(k, candidates.size());
+   std::partial_sort(candidates.begin(), candidates.begin() + found, candidates.end());
+   neighbours.clear();
+   for (size_t i = 0; i < found; i++)
+      neighbours.push_back(candidates[i].second);
 }
 
 inline const cityIDType VRPTWDataProblem::getZone(cityIDType id) const
 {
-   for (size_t i = 0; i < costumerZone.size(); i++)
-      for (size_t j = 0; j < costumerZone[i].size(); j++)   
-         if (costumerZone[i][j] == id)
-            return i;
-   std::cout << "Unexpected Error :: inline cityIdType VRPTWDataProblem::getZone(cityIdType id) :: file: VRPTWDataProblem.h" << std::endl;
-   exit(1);
+   assert(id < this->zoneOfCostumer.size());
+   return this->zoneOfCostumer[id];
 }
 
+inline unsigned VRPTWDataProblem::zoneOfTime(const long time) const
+{
+   // Bounds belong to the lower zone, as zones used to be searched in order
+   const long zone = (time <= 0) ? 0 : (time - 1) / this->zoneLength;
+   return (zone >= (long)this->costumerZone.size()) ? this->costumerZone.size() - 1 : zone;
+}
 
-inline void VRPTWDataProblem::createZones(unsigned numberOfRoutes)
+inline void VRPTWDataProblem::createZones(unsigned numberOfRoutes, const bool verbose)
 {
+   assert(numberOfRoutes > 0);
+
    // The depot does not count
    unsigned numberOfCostumers = clientCoords.size();
-   unsigned numberOfZones = numberOfCostumers / numberOfRoutes;
+   unsigned numberOfZones = std::max(numberOfCostumers / numberOfRoutes, 1u);
    unsigned tMax = timeWindow[0].second;
-   unsigned zoneLength = tMax / numberOfZones;
-
-   costumerZone.resize(numberOfZones);
-   
-   for (size_t i = 0; i < numberOfZones; i++)
-      for (size_t j = 0; j < numberOfCostumers; j++)
-         if (isInside((timeWindow[j].first + timeWindow[j].second)/2, (long)(i * zoneLength), (long)((i+1) * zoneLength)))
-            costumerZone[i].push_back(j); 
+   this->zoneLength = std::max(tMax / numberOfZones, 1u);
 
+   costumerZone.assign(numberOfZones, std::vector<cityIDType>());
+   zoneOfCostumer.resize(numberOfCostumers);
+   for (size_t j = 0; j < numberOfCostumers; j++)
+   {
+      zoneOfCostumer[j] = zoneOfTime(getTimeWindowMidpoint(j));
+      costumerZone[zoneOfCostumer[j]].push_back(j);
+   }
 
-   // Printing - Just for testing
+   if (!verbose)
+      return;
    std::cout << "Number of costumers: " << numberOfCostumers << std::endl;
    std::cout << "Number of Zones:     " << numberOfZones << std::endl;
    std::cout << "tMax:                " << tMax << std::endl;
@@ -397,10 +785,25 @@ inline void VRPTWDataProblem::createZones(unsigned numberOfRoutes)
    {
       std::cout << "Zone[" << i << "] (" << i * zoneLength << "," << (i+1) * zoneLength << ") => ";
       for (size_t j = 0; j < costumerZone[i].size(); j++)   
-         std::cout << costumerZone[i][j] << "(" << (timeWindow[costumerZone[i][j]].first + timeWindow[costumerZone[i][j]].second)/2 << "), ";
+         std::cout << costumerZone[i][j] << "(" << getTimeWindowMidpoint(costumerZone[i][j]) << "), ";
       std::cout << std::endl;
    }
-      
+}
+
+void VRPTWDataProblem::getTemporalNeighbours(const cityIDType id, const long tolerance, std::vector<cityIDType>& neighbours) const
+{
+   assert(!this->costumerZone.empty());
+
+   neighbours.clear();
+   const long midpoint = getTimeWindowMidpoint(id);
+   const unsigned last = zoneOfTime(midpoint + tolerance);
+   for (unsigned zone = zoneOfTime(midpoint - tolerance); zone <= last; zone++)
+      for (size_t j = 0; j < this->costumerZone[zone].size(); j++)
+      {
+         const cityIDType costumer = this->costumerZone[zone][j];
+         if (costumer != id && costumer != 0 && std::labs(getTimeWindowMidpoint(costumer) - midpoint) <= tolerance)
+            neighbours.push_back(costumer);
+      }
 }
 
 inline void VRPTWDataProblem::print() const
@@ -0,0 +1,768 @@
+/**
+   @class VRPTWLocalSearch
+
+   @brief Local search engine for the VRPTW.
+
+   This class improves a route-plan using the classical VRPTW neighbourhoods:
+   relocate, Or-opt (segments of 2 and 3 costumers), swap, CROSS-exchange
+   (segments of up to 3 costumers), intra-route 2-opt and inter-route 2-opt*.
+
+   Moves between routes are evaluated in constant time. Each route keeps the
+   data of its prefixes, its suffixes and its blocks of up to 3 visits
+   (distance, duration, time warp, earliest and latest start and load), so
+   it takes memory and time linear in its length to update. A new route is
+   described as a concatenation of a few of these sub-sequences, and the
+   data of the concatenation is obtained without visiting the costumers
+   again (Vidal et al., 2013). The longer sub-sequences in the middle of a
+   route, which only the moves within a route use (a segment is moved over
+   them or reversed), are built visit by visit when needed. The cost of a
+   route is its distance plus a penalty for the time warp (the time the
+   vehicle would have to 'travel back' to reach a costumer before its window
+   closes) and for the load over the capacity of the vehicles.
+
+   Only moves between a costumer and its nearest costumers are tried
+   (granular neighbourhoods). Don't-look bits skip the costumers whose
+   routes have not changed since they were last examined. Moves can be
+   applied as soon as they improve the route-plan (first improvement) or
+   after all the moves of a costumer have been tried (best improvement).
+
+   The number of routes of the route-plan is kept (a route can become
+   empty and empty routes can receive costumers).
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef VRPTWLOCALSEARCH_H
+#define VRPTWLOCALSEARCH_H
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "dataTypes.h"
+#include "VRPTWDataProblem.h"
+
+/**
+   Data of a sub-sequence of visits.
+*/
+struct routeSegment
+{
+   unsigned size;
+   cityIDType first, last;
+   double distance;
+   double duration;
+   double timeWarp;
+   double earliest;
+   double latest;
+   double load;
+};
+
+class VRPTWLocalSearch
+{
+   public:
+      /**
+         Strategies to apply the moves.
+      */
+      enum strategyType { firstImprovement, bestImprovement };
+
+   private:
+      /**
+         Sub-sequence of a route used to build a new route. Positions refer to
+         the route with the depot at both ends (position 0 and size + 1).
+      */
+      struct piece
+      {
+         unsigned route;
+         unsigned from, to;
+         bool reversed;
+      };
+
+      /**
+         A move is described by the routes it changes (one or two) and the
+         pieces the new routes are made of.
+      */
+      struct moveType
+      {
+         unsigned numberOfRoutes;
+         unsigned route[2];
+         unsigned numberOfPieces[2];
+         piece pieces[2][5];
+         double delta;
+      };
+
+      /**
+         A route: its visits (starting and ending at the depot), the data of
+         its prefixes (up to each position), suffixes (from each position)
+         and short blocks (the sub-sequences of up to 3 visits that start at
+         each position, which are the ones moved between routes) and its cost.
+      */
+      struct routeData
+      {
+         std::vector<cityIDType> visits;
+         std::vector<routeSegment> prefix;
+         std::vector<routeSegment> suffix;
+         std::vector<routeSegment> block;
+         double cost;
+      };
+
+      static const unsigned blockLength = 3;
+
+      std::vector<routeData> routes;
+
+      /**
+         Route and position of every costumer.
+      */
+      std::vector<unsigned> routeOf, positionOf;
+
+      /**
+         Don't-look bits.
+      */
+      std::vector<char> dontLook;
+
+      /**
+         Nearest costumers of every costumer.
+      */
+      std::vector<std::vector<cityIDType> > neighbours;
+
+      unsigned numberOfNeighbours;
+      strategyType strategy;
+      double timeWarpPenalty;
+      double loadPenalty;
+
+      /**
+         Counter of the moves applied (statistical purposes).
+      */
+      unsigned long numberOfMoves;
+
+      const VRPTWDataProblem* data;
+      double capacity;
+
+      /**
+         Providers of the distances of the instance (see VRPDistances.h). The
+         methods that join sub-sequences are templates on them, so the matrix
+         is read as directly as before when there is one.
+      */
+      bool onDemand;
+      VRPDenseDistances denseDistances;
+      VRPOnDemandDistances onDemandDistances;
+
+      /**
+         Method that creates the lists of nearest costumers.
+      */
+      void createNeighbours();
+
+      /**
+         Data of the visit to every costumer (and to the depot), so the
+         sub-sequences built on demand do not read the instance again.
+      */
+      std::vector<routeSegment> visits;
+
+      /**
+         Method that returns the data of a single visit.
+      */
+      const routeSegment& visit(const cityIDType c) const { return this->visits[c]; }
+
+      /**
+         Method that returns the data of the concatenation of two sub-sequences.
+      */
+      template <class D> routeSegment join(const D&, const routeSegment&, const routeSegment&) const;
+
+      /**
+         Method that returns the cost of a whole route.
+      */
+      double cost(const routeSegment&) const;
+
+      /**
+         Method that returns the data of a piece (it must not be empty). The
+         pieces in the middle of a route are built into the given segment.
+      */
+      template <class D> const routeSegment& segment(const D&, const piece&, routeSegment&) const;
+
+      /**
+         Method that computes the data of the prefixes and suffixes of a route.
+      */
+      void update(const unsigned);
+      template <class D> void update(const D&, const unsigned);
+
+      /**
+         Method that returns the cost of the i-th route of a move.
+      */
+      double evaluate(const moveType&, const unsigned) const;
+      template <class D> double evaluate(const D&, const moveType&, const unsigned) const;
+
+      /**
+         Method that evaluates a move and keeps it if it is better than the best one.
+         @return true if the search of the current costumer must stop (first improvement).
+      */
+      bool consider(moveType&, moveType&) const;
+
+      /**
+         Method that applies a move.
+      */
+      void apply(const moveType&);
+
+      /**
+         Methods that try the moves of each neighbourhood.
+      */
+      bool tryRelocate(const cityIDType, const cityIDType, moveType&) const;
+      bool tryRelocateToEmptyRoute(const cityIDType, moveType&) const;
+      bool tryExchange(const cityIDType, const cityIDType, moveType&) const;
+      bool tryTwoOpt(const cityIDType, const cityIDType, moveType&) const;
+      bool tryTwoOptStar(const cityIDType, const cityIDType, moveType&) const;
+
+      /**
+         Methods that make the pieces of a move easier to write.
+      */
+      static piece makePiece(const unsigned, const unsigned, const unsigned, const bool = false);
+      static void startMove(moveType&, const unsigned, const unsigned);
+      static void addPiece(moveType&, const unsigned, const piece&);
+
+      /**
+         Methods to translate route-plans.
+      */
+      void load(const chromosomeType&);
+      chromosomeType save() const;
+
+   protected:
+
+   public:
+      /**
+         Default constructor. It sets the default parameters.
+      */
+      VRPTWLocalSearch();
+
+      /**
+         Default destructor. It does nothing.
+      */
+      ~VRPTWLocalSearch() { };
+
+      void setStrategy(const strategyType strategy) { this->strategy = strategy; }
+      void setNumberOfNeighbours(const unsigned n) { this->numberOfNeighbours = n; this->neighbours.clear(); }
+      void setTimeWarpPenalty(const double penalty) { this->timeWarpPenalty = penalty; }
+      void setLoadPenalty(const double penalty) { this->loadPenalty = penalty; }
+      unsigned long getNumberOfMoves() const { return this->numberOfMoves; }
+
+      /**
+         Method that improves a route-plan until none of the moves improves it.
+         @param const chromosomeType& is the route-plan.
+         @return the improved route-plan.
+      */
+      chromosomeType run(const chromosomeType&);
+};
+
+VRPTWLocalSearch::VRPTWLocalSearch()
+{
+   this->numberOfNeighbours = 20;
+   this->strategy = firstImprovement;
+   this->timeWarpPenalty = 100;
+   this->loadPenalty = 100;
+   this->numberOfMoves = 0;
+   this->data = NULL;
+   this->capacity = 0;
+   this->onDemand = false;
+}
+
+// Segments
+
+template <class D>
+inline routeSegment VRPTWLocalSearch::join(const D& distances, const routeSegment& a, const routeSegment& b) const
+{
+   // As in the evaluation of the objectives, the travel time may differ from the distance
+   const double travel = distances.travelTime(a.last, b.first);
+   const double delta = a.duration - a.timeWarp + travel;
+   const double waitingTime = std::max(b.earliest - delta - a.latest, 0.0);
+   const double timeWarp = std::max(a.earliest + delta - b.latest, 0.0);
+
+   routeSegment s;
+   s.size = a.size + b.size;
+   s.first = a.first;
+   s.last = b.last;
+   s.distance = a.distance + distances.distance(a.last, b.first) + b.distance;
+   s.duration = a.duration + b.duration + travel + waitingTime;
+   s.timeWarp = a.timeWarp + b.timeWarp + timeWarp;
+   s.earliest = std::max(b.earliest - delta, a.earliest) - waitingTime;
+   s.latest = std::min(b.latest - delta, a.latest) + timeWarp;
+   s.load = a.load + b.load;
+   return s;
+}
+
+inline double VRPTWLocalSearch::cost(const routeSegment& s) const
+{
+   return s.distance + this->timeWarpPenalty * s.timeWarp + this->loadPenalty * std::max(s.load - this->capacity, 0.0);
+}
+
+template <class D>
+inline const routeSegment& VRPTWLocalSearch::segment(const D& distances, const piece& p, routeSegment& s) const
+{
+   const routeData& r = this->routes[p.route];
+   if (!p.reversed && p.from == 0)
+      return r.prefix[p.to];
+   if (!p.reversed && p.to + 1 == r.visits.size())
+      return r.suffix[p.from];
+   if (!p.reversed && p.to < p.from + blockLength)
+      return r.block[p.from * blockLength + p.to - p.from];
+
+   // Sub-sequences in the middle of the route are built visit by visit
+   if (p.reversed)
+   {
+      s = visit(r.visits[p.to]);
+      for (unsigned j = p.to; j-- > p.from; )
+         s = join(distances, s, visit(r.visits[j]));
+   }
+   else
+   {
+      s = visit(r.visits[p.from]);
+      for (unsigned j = p.from + 1; j <= p.to; j++)
+         s = join(distances, s, visit(r.visits[j]));
+   }
+   return s;
+}
+
+inline void VRPTWLocalSearch::update(const unsigned route)
+{
+   if (this->onDemand)
+      update(this->onDemandDistances, route);
+   else
+      update(this->denseDistances, route);
+}
+
+template <class D>
+inline void VRPTWLocalSearch::update(const D& distances, const unsigned route)
+{
+   routeData& r = this->routes[route];
+   const size_t n = r.visits.size();
+   r.prefix.resize(n);
+   r.suffix.resize(n);
+   r.block.resize(n * blockLength);
+
+   r.prefix[0] = visit(r.visits[0]);
+   for (size_t i = 1; i < n; i++)
+      r.prefix[i] = join(distances, r.prefix[i - 1], visit(r.visits[i]));
+   r.suffix[n - 1] = visit(r.visits[n - 1]);
+   for (size_t i = n - 1; i-- > 0; )
+      r.suffix[i] = join(distances, visit(r.visits[i]), r.suffix[i + 1]);
+   for (size_t i = 0; i < n; i++)
+   {
+      r.block[i * blockLength] = visit(r.visits[i]);
+      for (size_t k = 1; k < blockLength && i + k < n; k++)
+         r.block[i * blockLength + k] = join(distances, r.block[i * blockLength + k - 1], visit(r.visits[i + k]));
+   }
+
+   r.cost = cost(r.prefix[n - 1]);
+
+   for (size_t i = 1; i + 1 < n; i++)
+   {
+      this->routeOf[r.visits[i]] = route;
+      this->positionOf[r.visits[i]] = i;
+   }
+}
+
+// Moves
+
+inline VRPTWLocalSearch::piece VRPTWLocalSearch::makePiece(const unsigned route, const unsigned from, const unsigned to, const bool reversed)
+{
+   piece p;
+   p.route = route;
+   p.from = from;
+   p.to = to;
+   p.reversed = reversed;
+   return p;
+}
+
+inline void VRPTWLocalSearch::startMove(moveType& move, const unsigned firstRoute, const unsigned secondRoute)
+{
+   move.numberOfRoutes = (firstRoute == secondRoute) ? 1 : 2;
+   move.route[0] = firstRoute;
+   move.route[1] = secondRoute;
+   move.numberOfPieces[0] = 0;
+   move.numberOfPieces[1] = 0;
+}
+
+inline void VRPTWLocalSearch::addPiece(moveType& move, const unsigned i, const piece& p)
+{
+   // Empty pieces are not added
+   if (p.from > p.to)
+      return;
+   move.pieces[i][move.numberOfPieces[i]++] = p;
+}
+
+inline double VRPTWLocalSearch::evaluate(const moveType& move, const unsigned i) const
+{
+   return this->onDemand ? evaluate(this->onDemandDistances, move, i) : evaluate(this->denseDistances, move, i);
+}
+
+template <class D>
+inline double VRPTWLocalSearch::evaluate(const D& distances, const moveType& move, const unsigned i) const
+{
+   routeSegment middle;
+   routeSegment s = segment(distances, move.pieces[i][0], middle);
+   for (unsigned k = 1; k < move.numberOfPieces[i]; k++)
+      s = join(distances, s, segment(distances, move.pieces[i][k], middle));
+   return cost(s);
+}
+
+inline bool VRPTWLocalSearch::consider(moveType& move, moveType& best) const
+{
+   move.delta = evaluate(move, 0) - this->routes[move.route[0]].cost;
+   if (move.numberOfRoutes == 2)
+      move.delta += evaluate(move, 1) - this->routes[move.route[1]].cost;
+
+   if (move.delta < best.delta - 1e-7)
+   {
+      best = move;
+      return (this->strategy == firstImprovement);
+   }
+   return false;
+}
+
+inline void VRPTWLocalSearch::apply(const moveType& move)
+{
+   std::vector<cityIDType> visits[2];
+   for (unsigned i = 0; i < move.numberOfRoutes; i++)
+      for (unsigned k = 0; k < move.numberOfPieces[i]; k++)
+      {
+         const piece& p = move.pieces[i][k];
+         const std::vector<cityIDType>& source = this->routes[p.route].visits;
+         if (p.reversed)
+            for (unsigned j = p.to + 1; j-- > p.from; )
+               visits[i].push_back(source[j]);
+         else
+            for (unsigned j = p.from; j <= p.to; j++)
+               visits[i].push_back(source[j]);
+      }
+
+   for (unsigned i = 0; i < move.numberOfRoutes; i++)
+   {
+      this->routes[move.route[i]].visits.swap(visits[i]);
+      update(move.route[i]);
+
+      // The costumers of the changed routes must be examined again
+      const std::vector<cityIDType>& changed = this->routes[move.route[i]].visits;
+      for (size_t j = 1; j + 1 < changed.size(); j++)
+         this->dontLook[changed[j]] = 0;
+   }
+   this->numberOfMoves++;
+}
+
+/**
+   Relocate and Or-opt: the segment of 1 to 3 costumers that starts at 'u'
+   is moved after 'v' or before 'v'.
+*/
+inline bool VRPTWLocalSearch::tryRelocate(const cityIDType u, const cityIDType v, moveType& best) const
+{
+   const unsigned ru = this->routeOf[u], pu = this->positionOf[u];
+   const unsigned rv = this->routeOf[v], pv = this->positionOf[v];
+   const unsigned endU = this->routes[ru].visits.size() - 1;
+   const unsigned endV = this->routes[rv].visits.size() - 1;
+   moveType move;
+
+   for (unsigned length = 1; length <= 3 && pu + length - 1 < endU; length++)
+   {
+      const unsigned lastU = pu + length - 1;
+      const piece moved = makePiece(ru, pu, lastU);
+
+      // After 'v' (at = pv) and before 'v' (at = pv - 1)
+      for (unsigned at = pv - 1; at <= pv; at++)
+      {
+         if (ru != rv)
+         {
+            startMove(move, ru, rv);
+            addPiece(move, 0, makePiece(ru, 0, pu - 1));
+            addPiece(move, 0, makePiece(ru, lastU + 1, endU));
+            addPiece(move, 1, makePiece(rv, 0, at));
+            addPiece(move, 1, moved);
+            addPiece(move, 1, makePiece(rv, at + 1, endV));
+         }
+         else
+         {
+            // The segment is inserted between positions 'at' and 'at + 1'
+            if (at + 1 >= pu && at <= lastU)
+               continue;
+            startMove(move, ru, ru);
+            if (at < pu)
+            {
+               addPiece(move, 0, makePiece(ru, 0, at));
+               addPiece(move, 0, moved);
+               addPiece(move, 0, makePiece(ru, at + 1, pu - 1));
+               addPiece(move, 0, makePiece(ru, lastU + 1, endU));
+            }
+            else
+            {
+               addPiece(move, 0, makePiece(ru, 0, pu - 1));
+               addPiece(move, 0, makePiece(ru, lastU + 1, at));
+               addPiece(move, 0, moved);
+               addPiece(move, 0, makePiece(ru, at + 1, endU));
+            }
+         }
+         if (consider(move, best))
+            return true;
+      }
+   }
+   return false;
+}
+
+/**
+   Relocate and Or-opt into an empty route (all the empty routes are equivalent,
+   so only the first one is tried).
+*/
+inline bool VRPTWLocalSearch::tryRelocateToEmptyRoute(const cityIDType u, moveType& best) const
+{
+   const unsigned ru = this->routeOf[u], pu = this->positionOf[u];
+   const unsigned endU = this->routes[ru].visits.size() - 1;
+
+   unsigned empty = 0;
+   while (empty < this->routes.size() && this->routes[empty].visits.size() > 2)
+      empty++;
+   if (empty == this->routes.size())
+      return false;
+
+   moveType move;
+   for (unsigned length = 1; length <= 3 && pu + length - 1 < endU; length++)
+   {
+      const unsigned lastU = pu + length - 1;
+      startMove(move, ru, empty);
+      addPiece(move, 0, makePiece(ru, 0, pu - 1));
+      addPiece(move, 0, makePiece(ru, lastU + 1, endU));
+      addPiece(move, 1, makePiece(empty, 0, 0));
+      addPiece(move, 1, makePiece(ru, pu, lastU));
+      addPiece(move, 1, makePiece(empty, 1, 1));
+      if (consider(move, best))
+         return true;
+   }
+   return false;
+}
+
+/**
+   Swap and CROSS-exchange: the segments of 1 to 3 costumers that start at 'u'
+   and 'v' are exchanged.
+*/
+inline bool VRPTWLocalSearch::tryExchange(const cityIDType u, const cityIDType v, moveType& best) const
+{
+   unsigned ru = this->routeOf[u], pu = this->positionOf[u];
+   unsigned rv = this->routeOf[v], pv = this->positionOf[v];
+
+   // In the same route, the first segment is the one that comes first
+   if (ru == rv && pv < pu)
+   {
+      std::swap(pu, pv);
+   }
+   const unsigned endU = this->routes[ru].visits.size() - 1;
+   const unsigned endV = this->routes[rv].visits.size() - 1;
+   moveType move;
+
+   for (unsigned lengthU = 1; lengthU <= 3 && pu + lengthU - 1 < endU; lengthU++)
+      for (unsigned lengthV = 1; lengthV <= 3 && pv + lengthV - 1 < endV; lengthV++)
+      {
+         const unsigned lastU = pu + lengthU - 1;
+         const unsigned lastV = pv + lengthV - 1;
+         if (ru != rv)
+         {
+            startMove(move, ru, rv);
+            addPiece(move, 0, makePiece(ru, 0, pu - 1));
+            addPiece(move, 0, makePiece(rv, pv, lastV));
+            addPiece(move, 0, makePiece(ru, lastU + 1, endU));
+            addPiece(move, 1, makePiece(rv, 0, pv - 1));
+            addPiece(move, 1, makePiece(ru, pu, lastU));
+            addPiece(move, 1, makePiece(rv, lastV + 1, endV));
+         }
+         else
+         {
+            // Only the swap of single costumers within a route (the segments must not overlap)
+            if (lengthU > 1 || lengthV > 1 || lastU >= pv)
+               continue;
+            startMove(move, ru, ru);
+            addPiece(move, 0, makePiece(ru, 0, pu - 1));
+            addPiece(move, 0, makePiece(ru, pv, lastV));
+            addPiece(move, 0, makePiece(ru, lastU + 1, pv - 1));
+            addPiece(move, 0, makePiece(ru, pu, lastU));
+            addPiece(move, 0, makePiece(ru, lastV + 1, endV));
+         }
+         if (consider(move, best))
+            return true;
+      }
+   return false;
+}
+
+/**
+   Intra-route 2-opt: the part of the route between 'u' and 'v' is reversed
+   so that 'u' and 'v' become consecutive.
+*/
+inline bool VRPTWLocalSearch::tryTwoOpt(const cityIDType u, const cityIDType v, moveType& best) const
+{
+   const unsigned route = this->routeOf[u];
+   if (route != this->routeOf[v])
+      return false;
+
+   const unsigned pu = this->positionOf[u], pv = this->positionOf[v];
+   const unsigned end = this->routes[route].visits.size() - 1;
+   moveType move;
+   startMove(move, route, route);
+
+   if (pu < pv)
+   {
+      // ... u [u + 1 ... v] ... -> ... u v ... u + 1 ...
+      if (pv == pu + 1)
+         return false;
+      addPiece(move, 0, makePiece(route, 0, pu));
+      addPiece(move, 0, makePiece(route, pu + 1, pv, true));
+      addPiece(move, 0, makePiece(route, pv + 1, end));
+   }
+   else
+   {
+      // ... [v ... u - 1] u ... -> ... u - 1 ... v u ...
+      if (pu == pv + 1)
+         return false;
+      addPiece(move, 0, makePiece(route, 0, pv - 1));
+      addPiece(move, 0, makePiece(route, pv, pu - 1, true));
+      addPiece(move, 0, makePiece(route, pu, end));
+   }
+   return consider(move, best);
+}
+
+/**
+   Inter-route 2-opt*: the tails of the routes of 'u' and 'v' are exchanged,
+   either after both costumers or so that 'v' follows 'u'.
+*/
+inline bool VRPTWLocalSearch::tryTwoOptStar(const cityIDType u, const cityIDType v, moveType& best) const
+{
+   const unsigned ru = this->routeOf[u], pu = this->positionOf[u];
+   const unsigned rv = this->routeOf[v], pv = this->positionOf[v];
+   if (ru == rv)
+      return false;
+
+   const unsigned endU = this->routes[ru].visits.size() - 1;
+   const unsigned endV = this->routes[rv].visits.size() - 1;
+   moveType move;
+
+   // 'u' is followed by the successor of 'v'
+   startMove(move, ru, rv);
+   addPiece(move, 0, makePiece(ru, 0, pu));
+   addPiece(move, 0, makePiece(rv, pv + 1, endV));
+   addPiece(move, 1, makePiece(rv, 0, pv));
+   addPiece(move, 1, makePiece(ru, pu + 1, endU));
+   if (consider(move, best))
+      return true;
+
+   // 'u' is followed by 'v'
+   startMove(move, ru, rv);
+   addPiece(move, 0, makePiece(ru, 0, pu));
+   addPiece(move, 0, makePiece(rv, pv, endV));
+   addPiece(move, 1, makePiece(rv, 0, pv - 1));
+   addPiece(move, 1, makePiece(ru, pu + 1, endU));
+   return consider(move, best);
+}
+
+// Route-plans
+
+inline void VRPTWLocalSearch::createNeighbours()
+{
+   const size_t n = this->data->getClientCoords().size();
+   this->neighbours.assign(n, std::vector<cityIDType>());
+
+   for (cityIDType i = 1; i < n; i++)
+      this->data->nearest(i, this->numberOfNeighbours, this->neighbours[i]);
+}
+
+inline void VRPTWLocalSearch::load(const chromosomeType& chromosome)
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   this->data = VRPTWData;
+   this->capacity = VRPTWData->getFleet()[0].second;
+   this->onDemand = VRPTWData->isOnDemand();
+   if (this->onDemand)
+      this->onDemandDistances = VRPTWData->getOnDemandDistances();
+   else
+      this->denseDistances = VRPTWData->getDenseDistances();
+
+   const size_t n = VRPTWData->getClientCoords().size();
+   if (this->neighbours.size() != n)
+      createNeighbours();
+
+   this->visits.resize(n);
+   for (cityIDType c = 0; c < n; c++)
+   {
+      routeSegment& s = this->visits[c];
+      s.size = (c == 0) ? 0 : 1;
+      s.first = s.last = c;
+      s.distance = 0;
+      s.duration = VRPTWData->getServiceTime()[c];
+      s.timeWarp = 0;
+      s.earliest = VRPTWData->getTimeWindow()[c].first;
+      s.latest = VRPTWData->getTimeWindow()[c].second;
+      s.load = VRPTWData->getDemand()[c];
+   }
+   this->routeOf.assign(n, 0);
+   this->positionOf.assign(n, 0);
+   this->dontLook.assign(n, 0);
+
+   // Every 0 closes a route (the first one opens the first route)
+   this->routes.clear();
+   routeData current;
+   current.visits.push_back(0);
+   for (size_t i = (chromosome.empty() || chromosome[0] != 0) ? 0 : 1; i < chromosome.size(); i++)
+   {
+      current.visits.push_back(chromosome[i]);
+      if (chromosome[i] == 0)
+      {
+         this->routes.push_back(current);
+         current.visits.assign(1, 0);
+      }
+   }
+   if (current.visits.size() > 1)
+   {
+      current.visits.push_back(0);
+      this->routes.push_back(current);
+   }
+
+   for (unsigned r = 0; r < this->routes.size(); r++)
+      update(r);
+}
+
+inline chromosomeType VRPTWLocalSearch::save() const
+{
+   chromosomeType chromosome(1, 0);
+   for (size_t r = 0; r < this->routes.size(); r++)
+      chromosome.insert(chromosome.end(), this->routes[r].visits.begin() + 1, this->routes[r].visits.end());
+   return chromosome;
+}
+
+inline chromosomeType VRPTWLocalSearch::run(const chromosomeType& chromosome)
+{
+   load(chromosome);
+
+   bool improvement = true;
+   while (improvement)
+   {
+      improvement = false;
+      for (cityIDType u = 1; u < this->routeOf.size(); u++)
+      {
+         if (this->dontLook[u])
+            continue;
+
+         moveType best;
+         best.delta = 0;
+         bool stop = false;
+         for (size_t k = 0; k < this->neighbours[u].size() && !stop; k++)
+         {
+            const cityIDType v = this->neighbours[u][k];
+            stop = tryRelocate(u, v, best) || tryExchange(u, v, best) ||
+                   tryTwoOpt(u, v, best) || tryTwoOptStar(u, v, best);
+         }
+         if (!stop)
+            tryRelocateToEmptyRoute(u, best);
+
+         if (best.delta < 0)
+         {
+            apply(best);
+            improvement = true;
+         }
+         else
+            this->dontLook[u] = 1;
+      }
+   }
+
+   return save();
+}
+
+#endif
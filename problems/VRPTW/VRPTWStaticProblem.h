@@ -0,0 +1,42 @@
+/**
+   @library VRPTWStaticProblem
+
+   @brief Compile-time definition of the multi-objective VRPTW.
+
+   This library declares the list of objectives used by CODEA2 so that
+   the problem can be built as a staticMultiObjectiveProblem. The order
+   of the list is the order of the objectives in the solutions, and the
+   priorities and flags are the same as the ones set up in CODEA2.cpp.
+
+   @author Group of Intelligent Computing - Universidad de La Laguna - 2008
+*/
+
+#ifndef VRPTWSTATICPROBLEM_H
+#define VRPTWSTATICPROBLEM_H
+
+#include "../../core/staticMultiObjectiveProblem.h"
+
+#include "objectives/numberOfVehiclesProblem.h"
+#include "objectives/distanceProblem.h"
+#include "objectives/elapsedTimeProblem.h"
+#include "objectives/timeWindowViolationProblem.h"
+#include "objectives/timeWindownViolationProblem.h"
+#include "objectives/vehicleCapacityViolationProblem.h"
+#include "objectives/vehicleCapacitynViolationsProblem.h"
+#include "objectives/waitingTimeProblem.h"
+
+//                      Problem                             Priority  Comparable  Global
+typedef objectiveList<staticObjective<numberOfVehiclesProblem,           3, true,  true >,
+        objectiveList<staticObjective<elapsedTimeProblem,                4, false, false>,
+        objectiveList<staticObjective<waitingTimeProblem,                2, false, false>,
+        objectiveList<staticObjective<distanceProblem,                   1, true,  true >,
+        objectiveList<staticObjective<timeWindowViolationProblem,        5, false, false>,
+        objectiveList<staticObjective<timeWindownViolationProblem,       0, true,  true >,
+        objectiveList<staticObjective<vehicleCapacityViolationProblem,   6, true,  false>,
+        objectiveList<staticObjective<vehicleCapacitynViolationsProblem, 7, false, false>,
+        objectiveListEnd> > > > > > > > VRPTWObjectiveList;
+
+typedef staticMultiObjectiveProblem<VRPTWObjectiveList> VRPTWStaticProblem;
+typedef staticMultiObjectiveProblemAdapter<VRPTWObjectiveList> VRPTWStaticProblemAdapter;
+
+#endif
@@ -9,6 +9,8 @@
    @author Group of Intelligent Computing - Universidad de La Laguna - 2008
 */
 
+#include <stdint.h>
+
 #include <vector>
 #include <list>
 
@@ -27,6 +29,10 @@ typedef unsigned cityIDType;
    Type for distances.
 */
 typedef double distanceType;
+/**
+   Type for distances and times scaled to integers (see VRPTWDataProblem::setCostScale).
+*/
+typedef int64_t scaledCostType;
 /**
    Type for time.
 */
@@ -73,9 +79,10 @@ typedef std::vector<pointType> coordsType;
 */
 typedef std::vector<std::vector<distanceType> >  distanceMatrixType;
 /**
-   Type for the matrix of travel times.
+   Type for the matrix of travel times, stored by rows in a single vector (see
+   VRPTWDataProblem::getTravelTime).
 */
-typedef std::vector<std::vector<timeType> > timeMatrixType;
+typedef std::vector<distanceType> timeMatrixType;
 /**
    Type for the service time.
 */
@@ -95,5 +102,5 @@ typedef std::vector<singleDemandType> demandType;
 /**
    Type for creating the zone/groups relationship
 */
-typedef std::vector<vector<cityIDType> > costumerZoneType;
+typedef std::vector<std::vector<cityIDType> > costumerZoneType;
 
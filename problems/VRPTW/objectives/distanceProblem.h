@@ -22,7 +22,17 @@ class distanceProblem : public singleObjectiveProblem
    private:
 
    protected:
+      /**
+         Method that sums up the distances between the costumers of a route-plan
+         from a position to another one.
+         @param const D& provides the distances (see VRPDistances.h).
+         @param const routesType& is the route-plan.
+         @param const size_t is the first position.
+         @param const size_t is the last position.
+      */
+      template <class D> T sumDistances(const D&, const routesType&, const size_t, const size_t) const;
 
+      T sumDistances(const routesType&, const size_t, const size_t) const;
 
    public:
       /**
@@ -81,37 +91,48 @@ distanceProblem::~distanceProblem()
 inline T distanceProblem::evaluate(multiObjectiveSolution* currentSolution) const
 {
    assert(currentSolution != NULL);
- 
-   VRPSolution* VRPSol = static_cast<VRPSolution*>(currentSolution);
-   routesType routes = const_cast<const routesType&>(VRPSol->getRoutes());
-
-   T totalDistance = 0;
-   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
-   for (size_t i = 0; i < routes.size() - 1; i++)
-      totalDistance += VRPTWData->getDistanceMatrix()[routes[i]][routes[i + 1]];
 
-   return totalDistance;
+   VRPSolution* VRPSol = static_cast<VRPSolution*>(currentSolution);
+   return evaluate(VRPSol->getRoutes());
 }
 
-inline T distanceProblem::evaluate(const routesType& routes) const
-{
-   T totalDistance = 0;
+template <class D>
+inline T distanceProblem::sumDistances(const D& distances, const routesType& routes, const size_t first, const size_t last) const
+{
    VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
-   for (size_t i = 0; i < routes.size() - 1; i++)
-      totalDistance += VRPTWData->getDistanceMatrix()[routes[i]][routes[i + 1]];
+   if (VRPTWData->getCostScale() > 0)
+   {
+      // Integer cost mode: the sum is exact
+      scaledCostType totalScaledDistance = 0;
+      for (size_t i = first; i < last; i++)
+         totalScaledDistance += distances.scaledDistance(routes[i], routes[i + 1]);
+      return (T)VRPTWData->unscale(totalScaledDistance);
+   }
+
+   T totalDistance = 0;
+   for (size_t i = first; i < last; i++)
+      totalDistance += distances.distance(routes[i], routes[i + 1]);
 
    return totalDistance;
-}
+}
+
+inline T distanceProblem::sumDistances(const routesType& routes, const size_t first, const size_t last) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return sumDistances(VRPTWData->getOnDemandDistances(), routes, first, last);
+   return sumDistances(VRPTWData->getDenseDistances(), routes, first, last);
+}
+
+inline T distanceProblem::evaluate(const routesType& routes) const
+{
+   return sumDistances(routes, 0, routes.size() - 1);
+}
 
 inline T distanceProblem::evaluate(const routesType& routes, const unsigned start, const unsigned length) const
 {
-   assert(start + length < routes.size());
-   T totalDistance = 0;
-   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
-   for (size_t i = start; i < start + length; i++)
-      totalDistance += VRPTWData->getDistanceMatrix()[routes[i]][routes[i + 1]];
-
-   return totalDistance;  
+   assert(start + length < routes.size());
+   return sumDistances(routes, start, start + length);
 }
 
 T distanceProblem::evaluate(const boost::any& anyRoute) const
@@ -27,12 +27,28 @@ class elapsedTimeProblem : public singleObjectiveProblem
          Method that given two costumers computes the time
          to serve them. It computes the time it takes to 
          move from one to another and the service time.
+         @param const D& provides the travel times (see VRPDistances.h).
          @param T& is the elapsed time so far is going to
          be incremented.
          @param const unsgined is the id of the first costumer.
          @param const unsigned is the id of the second costumer. 
       */
-      void elapsedTimeBetweenTwoCostumers(T&, const unsigned, const unsigned) const;
+      template <class D> void elapsedTimeBetweenTwoCostumers(const D&, T&, const unsigned, const unsigned) const;
+
+      /**
+         Same as above in the integer cost mode (see VRPTWDataProblem::setCostScale).
+      */
+      template <class D> void elapsedTimeBetweenTwoCostumers(const D&, scaledCostType&, const unsigned, const unsigned) const;
+
+      /**
+         Method that evaluates a route-plan with the given distances (see VRPDistances.h).
+      */
+      template <class D> T evaluateRoutes(const D&, const routesType&) const;
+
+      /**
+         Same as above with a costumer inserted (see evaluate).
+      */
+      template <class D> T evaluateInsertion(const D&, const routesType&, const unsigned, const unsigned) const;
 
    public:
       /**
@@ -89,12 +105,13 @@ elapsedTimeProblem::elapsedTimeProblem()
 elapsedTimeProblem::~elapsedTimeProblem()
 { }
 
-inline void elapsedTimeProblem::elapsedTimeBetweenTwoCostumers(T& totalElapsedTime, const unsigned i, const unsigned j) const
+template <class D>
+inline void elapsedTimeProblem::elapsedTimeBetweenTwoCostumers(const D& distances, T& totalElapsedTime, const unsigned i, const unsigned j) const
 {
    VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
 
    // Time it takes to go from <costumer i> to <costumer i+1>
-   totalElapsedTime += VRPTWData->getDistanceMatrix()[i][j];
+   totalElapsedTime += distances.travelTime(i, j);
 
    // Time we have to wait if we arrive before the <costumer i> opens
    //    First, we calculate whether we're going to wait or not.
@@ -107,37 +124,55 @@ inline void elapsedTimeProblem::elapsedTimeBetweenTwoCostumers(T& totalElapsedTi
    // cout << "from: " <<  i << " to: " << j << " it takes: " << totalElapsedTime << endl;
 }
 
+template <class D>
+inline void elapsedTimeProblem::elapsedTimeBetweenTwoCostumers(const D& distances, scaledCostType& totalElapsedTime, const unsigned i, const unsigned j) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+
+   totalElapsedTime += distances.scaledTravelTime(i, j);
+   if (VRPTWData->getScaledReadyTime(j) > totalElapsedTime)
+      totalElapsedTime = VRPTWData->getScaledReadyTime(j);
+   totalElapsedTime += VRPTWData->getScaledServiceTime(j);
+}
 
 inline T elapsedTimeProblem::evaluate(multiObjectiveSolution* currentSolution) const
 {
-   // std::cout << "ElapsedTimeProblem" << std::endl;
-
    assert(currentSolution != NULL);
 
    VRPSolution* VRPSol = static_cast<VRPSolution*>(currentSolution);
-   T totalElapsedTime = 0;
-   T routeElapsedTime = 0;
-
-   routesType routes = const_cast<const routesType&>(VRPSol->getRoutes());
-   // std::cout << "   Current Route: " << routes << std::endl;   
+   return evaluate(VRPSol->getRoutes());
+}
+
+inline T elapsedTimeProblem::evaluate(const routesType& routes) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return evaluateRoutes(VRPTWData->getOnDemandDistances(), routes);
+   return evaluateRoutes(VRPTWData->getDenseDistances(), routes);
+}
 
-   for (size_t i = 0; i < routes.size() - 1; i++)
+template <class D>
+inline T elapsedTimeProblem::evaluateRoutes(const D& distances, const routesType& routes) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->getCostScale() > 0)
    {
-      if (routes[i] == 0)
+      // Integer cost mode: the routes are summed up exactly
+      scaledCostType totalElapsedTime = 0;
+      scaledCostType routeElapsedTime = 0;
+      for (size_t i = 0; i < routes.size() - 1; i++)
       {
-         totalElapsedTime += routeElapsedTime;
-         routeElapsedTime = 0;
+         if (routes[i] == 0)
+         {
+            totalElapsedTime += routeElapsedTime;
+            routeElapsedTime = 0;
+         }
+         elapsedTimeBetweenTwoCostumers(distances, routeElapsedTime, routes[i], routes[i + 1]);
       }
-      elapsedTimeBetweenTwoCostumers(routeElapsedTime, routes[i], routes[i + 1]);
+      totalElapsedTime += routeElapsedTime;
+      return (T)VRPTWData->unscale(totalElapsedTime);
    }
-   totalElapsedTime += routeElapsedTime;
-   // std::cout << "   Elapsed time: " << totalElapsedTime << std::endl;
-   // std::cout << "<--- ElapsedTimeProblem" << std::endl;
-   return totalElapsedTime;
-}
-
-inline T elapsedTimeProblem::evaluate(const routesType& routes) const 
-{
+
    T totalElapsedTime = 0;
    T routeElapsedTime = 0;
    for (size_t i = 0; i < routes.size() - 1; i++)
@@ -147,13 +182,29 @@ inline T elapsedTimeProblem::evaluate(const routesType& routes) const
          totalElapsedTime += routeElapsedTime;
          routeElapsedTime = 0;
       }
-      elapsedTimeBetweenTwoCostumers(routeElapsedTime, routes[i], routes[i + 1]);
+      elapsedTimeBetweenTwoCostumers(distances, routeElapsedTime, routes[i], routes[i + 1]);
    }
    totalElapsedTime += routeElapsedTime;
    return totalElapsedTime;
 }
 
 inline T elapsedTimeProblem::evaluate(const routesType& routes, const unsigned position, const unsigned costumer) const
+{
+   if (VRPTWDataProblem::instance()->getCostScale() > 0)
+   {
+      routesType inserted(routes);
+      inserted.insert(inserted.begin() + position, costumer);
+      return evaluate(inserted);
+   }
+
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return evaluateInsertion(VRPTWData->getOnDemandDistances(), routes, position, costumer);
+   return evaluateInsertion(VRPTWData->getDenseDistances(), routes, position, costumer);
+}
+
+template <class D>
+inline T elapsedTimeProblem::evaluateInsertion(const D& distances, const routesType& routes, const unsigned position, const unsigned costumer) const
 {
    T totalElapsedTime = 0;
    T routeElapsedTime = 0;
@@ -165,20 +216,20 @@ inline T elapsedTimeProblem::evaluate(const routesType& routes, const unsigned p
          totalElapsedTime += routeElapsedTime;
          routeElapsedTime = 0;
       }
-      elapsedTimeBetweenTwoCostumers(routeElapsedTime, routes[i], routes[i + 1]);
+      elapsedTimeBetweenTwoCostumers(distances, routeElapsedTime, routes[i], routes[i + 1]);
    }
    totalElapsedTime += routeElapsedTime;
    routeElapsedTime = 0;
    // Now we have to add time<position - 1, costumer> and time<costumer, position + 1>
    if (routes[position - 1] == 0)
    {
-      elapsedTimeBetweenTwoCostumers(routeElapsedTime, routes[position - 1], costumer);
+      elapsedTimeBetweenTwoCostumers(distances, routeElapsedTime, routes[position - 1], costumer);
       totalElapsedTime += routeElapsedTime;
       routeElapsedTime = 0;
    }
    else 
-      elapsedTimeBetweenTwoCostumers(totalElapsedTime, routes[position - 1], costumer);
-   elapsedTimeBetweenTwoCostumers(totalElapsedTime, costumer, routes[position]);
+      elapsedTimeBetweenTwoCostumers(distances, totalElapsedTime, routes[position - 1], costumer);
+   elapsedTimeBetweenTwoCostumers(distances, totalElapsedTime, costumer, routes[position]);
 
    // After the elemtent
    for (size_t i = position; i < routes.size() - 1; i++)
@@ -188,7 +239,7 @@ inline T elapsedTimeProblem::evaluate(const routesType& routes, const unsigned p
          totalElapsedTime += routeElapsedTime;
          routeElapsedTime = 0;
       }
-      elapsedTimeBetweenTwoCostumers(routeElapsedTime, routes[i], routes[i + 1]);
+      elapsedTimeBetweenTwoCostumers(distances, routeElapsedTime, routes[i], routes[i + 1]);
    }
    totalElapsedTime += routeElapsedTime;
    return totalElapsedTime;
@@ -24,13 +24,24 @@ class timeWindowViolationProblem : public singleObjectiveProblem
          Method that given two costumers computes the time
          to serve them. It computes the time it takes to 
          move from one to another and the service time.
+         @param const D& provides the travel times (see VRPDistances.h).
          @param T& is the elapsed time so far is going to
          be incremented.
          @param T& is the elapsed time violation so far.
          @param const unsgined is the id of the first costumer.
          @param const unsigned is the id of the second costumer. 
       */
-      void elapsedTimeBetweenTwoCostumers(T&, T&, const unsigned, const unsigned) const;
+      template <class D> void elapsedTimeBetweenTwoCostumers(const D&, T&, T&, const unsigned, const unsigned) const;
+
+      /**
+         Same as above in the integer cost mode (see VRPTWDataProblem::setCostScale).
+      */
+      template <class D> void elapsedTimeBetweenTwoCostumers(const D&, scaledCostType&, scaledCostType&, const unsigned, const unsigned) const;
+
+      /**
+         Method that evaluates a route-plan with the given distances (see VRPDistances.h).
+      */
+      template <class D> T evaluateRoutes(const D&, const routesType&) const;
 
 
    public:
@@ -72,12 +83,13 @@ timeWindowViolationProblem::timeWindowViolationProblem()
 timeWindowViolationProblem::~timeWindowViolationProblem()
 { }
 
-inline void timeWindowViolationProblem::elapsedTimeBetweenTwoCostumers(T& totalElapsedTime, T& violation, const unsigned i, const unsigned j) const
+template <class D>
+inline void timeWindowViolationProblem::elapsedTimeBetweenTwoCostumers(const D& distances, T& totalElapsedTime, T& violation, const unsigned i, const unsigned j) const
 {
    VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
 
    // Time it takes to go from <costumer i> to <costumer i+1>
-   totalElapsedTime += VRPTWData->getDistanceMatrix()[i][j];
+   totalElapsedTime += distances.travelTime(i, j);
    //cout << "TW:(" << i << "," << j << ") [" << VRPTWData->getTimeWindow()[j].first << "," << VRPTWData->getTimeWindow()[j].second << "]";
 
    // Time we have to wait if we arrive before the <costumer i> opens
@@ -96,41 +108,54 @@ inline void timeWindowViolationProblem::elapsedTimeBetweenTwoCostumers(T& totalE
    //cout << "from: " <<  i << " to: " << j << " it takes: " << totalElapsedTime << endl;
 }
 
+template <class D>
+inline void timeWindowViolationProblem::elapsedTimeBetweenTwoCostumers(const D& distances, scaledCostType& totalElapsedTime, scaledCostType& violation, const unsigned i, const unsigned j) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+
+   totalElapsedTime += distances.scaledTravelTime(i, j);
+   if (VRPTWData->getScaledReadyTime(j) > totalElapsedTime)
+      totalElapsedTime = VRPTWData->getScaledReadyTime(j);
+   else if (VRPTWData->getScaledDueTime(j) < totalElapsedTime)
+      violation += totalElapsedTime - VRPTWData->getScaledDueTime(j);
+   totalElapsedTime += VRPTWData->getScaledServiceTime(j);
+}
 
 inline T timeWindowViolationProblem::evaluate(multiObjectiveSolution* currentSolution) const
 {
-   // std::cout << "tineWindowsViolationProblem" << std::endl;
-
    assert(currentSolution != NULL);
 
    VRPSolution* VRPSol = static_cast<VRPSolution*>(currentSolution);
-   T totalElapsedTime = 0;
-   T routeElapsedTime = 0;
-   T violation = 0;
-
-   routesType routes = const_cast<const routesType&>(VRPSol->getRoutes());
-   // std::cout << "   Current Route: " << routes << std::endl;   
-
-   for (size_t i = 0; i < routes.size() - 1; i++)
-   {
-      if (routes[i] == 0)
-      {
-         totalElapsedTime += routeElapsedTime;
-         routeElapsedTime = 0;
-      }
-      elapsedTimeBetweenTwoCostumers(routeElapsedTime, violation, routes[i], routes[i + 1]);
-   }
-   totalElapsedTime += routeElapsedTime;
-
-   // std::cout << "   timeWindowViolationProblem: " << numberOfViolations << std::endl;
-   // std::cout << "<--- tinemWindowViolationProblem" << std::endl;
-   return (T)violation;
+   return evaluate(VRPSol->getRoutes());
 }
 
 inline T timeWindowViolationProblem::evaluate(const routesType& routes) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return evaluateRoutes(VRPTWData->getOnDemandDistances(), routes);
+   return evaluateRoutes(VRPTWData->getDenseDistances(), routes);
+}
+
+template <class D>
+inline T timeWindowViolationProblem::evaluateRoutes(const D& distances, const routesType& routes) const
 {
    // std::cout << "tineWindowsViolationProblem" << std::endl;
 
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->getCostScale() > 0)
+   {
+      scaledCostType routeElapsedTime = 0;
+      scaledCostType violation = 0;
+      for (size_t i = 0; i < routes.size() - 1; i++)
+      {
+         if (routes[i] == 0)
+            routeElapsedTime = 0;
+         elapsedTimeBetweenTwoCostumers(distances, routeElapsedTime, violation, routes[i], routes[i + 1]);
+      }
+      return (T)VRPTWData->unscale(violation);
+   }
+
    T totalElapsedTime = 0;
    T routeElapsedTime = 0;
    T violation = 0;
@@ -143,7 +168,7 @@ inline T timeWindowViolationProblem::evaluate(const routesType& routes) const
          totalElapsedTime += routeElapsedTime;
          routeElapsedTime = 0;
       }
-      elapsedTimeBetweenTwoCostumers(routeElapsedTime, violation, routes[i], routes[i + 1]);
+      elapsedTimeBetweenTwoCostumers(distances, routeElapsedTime, violation, routes[i], routes[i + 1]);
    }
    totalElapsedTime += routeElapsedTime;
 
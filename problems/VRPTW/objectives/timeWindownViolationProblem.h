@@ -20,7 +20,17 @@ class timeWindownViolationProblem : public singleObjectiveProblem
    private:
 
    protected:
-      void elapsedTimeBetweenTwoCostumers(T&, unsigned&, const unsigned, const unsigned) const;
+      template <class D> void elapsedTimeBetweenTwoCostumers(const D&, T&, unsigned&, const unsigned, const unsigned) const;
+
+      /**
+         Same as above in the integer cost mode (see VRPTWDataProblem::setCostScale).
+      */
+      template <class D> void elapsedTimeBetweenTwoCostumers(const D&, scaledCostType&, unsigned&, const unsigned, const unsigned) const;
+
+      /**
+         Method that evaluates a route-plan with the given distances (see VRPDistances.h).
+      */
+      template <class D> T evaluateRoutes(const D&, const routesType&) const;
 
 
    public:
@@ -63,12 +73,13 @@ timeWindownViolationProblem::timeWindownViolationProblem()
 timeWindownViolationProblem::~timeWindownViolationProblem()
 { }
 
-inline void timeWindownViolationProblem::elapsedTimeBetweenTwoCostumers(T& totalElapsedTime, unsigned& numberOfViolations, const unsigned i, const unsigned j) const
+template <class D>
+inline void timeWindownViolationProblem::elapsedTimeBetweenTwoCostumers(const D& distances, T& totalElapsedTime, unsigned& numberOfViolations, const unsigned i, const unsigned j) const
 {
    VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
 
    // Time it takes to go from <costumer i> to <costumer i+1>
-   totalElapsedTime += VRPTWData->getDistanceMatrix()[i][j];
+   totalElapsedTime += distances.travelTime(i, j);
    //cout << "TW:(" << i << "," << j << ") [" << VRPTWData->getTimeWindow()[j].first << "," << VRPTWData->getTimeWindow()[j].second << "]";
 
    // Time we have to wait if we arrive before the <costumer i> opens
@@ -87,41 +98,53 @@ inline void timeWindownViolationProblem::elapsedTimeBetweenTwoCostumers(T& total
    //cout << "from: " <<  i << " to: " << j << " it takes: " << totalElapsedTime << endl;
 }
 
+template <class D>
+inline void timeWindownViolationProblem::elapsedTimeBetweenTwoCostumers(const D& distances, scaledCostType& totalElapsedTime, unsigned& numberOfViolations, const unsigned i, const unsigned j) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+
+   totalElapsedTime += distances.scaledTravelTime(i, j);
+   if (VRPTWData->getScaledReadyTime(j) > totalElapsedTime)
+      totalElapsedTime = VRPTWData->getScaledReadyTime(j);
+   else if (VRPTWData->getScaledDueTime(j) < totalElapsedTime)
+      numberOfViolations++;
+   totalElapsedTime += VRPTWData->getScaledServiceTime(j);
+}
 
 inline T timeWindownViolationProblem::evaluate(multiObjectiveSolution* currentSolution) const
 {
-   // std::cout << "tineWindowsViolationProblem" << std::endl;
-
    assert(currentSolution != NULL);
 
    VRPSolution* VRPSol = static_cast<VRPSolution*>(currentSolution);
-   T totalElapsedTime = 0;
-   T routeElapsedTime = 0;
-   unsigned numberOfViolations = 0;
-
-   routesType routes = const_cast<const routesType&>(VRPSol->getRoutes());
-   // std::cout << "   Current Route: " << routes << std::endl;   
-
-   for (size_t i = 0; i < routes.size() - 1; i++)
-   {
-      if (routes[i] == 0)
-      {
-         totalElapsedTime += routeElapsedTime;
-         routeElapsedTime = 0;
-      }
-      elapsedTimeBetweenTwoCostumers(routeElapsedTime, numberOfViolations, routes[i], routes[i + 1]);
-   }
-   totalElapsedTime += routeElapsedTime;
-
-   // std::cout << "   timeWindownViolationProblem: " << numberOfViolations << std::endl;
-   // std::cout << "<--- tinemWindowViolationProblem" << std::endl;
-   return (T)numberOfViolations;
+   return evaluate(VRPSol->getRoutes());
 }
 
 inline T timeWindownViolationProblem::evaluate(const routesType& routes) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return evaluateRoutes(VRPTWData->getOnDemandDistances(), routes);
+   return evaluateRoutes(VRPTWData->getDenseDistances(), routes);
+}
+
+template <class D>
+inline T timeWindownViolationProblem::evaluateRoutes(const D& distances, const routesType& routes) const
 {
    // std::cout << "tineWindowsViolationProblem" << std::endl;
 
+   if (VRPTWDataProblem::instance()->getCostScale() > 0)
+   {
+      scaledCostType routeElapsedTime = 0;
+      unsigned numberOfViolations = 0;
+      for (size_t i = 0; i < routes.size() - 1; i++)
+      {
+         if (routes[i] == 0)
+            routeElapsedTime = 0;
+         elapsedTimeBetweenTwoCostumers(distances, routeElapsedTime, numberOfViolations, routes[i], routes[i + 1]);
+      }
+      return (T)numberOfViolations;
+   }
+
    T totalElapsedTime = 0;
    T routeElapsedTime = 0;
    unsigned numberOfViolations = 0;
@@ -134,7 +157,7 @@ inline T timeWindownViolationProblem::evaluate(const routesType& routes) const
          totalElapsedTime += routeElapsedTime;
          routeElapsedTime = 0;
       }
-      elapsedTimeBetweenTwoCostumers(routeElapsedTime, numberOfViolations, routes[i], routes[i + 1]);
+      elapsedTimeBetweenTwoCostumers(distances, routeElapsedTime, numberOfViolations, routes[i], routes[i + 1]);
    }
    totalElapsedTime += routeElapsedTime;
 
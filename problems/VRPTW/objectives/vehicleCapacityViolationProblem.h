@@ -63,41 +63,10 @@ vehicleCapacityViolationProblem::~vehicleCapacityViolationProblem()
 
 inline T vehicleCapacityViolationProblem::evaluate(multiObjectiveSolution* currentSolution) const
 {
-   // std::cout << "vechileCapacitynViolationsProblem" << std::endl;
-
    assert(currentSolution != NULL);
 
    VRPSolution* VRPSol = static_cast<VRPSolution*>(currentSolution);
-   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
-
-   routesType routes = const_cast<const routesType&>(VRPSol->getRoutes());
-   //std::cout << "   Current Route: " << routes << std::endl;   
-
-   T currentCapacity = 0;
-   T excededCapacity = 0;
-   unsigned numberOfViolations = 0;
-
-   for (size_t i = 1; i < routes.size(); i++)
-   {
-      if (routes[i] == 0)
-      { 
-         if (currentCapacity > VRPTWData->getFleet()[0].second)
-         {
-               excededCapacity += currentCapacity - VRPTWData->getFleet()[0].second;
-               numberOfViolations++;
-               // cout << "[+] numberOfViolation: " << numberOfViolations << endl;
-         }
-         currentCapacity = 0;
-      }
-      else 
-      {
-         // cout << "Costumer[" << routes[i] << "]: " << VRPTWData->getDemand()[routes[i]] << endl;
-         currentCapacity += VRPTWData->getDemand()[routes[i]];
-         // cout << "[->currentCapacity = " <<  currentCapacity << endl;
-      }
-   }
-
-   return excededCapacity;
+   return evaluate(VRPSol->getRoutes());
 }
 
 inline T vehicleCapacityViolationProblem::evaluate(const routesType& routes) const
@@ -63,41 +63,10 @@ vehicleCapacitynViolationsProblem::~vehicleCapacitynViolationsProblem()
 
 inline T vehicleCapacitynViolationsProblem::evaluate(multiObjectiveSolution* currentSolution) const
 {
-   // std::cout << "vechileCapacitynViolationsProblem" << std::endl;
-
    assert(currentSolution != NULL);
 
    VRPSolution* VRPSol = static_cast<VRPSolution*>(currentSolution);
-   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
-
-   routesType routes = const_cast<const routesType&>(VRPSol->getRoutes());
-   //std::cout << "   Current Route: " << routes << std::endl;   
-
-   T currentCapacity = 0;
-   unsigned numberOfViolations = 0;
-
-   for (size_t i = 1; i < routes.size(); i++)
-   {
-      if (routes[i] == 0)
-      { 
-         if (currentCapacity > VRPTWData->getFleet()[0].second)
-         {
-               numberOfViolations++;
-               // cout << "[+] numberOfViolation: " << numberOfViolations << endl;
-         }
-         currentCapacity = 0;
-      }
-      else 
-      {
-         // cout << "Costumer[" << routes[i] << "]: " << VRPTWData->getDemand()[routes[i]] << endl;
-         currentCapacity += VRPTWData->getDemand()[routes[i]];
-         // cout << "[->currentCapacity = " <<  currentCapacity << endl;
-      }
-   }
-
-   // std::cout << "   vechileCapacitynViolationsProblem time: " << numberOfViolations << std::endl;
-   // std::cout << "<--- vechileCapacitynViolationsProblem" << std::endl;
-   return (T)numberOfViolations;
+   return evaluate(VRPSol->getRoutes());
 }
 
 
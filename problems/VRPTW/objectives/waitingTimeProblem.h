@@ -26,13 +26,24 @@ class waitingTimeProblem : public singleObjectiveProblem
          Method that given two costumers computes the time
          to serve them. It computes the time it takes to 
          move from one to another and the service time.
+         @param const D& provides the travel times (see VRPDistances.h).
          @param T& is the elapsed time so far is going to
          be incremented.
          @param T& is the elapsed time violation so far.
          @param const unsgined is the id of the first costumer.
          @param const unsigned is the id of the second costumer. 
       */
-      void elapsedTimeBetweenTwoCostumers(T&, T&, const unsigned, const unsigned) const;
+      template <class D> void elapsedTimeBetweenTwoCostumers(const D&, T&, T&, const unsigned, const unsigned) const;
+
+      /**
+         Same as above in the integer cost mode (see VRPTWDataProblem::setCostScale).
+      */
+      template <class D> void elapsedTimeBetweenTwoCostumers(const D&, scaledCostType&, scaledCostType&, const unsigned, const unsigned) const;
+
+      /**
+         Method that evaluates a route-plan with the given distances (see VRPDistances.h).
+      */
+      template <class D> T evaluateRoutes(const D&, const routesType&) const;
 
    public:
       /**
@@ -89,12 +100,13 @@ waitingTimeProblem::waitingTimeProblem()
 waitingTimeProblem::~waitingTimeProblem()
 { }
 
-inline void waitingTimeProblem::elapsedTimeBetweenTwoCostumers(T& totalElapsedTime, T& waitingTime, const unsigned i, const unsigned j) const
+template <class D>
+inline void waitingTimeProblem::elapsedTimeBetweenTwoCostumers(const D& distances, T& totalElapsedTime, T& waitingTime, const unsigned i, const unsigned j) const
 {
    VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
 
    // Time it takes to go from <costumer i> to <costumer i+1>
-   totalElapsedTime += VRPTWData->getDistanceMatrix()[i][j];
+   totalElapsedTime += distances.travelTime(i, j);
 
    // Time we have to wait if we arrive before the <costumer i> opens
    //    First, we calculate whether we're going to wait or not.
@@ -108,37 +120,53 @@ inline void waitingTimeProblem::elapsedTimeBetweenTwoCostumers(T& totalElapsedTi
 
 }
 
+template <class D>
+inline void waitingTimeProblem::elapsedTimeBetweenTwoCostumers(const D& distances, scaledCostType& totalElapsedTime, scaledCostType& waitingTime, const unsigned i, const unsigned j) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+
+   totalElapsedTime += distances.scaledTravelTime(i, j);
+   if (VRPTWData->getScaledReadyTime(j) > totalElapsedTime)
+   {
+      waitingTime += VRPTWData->getScaledReadyTime(j) - totalElapsedTime;
+      totalElapsedTime = VRPTWData->getScaledReadyTime(j);
+   }
+   totalElapsedTime += VRPTWData->getScaledServiceTime(j);
+}
 
 inline T waitingTimeProblem::evaluate(multiObjectiveSolution* currentSolution) const
 {
-   // std::cout << "tineWindowsViolationProblem" << std::endl;
-
    assert(currentSolution != NULL);
 
    VRPSolution* VRPSol = static_cast<VRPSolution*>(currentSolution);
-   T totalElapsedTime = 0;
-   T routeElapsedTime = 0;
-   T waitingTime = 0;
-
-   routesType routes = const_cast<const routesType&>(VRPSol->getRoutes());
-  
+   return evaluate(VRPSol->getRoutes());
+}
+
+inline T waitingTimeProblem::evaluate(const routesType& routes) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->isOnDemand())
+      return evaluateRoutes(VRPTWData->getOnDemandDistances(), routes);
+   return evaluateRoutes(VRPTWData->getDenseDistances(), routes);
+}
 
-   for (size_t i = 0; i < routes.size() - 1; i++)
+template <class D>
+inline T waitingTimeProblem::evaluateRoutes(const D& distances, const routesType& routes) const
+{
+   VRPTWDataProblem* VRPTWData = VRPTWDataProblem::instance();
+   if (VRPTWData->getCostScale() > 0)
    {
-      if (routes[i] == 0)
+      scaledCostType routeElapsedTime = 0;
+      scaledCostType waitingTime = 0;
+      for (size_t i = 0; i < routes.size() - 1; i++)
       {
-         totalElapsedTime += routeElapsedTime;
-         routeElapsedTime = 0;
+         if (routes[i] == 0)
+            routeElapsedTime = 0;
+         elapsedTimeBetweenTwoCostumers(distances, routeElapsedTime, waitingTime, routes[i], routes[i + 1]);
       }
-      elapsedTimeBetweenTwoCostumers(routeElapsedTime, waitingTime, routes[i], routes[i + 1]);
+      return (T)VRPTWData->unscale(waitingTime);
    }
-   totalElapsedTime += routeElapsedTime;
 
-   return waitingTime;
-}
-
-inline T waitingTimeProblem::evaluate(const routesType& routes) const
-{
    T totalElapsedTime = 0;
    T routeElapsedTime = 0;
    T waitingTime = 0;
@@ -150,7 +178,7 @@ inline T waitingTimeProblem::evaluate(const routesType& routes) const
          totalElapsedTime += routeElapsedTime;
          routeElapsedTime = 0;
       }
-      elapsedTimeBetweenTwoCostumers(routeElapsedTime, waitingTime, routes[i], routes[i + 1]);
+      elapsedTimeBetweenTwoCostumers(distances, routeElapsedTime, waitingTime, routes[i], routes[i + 1]);
    }
    totalElapsedTime += routeElapsedTime;
 
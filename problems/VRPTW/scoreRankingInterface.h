@@ -16,8 +16,8 @@ namespace scoreRankingInterface
    /**
       Function that ranks two solutions. 
    */
-   triBool firstSolutionIsBetter(const objectivesType& v1, 
-                                 const objectivesType& v2, 
+   triBool firstSolutionIsBetter(const objectivesViewType v1, 
+                                 const objectivesViewType v2, 
                                  const basicParetoFrontMOScoreCriterion& scoreCriterion,
                                  const std::string& options = " ")
    {
@@ -0,0 +1,32 @@
+# Plots of the scaling benchmark (see scaling.sh): evaluations per second
+#   and time to quality against the number of costumers
+
+set terminal png size 1200,450
+set output "./scaling/scaling.png"
+set xtics font "Arial,10"
+set ytics font "Arial,10"
+set font "Arial,10"
+set grid
+set autoscale
+set logscale x
+set key off
+
+# Data
+# -----------------
+# 1: Costumers
+# 4: Evaluations per second
+# 5: Evaluations requested per second
+# 6: Seconds until the best route-plan is within QUALITY% of the final one
+
+filename="./scaling/scaling.dat"
+
+set multiplot layout 1,2
+set xlabel "Costumers"
+set ylabel "Evaluations per second"
+set logscale y
+plot filename using 1:4 with linespoints pointtype 7 lt rgb "black"
+
+set ylabel "Seconds to quality"
+unset logscale y
+plot filename using 1:6 with linespoints pointtype 7 lt rgb "black"
+unset multiplot
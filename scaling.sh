@@ -0,0 +1,66 @@
+# Scaling benchmark: solves synthetic instances of growing size (see
+#   instanceGenerator.cpp) with the same budget and measures how fast the
+#   solver goes through them.
+#
+# Usage: ./scaling.sh "sizes" type agents budget seed [options]
+# Example: ./scaling.sh "100 200 500 1000 2000 5000" rc 10 60 7 lns=10
+#
+# The instances and the outputs go into the scaling directory. Every size
+#   adds a line to scaling/scaling.dat with:
+#
+# 1: Costumers
+# 2: Seconds of search (from the improvements of the best route-plan)
+# 3: Evaluations of route-plans (misses of the evaluation cache)
+# 4: Evaluations per second
+# 5: Evaluations requested per second (hits and misses of the cache)
+# 6: Seconds until the best route-plan is within QUALITY% (default 5) of the
+#    final distance, with at most the final number of vehicles
+# 7: Vehicles of the final best route-plan
+# 8: Distance of the final best route-plan
+# 9: Wall seconds of the whole run (reading, precomputations and construction included)
+#
+# The plots of scaling.gnuplot are written into scaling/scaling.png.
+
+if [ $# -lt 5 ]; then
+   echo "Usage: $0 \"sizes\" type agents budget seed [options]"
+   exit 1
+fi
+
+SIZES=$1
+TYPE=$2
+AGENTS=$3
+BUDGET=$4
+SEED=$5
+shift 5
+QUALITY=${QUALITY:-5}
+
+# The solver is built with optimisations, as in compila.sh
+make fast generator > /dev/null 2>&1 || { echo "ERROR[!] Cannot build the solver and the generator"; exit 1; }
+mkdir -p scaling
+echo "# costumers seconds evaluations evaluations/s requests/s time-to-quality vehicles distance wall" > scaling/scaling.dat
+
+for n in $SIZES; do
+   NAME=scaling/$TYPE$n.$SEED
+   ./instanceGenerator $NAME.txt $n $SEED type=$TYPE || exit 1
+
+   START=$(date +%s.%N)
+   ./CODEA2 $NAME.txt $((n / 4 > 0 ? n / 4 : 1)) $AGENTS 0 0 $SEED budget=$BUDGET improvements=$NAME.imp "$@" > $NAME.out 2> $NAME.err
+   END=$(date +%s.%N)
+
+   awk -v n=$n -v wall=$END -v start=$START -v quality=$QUALITY '
+      FILENAME ~ /\.err$/ && /^Evaluation cache:/ { hits = $3; misses = $5 }
+      FILENAME ~ /\.imp$/ && $1 == "best" { time[++lines] = $2; vehicles[lines] = $4; distance[lines] = $7 }
+      FILENAME ~ /\.imp$/ && $1 == "done" { seconds = $2; finalVehicles = $4; finalDistance = $7 }
+      END {
+         toQuality = seconds
+         for (i = 1; i <= lines; i++)
+            if (vehicles[i] <= finalVehicles && distance[i] <= finalDistance * (1 + quality / 100)) { toQuality = time[i]; break }
+         if (seconds <= 0) seconds = 1e-9
+         print n, seconds, misses, misses / seconds, (hits + misses) / seconds, toQuality, finalVehicles, finalDistance, wall - start
+      }' $NAME.err $NAME.imp >> scaling/scaling.dat
+   tail -1 scaling/scaling.dat
+done
+
+if which gnuplot > /dev/null; then
+   gnuplot scaling.gnuplot
+fi